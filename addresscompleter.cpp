@@ -0,0 +1,133 @@
+#include "addresscompleter.h"
+
+#include <QAbstractItemView>
+#include <QCompleter>
+#include <QLineEdit>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QStringListModel>
+#include <QTimer>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+AddressCompleter::AddressCompleter(QLineEdit *input, GeocodeCache &cache, QObject *parent) : QObject(parent),
+    input(input),
+    cache(cache),
+    completer(new QCompleter(this)),
+    model(new QStringListModel(this)),
+    debounce(new QTimer(this)),
+    network(new QNetworkAccessManager(this)) {
+
+    completer->setModel(model);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    input->setCompleter(completer);
+
+    debounce->setSingleShot(true);
+    debounce->setInterval(300);
+
+    connect(input, &QLineEdit::textEdited, this, &AddressCompleter::textEdited);
+    connect(debounce, &QTimer::timeout, this, &AddressCompleter::fetchSuggestions);
+    connect(network, &QNetworkAccessManager::finished, this, &AddressCompleter::handleReply);
+    rebuild();
+}
+
+QString AddressCompleter::labelFor(const GeocodeEntry &entry) {
+    QStringList parts;
+    for (const QString &part : {entry.name, entry.region, entry.country})
+        if (!part.isEmpty() && !parts.contains(part)) parts.append(part);
+    return parts.join(", ");
+}
+
+void AddressCompleter::addLocation(const QString &label, int weight) {
+    extraLocations[label] += weight;
+    trie.insert(normalizeAddress(label), label, weight);
+}
+
+void AddressCompleter::rebuild() {
+    trie.clear();
+    labels.clear();
+    labelKeys.clear();
+    for (auto it = cache.entries().cbegin(); it != cache.entries().cend(); ++it) insertEntry(it.key(), it.value());
+    for (auto it = extraLocations.cbegin(); it != extraLocations.cend(); ++it)
+        trie.insert(normalizeAddress(it.key()), it.key(), it.value());
+}
+
+const GeocodeEntry *AddressCompleter::find(const QString &address) const {
+    const QString key = normalizeAddress(address);
+    if (const GeocodeEntry *entry = cache.find(key)) return entry;
+    auto labelled = labelKeys.constFind(key);
+    return labelled == labelKeys.constEnd() ? nullptr : cache.find(*labelled);
+}
+
+// Etykieta wpisu liczona jest w drzewie raz, choć jest osiągalna pod kluczem zapytania, etykietą i nazwą
+// (kilka kluczy pamięci podręcznej może wskazywać to samo miejsce)
+void AddressCompleter::insertEntry(const QString &key, const GeocodeEntry &entry) {
+    const QString label = labelFor(entry);
+    const QString labelKey = normalizeAddress(label);
+    const int weight = labels.contains(label) ? 0 : 1;
+    labels.insert(label);
+    if (!labelKeys.contains(labelKey)) labelKeys.insert(labelKey, key);
+
+    trie.insert(labelKey, label, weight);
+    trie.insert(key, label, 0);
+    trie.insert(normalizeAddress(entry.name), label, 0);
+}
+
+void AddressCompleter::textEdited(const QString &text) {
+    debounce->stop();
+    if (pending) {
+        QNetworkReply *stale = pending;
+        pending = nullptr;
+        stale->abort();
+    }
+
+    const QString key = normalizeAddress(text);
+    if (key.size() < 2) {
+        showSuggestions({});
+        return;
+    }
+
+    const QStringList suggestions = trie.suggestions(key);
+    showSuggestions(suggestions);
+    if (suggestions.isEmpty() && key.size() >= 3)
+        debounce->start();
+}
+
+void AddressCompleter::fetchSuggestions() {
+    pending = network->get(QNetworkRequest(geocodeRequestUrl(input->text(), AddressTrie::MaxSuggestions)));
+}
+
+void AddressCompleter::handleReply(QNetworkReply *reply) {
+    reply->deleteLater();
+    if (reply != pending) return;
+    pending = nullptr;
+    if (reply->error() != QNetworkReply::NoError) return;
+
+    try {
+        json response = json::parse(reply->readAll().toStdString());
+        if (!response.contains("results")) return;
+
+        for (const json &result : response["results"]) {
+            const GeocodeEntry entry = entryFromResult(result);
+            const QString key = normalizeAddress(labelFor(entry));
+            cache.insert(key, entry);
+            insertEntry(key, entry);
+        }
+    } catch (const std::exception &) {
+        return;
+    }
+
+    showSuggestions(trie.suggestions(normalizeAddress(input->text())));
+}
+
+void AddressCompleter::showSuggestions(const QStringList &suggestions) {
+    model->setStringList(suggestions);
+    if (suggestions.isEmpty())
+        completer->popup()->hide();
+    else
+        completer->complete();
+}
@@ -0,0 +1,65 @@
+#ifndef ADDRESSCOMPLETER_H
+#define ADDRESSCOMPLETER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+
+#include "addresstrie.h"
+#include "geocoder.h"
+
+class QCompleter;
+class QLineEdit;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QStringListModel;
+class QTimer;
+
+/*!
+ * \brief Podpowiedzi adresów w trakcie pisania
+ * \details Podpowiedzi pochodzą najpierw z drzewa prefiksowego zbudowanego z pamięci podręcznej
+ * geokodowania, lokalnego magazynu i historii wyszukiwań - są wyświetlane natychmiast po każdym
+ * naciśnięciu klawisza. Zapytanie do API wysyłane jest dopiero po przerwie w pisaniu i tylko
+ * wtedy, gdy lokalnie nic nie znaleziono; każda kolejna zmiana tekstu przerywa poprzednie zapytanie.
+ */
+class AddressCompleter : public QObject {
+    Q_OBJECT
+
+public:
+    AddressCompleter(QLineEdit *input, GeocodeCache &cache, QObject *parent = nullptr);
+
+    // Etykieta wpisu pamięci podręcznej: "nazwa, region, kraj"
+    static QString labelFor(const GeocodeEntry &entry);
+
+    // Dodaje lokalizację spoza pamięci podręcznej (magazyn, historia wyszukiwań)
+    void addLocation(const QString &label, int weight = 1);
+    // Odbudowa drzewa z pamięci podręcznej i dodanych lokalizacji; pamięć podręczna nie jest zmieniana
+    void rebuild();
+
+    // Wpis pamięci podręcznej adresu lub etykiety podpowiedzi (wybór podpowiedzi nie wymaga geokodowania)
+    const GeocodeEntry *find(const QString &address) const;
+
+private slots:
+    void textEdited(const QString &text);
+    void fetchSuggestions();
+    void handleReply(QNetworkReply *reply);
+
+private:
+    void showSuggestions(const QStringList &suggestions);
+    void insertEntry(const QString &key, const GeocodeEntry &entry);
+
+    QLineEdit *input;
+    GeocodeCache &cache;
+    AddressTrie trie;
+    QHash<QString, int> extraLocations;
+    QSet<QString> labels;
+    QHash<QString, QString> labelKeys;      // znormalizowana etykieta -> klucz pamięci podręcznej
+    QCompleter *completer;
+    QStringListModel *model;
+    QTimer *debounce;
+    QNetworkAccessManager *network;
+    QNetworkReply *pending = nullptr;
+};
+
+#endif // ADDRESSCOMPLETER_H
@@ -0,0 +1,72 @@
+#include "addresstrie.h"
+
+#include <algorithm>
+
+int AddressTrie::child(int node, char16_t c) const {
+    const auto &children = nodes[node].children;
+    auto it = std::lower_bound(children.begin(), children.end(), std::make_pair(c, 0));
+    return it != children.end() && it->first == c ? it->second : -1;
+}
+
+void AddressTrie::updateTop(Node &node, int entry) {
+    auto byWeight = [this](int a, int b) { return entries[a].weight > entries[b].weight; };
+    auto it = std::find(node.top.begin(), node.top.end(), entry);
+    if (it == node.top.end()) {
+        if (static_cast<int>(node.top.size()) < MaxSuggestions)
+            node.top.push_back(entry);
+        else if (entries[entry].weight > entries[node.top.back()].weight)
+            node.top.back() = entry;
+        else
+            return;
+    }
+    std::stable_sort(node.top.begin(), node.top.end(), byWeight);
+}
+
+void AddressTrie::insert(const QString &key, const QString &label, int weight) {
+    if (key.isEmpty() || label.isEmpty()) return;
+
+    int entry = entryIndex.value(label, -1);
+    if (entry < 0) {
+        entry = static_cast<int>(entries.size());
+        entryIndex.insert(label, entry);
+        entries.push_back({label, 0});
+    }
+    entries[entry].weight += weight;
+
+    int node = 0;
+    updateTop(nodes[node], entry);
+    for (QChar qc : key) {
+        const char16_t c = qc.unicode();
+        int next = child(node, c);
+        if (next < 0) {
+            next = static_cast<int>(nodes.size());
+            nodes.emplace_back();
+            auto &children = nodes[node].children;
+            children.insert(std::lower_bound(children.begin(), children.end(), std::make_pair(c, 0)),
+                            std::make_pair(c, next));
+        }
+        node = next;
+        updateTop(nodes[node], entry);
+    }
+}
+
+QStringList AddressTrie::suggestions(const QString &prefix, int limit) const {
+    int node = 0;
+    for (QChar qc : prefix) {
+        node = child(node, qc.unicode());
+        if (node < 0) return {};
+    }
+
+    QStringList result;
+    for (int entry : nodes[node].top) {
+        if (result.size() >= limit) break;
+        result.append(entries[entry].label);
+    }
+    return result;
+}
+
+void AddressTrie::clear() {
+    nodes.assign(1, Node());
+    entries.clear();
+    entryIndex.clear();
+}
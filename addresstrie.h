@@ -0,0 +1,45 @@
+#ifndef ADDRESSTRIE_H
+#define ADDRESSTRIE_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+/*!
+ * \brief Drzewo prefiksowe podpowiedzi adresów
+ * \details Każdy węzeł przechowuje listę najczęściej używanych wpisów w swoim poddrzewie,
+ * więc wyszukanie podpowiedzi kosztuje tylko przejście po znakach prefiksu, niezależnie
+ * od liczby zapisanych lokalizacji. Klucze powinny być znormalizowane (normalizeAddress).
+ */
+class AddressTrie {
+public:
+    static const int MaxSuggestions = 8;
+
+    // Dodaje wpis pod kluczem; ponowne dodanie tej samej etykiety zwiększa jej wagę
+    void insert(const QString &key, const QString &label, int weight = 1);
+    QStringList suggestions(const QString &prefix, int limit = MaxSuggestions) const;
+    void clear();
+    int size() const { return static_cast<int>(entries.size()); }
+
+private:
+    struct Node {
+        std::vector<std::pair<char16_t, int>> children;
+        std::vector<int> top;
+    };
+
+    struct Entry {
+        QString label;
+        int weight = 0;
+    };
+
+    int child(int node, char16_t c) const;
+    void updateTop(Node &node, int entry);
+
+    std::vector<Node> nodes = std::vector<Node>(1);
+    std::vector<Entry> entries;
+    QHash<QString, int> entryIndex;
+};
+
+#endif // ADDRESSTRIE_H
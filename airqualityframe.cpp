@@ -0,0 +1,550 @@
+#include "airqualityframe.h"
+#include "pollutants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+namespace {
+
+// Liczba dni od 1970-01-01 dla daty kalendarzowej (algorytm H. Hinnanta)
+std::int64_t daysFromCivil(std::int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+// Data kalendarzowa dla liczby dni od 1970-01-01 (odwrotność daysFromCivil)
+void civilFromDays(std::int64_t z, int &year, unsigned &month, unsigned &day) {
+    z += 719468;
+    const std::int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2));
+}
+
+bool readDigits(std::string_view text, size_t pos, size_t count, int &out) {
+    if (pos + count > text.size()) return false;
+    int value = 0;
+    for (size_t i = pos; i < pos + count; ++i) {
+        const char c = text[i];
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    out = value;
+    return true;
+}
+
+// Przestawia wiersze serii zgodnie z podaną permutacją indeksów
+void applyPermutation(AirQualityFrame &frame, const std::vector<size_t> &order) {
+    std::vector<std::int64_t> time(order.size());
+    for (size_t i = 0; i < order.size(); ++i) time[i] = frame.time[order[i]];
+    frame.time.swap(time);
+
+    for (auto &[name, column] : frame.columns) {
+        std::vector<double> values(order.size());
+        for (size_t i = 0; i < order.size(); ++i) values[i] = column[order[i]];
+        column.swap(values);
+    }
+}
+
+// Dekoder SAX odpowiedzi Open-Meteo (pojedynczy obiekt lub tablica obiektów) oraz zapisów aplikacji
+// (obiekt z polami location, station i air_quality_data). Serie trafiają wprost do kolumn w trakcie
+// parsowania, bez budowania drzewa dokumentu.
+class FrameDecoder : public nlohmann::json_sax<nlohmann::json> {
+public:
+    std::vector<AirQualityFrame> frames;
+    std::string error;
+
+    bool null() override { return value(std::numeric_limits<double>::quiet_NaN()); }
+    bool boolean(bool) override { return true; }
+    bool number_integer(number_integer_t number) override { return value(static_cast<double>(number)); }
+    bool number_unsigned(number_unsigned_t number) override { return value(static_cast<double>(number)); }
+    bool number_float(number_float_t number, const string_t &) override { return value(number); }
+    bool binary(binary_t &) override { return true; }
+
+    bool string(string_t &text) override {
+        if (scopes.empty()) return true;
+        if (scopes.back() == Scope::Location && currentKey == "location") frames.back().location = text;
+        else if (scopes.back() == Scope::Location && currentKey == "station") frames.back().station = text;
+        else if (scopes.back() == Scope::Location && currentKey == "timezone" && text != "GMT") frames.back().timezone = text;
+        else if (scopes.back() == Scope::TimeColumn) {
+            auto timestamp = parseIsoTimestamp(text);
+            if (!timestamp) {
+                error = "Nieprawidłowy znacznik czasu: " + text;
+                return false;
+            }
+            block.time.push_back(*timestamp);
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        const Scope parent = scopes.empty() ? Scope::Locations : scopes.back();
+        if (parent == Scope::Locations) {
+            frames.emplace_back();
+            utcOffset = 0;
+            unixTime = false;
+            scopes.push_back(Scope::Location);
+        } else if (parent == Scope::Location && currentKey == "air_quality_data") {
+            scopes.push_back(Scope::Location);
+        } else if (parent == Scope::Location && (currentKey == "hourly" || currentKey == "minutely_15")) {
+            block = AirQualityFrame();
+            scopes.push_back(Scope::Series);
+        } else {
+            scopes.push_back(Scope::Skip);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        const Scope closed = scopes.back();
+        scopes.pop_back();
+
+        // Seria godzinowa i 15-minutowa mają osobne osie czasu; blok scalany jest z serią lokalizacji
+        if (closed == Scope::Series) {
+            for (auto &[name, column] : block.columns)
+                column.resize(block.time.size(), std::numeric_limits<double>::quiet_NaN());
+            block.sortByTime();
+            frames.back().mergeFrom(block);
+            return true;
+        }
+        if (!scopes.empty() && scopes.back() != Scope::Locations) return true;
+
+        // Koniec obiektu lokalizacji: czas lokalny API zamieniany na UTC (znaczniki uniksowe są już w UTC)
+        if (unixTime) return true;
+        for (std::int64_t &timestamp : frames.back().time) timestamp -= utcOffset;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        if (scopes.empty()) {
+            scopes.push_back(Scope::Locations);
+        } else if (scopes.back() == Scope::Series && currentKey == "time") {
+            scopes.push_back(Scope::TimeColumn);
+        } else if (scopes.back() == Scope::Series) {
+            column = &block.columns[currentKey];
+            scopes.push_back(Scope::Column);
+        } else {
+            scopes.push_back(Scope::Skip);
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        scopes.pop_back();
+        return true;
+    }
+
+    bool key(string_t &name) override {
+        currentKey = name;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &e) override {
+        error = e.what();
+        return false;
+    }
+
+private:
+    enum class Scope { Locations, Location, Series, TimeColumn, Column, Skip };
+
+    bool value(double number) {
+        if (scopes.empty()) return true;
+        if (scopes.back() == Scope::Column) {
+            column->push_back(number);
+        } else if (scopes.back() == Scope::TimeColumn) {
+            block.time.push_back(static_cast<std::int64_t>(number));
+            unixTime = true;
+        } else if (scopes.back() == Scope::Location) {
+            if (currentKey == "latitude") frames.back().latitude = number;
+            else if (currentKey == "longitude") frames.back().longitude = number;
+            else if (currentKey == "utc_offset_seconds") utcOffset = static_cast<std::int64_t>(number);
+        }
+        return true;
+    }
+
+    std::vector<Scope> scopes;
+    std::string currentKey;
+    AirQualityFrame block;
+    std::vector<double> *column = nullptr;
+    std::int64_t utcOffset = 0;
+    bool unixTime = false;
+};
+
+} // namespace
+
+std::optional<std::int64_t> parseIsoTimestamp(std::string_view text) {
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (!readDigits(text, 0, 4, year) || text.size() < 10 || text[4] != '-' || text[7] != '-'
+        || !readDigits(text, 5, 2, month) || !readDigits(text, 8, 2, day))
+        return std::nullopt;
+    if (month < 1 || month > 12 || day < 1 || day > 31) return std::nullopt;
+
+    size_t pos = 10;
+    if (pos < text.size() && (text[pos] == 'T' || text[pos] == ' ')) {
+        if (!readDigits(text, pos + 1, 2, hour) || pos + 3 >= text.size() || text[pos + 3] != ':'
+            || !readDigits(text, pos + 4, 2, minute))
+            return std::nullopt;
+        pos += 6;
+        if (pos < text.size() && text[pos] == ':') {
+            if (!readDigits(text, pos + 1, 2, second)) return std::nullopt;
+            pos += 3;
+        }
+    }
+
+    std::int64_t offset = 0;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+        int offHour, offMinute = 0;
+        if (!readDigits(text, pos + 1, 2, offHour)) return std::nullopt;
+        size_t minutePos = pos + 3;
+        if (minutePos < text.size() && text[minutePos] == ':') ++minutePos;
+        readDigits(text, minutePos, 2, offMinute);
+        offset = (offHour * 3600 + offMinute * 60) * (text[pos] == '+' ? 1 : -1);
+    }
+
+    return daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offset;
+}
+
+int formatIsoTimestamp(std::int64_t seconds, char *out) {
+    std::int64_t days = seconds / 86400;
+    std::int64_t rest = seconds % 86400;
+    if (rest < 0) {
+        rest += 86400;
+        --days;
+    }
+    int year;
+    unsigned month, day;
+    civilFromDays(days, year, month, day);
+    const int written = std::snprintf(out, 21, "%04d-%02u-%02uT%02d:%02d:%02dZ", year, month, day,
+                                      static_cast<int>(rest / 3600), static_cast<int>(rest / 60 % 60),
+                                      static_cast<int>(rest % 60));
+    return written > 20 ? 20 : written;
+}
+
+void AirQualityFrame::sortByTime() {
+    bool strictlySorted = true;
+    for (size_t i = 1; i < time.size() && strictlySorted; ++i)
+        strictlySorted = time[i - 1] < time[i];
+    if (strictlySorted) return;
+
+    std::vector<size_t> order(time.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return time[a] < time[b]; });
+
+    // Przy powtórzonym znaczniku zostaje ostatni wiersz (stabilne sortowanie zachowuje kolejność wejścia)
+    size_t out = 0;
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (out > 0 && time[order[out - 1]] == time[order[i]])
+            order[out - 1] = order[i];
+        else
+            order[out++] = order[i];
+    }
+    order.resize(out);
+    applyPermutation(*this, order);
+}
+
+void AirQualityFrame::mergeFrom(const AirQualityFrame &other) {
+    if (station.empty()) station = other.station;
+    if (timezone.empty()) timezone = other.timezone;
+    if (std::isnan(latitude)) latitude = other.latitude;
+    if (std::isnan(longitude)) longitude = other.longitude;
+    if (other.time.empty()) return;
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const auto &[name, column] : other.columns)
+        if (!columns.count(name)) columns[name].assign(time.size(), nan);
+
+    // Szybka ścieżka: nowe dane leżą w całości za istniejącymi
+    if (time.empty() || time.back() < other.time.front()) {
+        time.insert(time.end(), other.time.begin(), other.time.end());
+        for (auto &[name, column] : columns) {
+            auto it = other.columns.find(name);
+            if (it != other.columns.end())
+                column.insert(column.end(), it->second.begin(), it->second.end());
+            else
+                column.resize(time.size(), nan);
+        }
+        return;
+    }
+
+    // Scalanie dwóch posortowanych osi czasu; -1 oznacza brak wiersza w danym źródle
+    std::vector<std::int64_t> mergedTime;
+    std::vector<std::pair<std::ptrdiff_t, std::ptrdiff_t>> rows;
+    mergedTime.reserve(time.size() + other.time.size());
+    rows.reserve(time.size() + other.time.size());
+    size_t i = 0, j = 0;
+    while (i < time.size() || j < other.time.size()) {
+        if (j == other.time.size() || (i < time.size() && time[i] < other.time[j])) {
+            mergedTime.push_back(time[i]);
+            rows.emplace_back(i++, -1);
+        } else if (i == time.size() || other.time[j] < time[i]) {
+            mergedTime.push_back(other.time[j]);
+            rows.emplace_back(-1, j++);
+        } else {
+            mergedTime.push_back(time[i]);
+            rows.emplace_back(i++, j++);
+        }
+    }
+
+    for (auto &[name, column] : columns) {
+        auto it = other.columns.find(name);
+        const std::vector<double> *incoming = it != other.columns.end() ? &it->second : nullptr;
+        std::vector<double> merged(rows.size(), nan);
+        for (size_t r = 0; r < rows.size(); ++r) {
+            const auto [mine, theirs] = rows[r];
+            if (incoming && theirs >= 0 && !std::isnan((*incoming)[theirs]))
+                merged[r] = (*incoming)[theirs];
+            else if (mine >= 0)
+                merged[r] = column[mine];
+        }
+        column.swap(merged);
+    }
+    time.swap(mergedTime);
+}
+
+std::optional<std::int64_t> AirQualityFrame::changedSince(std::uint64_t since) const {
+    if (revision == 0 || since == 0 || since < droppedRevision || since > revision) return ChangedAll;
+    std::optional<std::int64_t> earliest;
+    for (auto it = changes.rbegin(); it != changes.rend() && it->first > since; ++it)
+        earliest = earliest ? std::min(*earliest, it->second) : it->second;
+    return earliest;
+}
+
+void LocationStore::recordChange(AirQualityFrame &frame, std::int64_t from) {
+    frame.revision = ++lastRevision;
+    frame.changes.emplace_back(frame.revision, from);
+    if (frame.changes.size() > MaxLoggedChanges) {
+        frame.droppedRevision = frame.changes.front().first;
+        frame.changes.erase(frame.changes.begin());
+    }
+}
+
+void LocationStore::merge(AirQualityFrame &&frame) {
+    auto it = storage.find(frame.location);
+    if (it == storage.end()) {
+        frame.changes.clear();
+        frame.droppedRevision = 0;
+        AirQualityFrame &stored = storage.emplace(frame.location, std::move(frame)).first->second;
+        recordChange(stored, AirQualityFrame::ChangedAll);
+        return;
+    }
+
+    // Scalanie zmienia wiersze od pierwszego znacznika nowej serii; nowa kolumna wypełnia NaN także starsze wiersze
+    AirQualityFrame &stored = it->second;
+    bool newColumns = false;
+    for (const auto &item : frame.columns) newColumns = newColumns || !stored.columns.count(item.first);
+    if (frame.time.empty() && !newColumns) return;
+    const std::int64_t from = newColumns || frame.time.empty() ? AirQualityFrame::ChangedAll : frame.time.front();
+    stored.mergeFrom(frame);
+    recordChange(stored, from);
+}
+
+void LocationStore::markModified(const std::string &location, std::int64_t from) {
+    if (AirQualityFrame *frame = find(location)) recordChange(*frame, from);
+}
+
+const AirQualityFrame *LocationStore::find(const std::string &location) const {
+    auto it = storage.find(location);
+    return it != storage.end() ? &it->second : nullptr;
+}
+
+AirQualityFrame *LocationStore::find(const std::string &location) {
+    auto it = storage.find(location);
+    return it != storage.end() ? &it->second : nullptr;
+}
+
+AirQualityFrame mergeSortedFrames(const std::vector<const AirQualityFrame *> &parts) {
+    AirQualityFrame merged;
+    if (parts.empty()) return merged;
+
+    size_t total = 0;
+    for (const AirQualityFrame *part : parts) {
+        if (merged.location.empty()) merged.location = part->location;
+        if (merged.station.empty()) merged.station = part->station;
+        if (merged.timezone.empty()) merged.timezone = part->timezone;
+        if (!std::isnan(part->latitude)) merged.latitude = part->latitude;
+        if (!std::isnan(part->longitude)) merged.longitude = part->longitude;
+        for (const auto &item : part->columns) merged.columns[item.first];
+        total += part->size();
+    }
+    merged.time.reserve(total);
+
+    // Dla każdej kolumny wynikowej: wskaźnik na kolumnę w danej serii (nullptr, gdy jej brak)
+    std::vector<std::vector<double> *> outColumns;
+    std::vector<std::vector<const std::vector<double> *>> inColumns;
+    for (auto &[name, column] : merged.columns) {
+        column.reserve(total);
+        outColumns.push_back(&column);
+        std::vector<const std::vector<double> *> sources;
+        for (const AirQualityFrame *part : parts) {
+            auto it = part->columns.find(name);
+            sources.push_back(it != part->columns.end() ? &it->second : nullptr);
+        }
+        inColumns.push_back(std::move(sources));
+    }
+
+    // Kopiec (czas, indeks serii) z kolejnymi wierszami każdej serii
+    using Cursor = std::pair<std::int64_t, size_t>;
+    std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap;
+    std::vector<size_t> position(parts.size(), 0);
+    for (size_t p = 0; p < parts.size(); ++p)
+        if (!parts[p]->time.empty()) heap.emplace(parts[p]->time.front(), p);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<std::pair<size_t, size_t>> sameTime;
+    while (!heap.empty()) {
+        const std::int64_t timestamp = heap.top().first;
+        sameTime.clear();
+        while (!heap.empty() && heap.top().first == timestamp) {
+            const size_t p = heap.top().second;
+            heap.pop();
+            sameTime.emplace_back(p, position[p]++);
+            if (position[p] < parts[p]->time.size()) heap.emplace(parts[p]->time[position[p]], p);
+        }
+
+        // Wiersze z tym samym czasem są już uporządkowane rosnąco po indeksie serii
+        merged.time.push_back(timestamp);
+        for (size_t c = 0; c < outColumns.size(); ++c) {
+            double value = nan;
+            for (const auto &[p, row] : sameTime) {
+                const std::vector<double> *source = inColumns[c][p];
+                if (source && !std::isnan((*source)[row])) value = (*source)[row];
+            }
+            outColumns[c]->push_back(value);
+        }
+    }
+    return merged;
+}
+
+AirQualityFrame frameFromJson(const nlohmann::json &data) {
+    AirQualityFrame frame;
+    if (data.contains("latitude")) frame.latitude = data["latitude"].get<double>();
+    if (data.contains("longitude")) frame.longitude = data["longitude"].get<double>();
+    if (data.contains("timezone") && data["timezone"] != "GMT") frame.timezone = data["timezone"].get<std::string>();
+    if (!data.contains("hourly")) return frame;
+
+    // Przy parametrze timezone API zwraca czas lokalny; oś czasu serii jest zawsze w UTC
+    const std::int64_t utcOffset = data.value("utc_offset_seconds", std::int64_t(0));
+
+    const auto &hourly = data["hourly"];
+    const auto &timeData = hourly["time"];
+    frame.time.reserve(timeData.size());
+    for (const auto &item : timeData) {
+        // timeformat=unixtime: znaczniki w sekundach UTC
+        if (item.is_number()) {
+            frame.time.push_back(item.get<std::int64_t>());
+            continue;
+        }
+        const auto &text = item.get_ref<const std::string &>();
+        auto timestamp = parseIsoTimestamp(text);
+        if (!timestamp) throw std::runtime_error("Nieprawidłowy znacznik czasu: " + text);
+        frame.time.push_back(*timestamp - utcOffset);
+    }
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (auto it = hourly.begin(); it != hourly.end(); ++it) {
+        if (it.key() == "time" || !it.value().is_array()) continue;
+        std::vector<double> &column = frame.columns[it.key()];
+        column.reserve(it.value().size());
+        for (const auto &value : it.value())
+            column.push_back(value.is_number() ? value.get<double>() : nan);
+        column.resize(frame.time.size(), nan);
+    }
+    frame.sortByTime();
+    return frame;
+}
+
+std::vector<AirQualityFrame> framesFromJsonText(const char *data, size_t size) {
+    FrameDecoder decoder;
+    if (!nlohmann::json::sax_parse(data, data + size, &decoder))
+        throw std::runtime_error(decoder.error.empty() ? "Nieprawidłowy format JSON" : decoder.error);
+    return std::move(decoder.frames);
+}
+
+int europeanAqiLevel(const AirQualityFrame &frame, std::int64_t at) {
+    const std::int64_t maxAge = 3 * 3600;
+
+    const auto end = std::upper_bound(frame.time.begin(), frame.time.end(), at);
+    int level = -1;
+    for (const Pollutant &pollutant : pollutants) {
+        if (!pollutant.inAqi()) continue;
+        auto column = frame.columns.find(std::string(pollutant.apiName));
+        if (column == frame.columns.end()) continue;
+
+        for (auto it = end; it != frame.time.begin();) {
+            --it;
+            if (at - *it > maxAge) break;
+            const double value = column->second[it - frame.time.begin()];
+            if (std::isnan(value)) continue;
+            const auto &bounds = pollutant.aqiBounds;
+            level = std::max(level, static_cast<int>(std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin()));
+            break;
+        }
+    }
+    return level;
+}
+
+AirQualityFrame rollupFrame(const AirQualityFrame &frame, std::int64_t bucketSeconds) {
+    AirQualityFrame rolled;
+    rolled.location = frame.location;
+    rolled.station = frame.station;
+    rolled.timezone = frame.timezone;
+    rolled.latitude = frame.latitude;
+    rolled.longitude = frame.longitude;
+
+    // Oś jest posortowana, więc wiersze jednego przedziału leżą obok siebie: jeden przebieg na kolumnę
+    std::vector<size_t> bucketEnd;
+    for (size_t i = 0; i < frame.size(); ++i) {
+        const std::int64_t t = frame.time[i];
+        const std::int64_t bucket = (t >= 0 ? t : t - bucketSeconds + 1) / bucketSeconds * bucketSeconds;
+        if (rolled.time.empty() || rolled.time.back() != bucket) {
+            if (!rolled.time.empty()) bucketEnd.push_back(i);
+            rolled.time.push_back(bucket);
+        }
+    }
+    if (!rolled.time.empty()) bucketEnd.push_back(frame.size());
+
+    for (const auto &[name, values] : frame.columns) {
+        std::vector<double> &column = rolled.columns[name];
+        column.reserve(rolled.time.size());
+        size_t begin = 0;
+        for (size_t end : bucketEnd) {
+            double sum = 0.0;
+            size_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (std::isnan(values[i])) continue;
+                sum += values[i];
+                ++count;
+            }
+            column.push_back(count ? sum / count : std::numeric_limits<double>::quiet_NaN());
+            begin = end;
+        }
+    }
+    return rolled;
+}
+
+bool needsHourlyRollup(const AirQualityFrame &frame, size_t maxRows) {
+    if (frame.size() <= maxRows) return false;
+    const std::int64_t step = smallestStep(frame);
+    return step > 0 && step < 3600;
+}
+
+std::int64_t smallestStep(const AirQualityFrame &frame) {
+    std::int64_t step = 0;
+    for (size_t i = 1; i < frame.size(); ++i) {
+        const std::int64_t delta = frame.time[i] - frame.time[i - 1];
+        if (step == 0 || delta < step) step = delta;
+    }
+    return step;
+}
@@ -0,0 +1,115 @@
+#ifndef AIRQUALITYFRAME_H
+#define AIRQUALITYFRAME_H
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+/*!
+ * \brief Kolumnowa seria pomiarów dla jednej lokalizacji
+ * \details Oś czasu zawiera znaczniki w sekundach UTC, posortowane rosnąco i bez powtórzeń.
+ * Każda kolumna parametru (np. "pm10") ma tę samą długość co oś czasu, brak pomiaru
+ * oznaczany jest wartością NaN.
+ */
+struct AirQualityFrame {
+    std::string location;
+    std::string station;
+    std::string timezone;       // strefa IANA lokalizacji (np. "Europe/Warsaw"), pusta gdy nieznana
+    double latitude = std::numeric_limits<double>::quiet_NaN();
+    double longitude = std::numeric_limits<double>::quiet_NaN();
+    std::vector<std::int64_t> time;
+    std::map<std::string, std::vector<double>> columns;
+
+    // Rewizje nadawane przez LocationStore przy każdej zmianie danych (0 - seria spoza magazynu) i dziennik
+    // ostatnich zmian: para (rewizja, najwcześniejszy zmieniony znacznik czasu)
+    std::uint64_t revision = 0;
+    std::vector<std::pair<std::uint64_t, std::int64_t>> changes;
+    std::uint64_t droppedRevision = 0;     // najnowsza rewizja usunięta z dziennika
+
+    size_t size() const { return time.size(); }
+
+    // Najwcześniejszy znacznik czasu zmieniony po rewizji since: nullopt - bez zmian, ChangedAll - cała seria
+    // (także dla serii spoza magazynu i rewizji starszych niż dziennik). Wiersze przed tym znacznikiem
+    // mają te same wartości i indeksy co w rewizji since.
+    std::optional<std::int64_t> changedSince(std::uint64_t since) const;
+    static constexpr std::int64_t ChangedAll = std::numeric_limits<std::int64_t>::min();
+
+    // Sortuje wiersze według czasu; przy powtórzonym znaczniku wygrywa późniejszy wiersz
+    void sortByTime();
+
+    // Scala posortowaną serię z inną posortowaną serią (dane z other mają pierwszeństwo)
+    void mergeFrom(const AirQualityFrame &other);
+};
+
+/*!
+ * \brief Lokalny magazyn serii pomiarowych, indeksowany nazwą lokalizacji
+ */
+class LocationStore {
+public:
+    // Dołącza serię do magazynu, scalając ją z już zapisanymi danymi tej lokalizacji
+    void merge(AirQualityFrame &&frame);
+
+    const AirQualityFrame *find(const std::string &location) const;
+    AirQualityFrame *find(const std::string &location);
+
+    // Zapis zmiany danych serii wprowadzonej poza merge() (np. nowej kolumny) od znacznika from
+    void markModified(const std::string &location, std::int64_t from = AirQualityFrame::ChangedAll);
+    const std::map<std::string, AirQualityFrame> &frames() const { return storage; }
+    bool empty() const { return storage.empty(); }
+    void clear() { storage.clear(); }
+
+private:
+    void recordChange(AirQualityFrame &frame, std::int64_t from);
+
+    static const size_t MaxLoggedChanges = 64;
+    std::map<std::string, AirQualityFrame> storage;
+    std::uint64_t lastRevision = 0;
+};
+
+// Szybkie parsowanie znacznika ISO 8601 ("2025-04-22T13:00", opcjonalnie sekundy i strefa) do sekund UTC
+std::optional<std::int64_t> parseIsoTimestamp(std::string_view text);
+
+// Zapis znacznika czasu jako "YYYY-MM-DDTHH:MM:SSZ" do bufora o rozmiarze co najmniej 21 bajtów;
+// zwraca liczbę zapisanych znaków
+int formatIsoTimestamp(std::int64_t seconds, char *out);
+
+// Scalanie k posortowanych serii jednej lokalizacji w jedną ciągłą serię (k-drożne scalanie
+// przez kopiec). Przy tym samym znaczniku czasu wygrywa niepusta wartość z serii o wyższym indeksie.
+AirQualityFrame mergeSortedFrames(const std::vector<const AirQualityFrame *> &parts);
+
+// Konwersja odpowiedzi Open-Meteo (obiekt z polem "hourly") do serii kolumnowej
+AirQualityFrame frameFromJson(const nlohmann::json &data);
+
+// Dekodowanie tekstu odpowiedzi Open-Meteo (obiekt lub tablica obiektów dla wielu punktów) albo
+// zapisu aplikacji (location, station, air_quality_data) w jednym przebiegu parsera SAX. Serie
+// "hourly" i "minutely_15" z jednej odpowiedzi scalane są na wspólnej osi czasu;
+// zgłasza std::runtime_error przy błędnych danych
+std::vector<AirQualityFrame> framesFromJsonText(const char *data, size_t size);
+
+// Klasa Europejskiego Indeksu Jakości Powietrza (0 - dobra ... 5 - skrajnie zła) wyznaczona z ostatnich
+// pomiarów parametrów indeksu (tabela pollutants) nie późniejszych niż `at` (i nie starszych niż 3 h);
+// -1 przy braku danych
+int europeanAqiLevel(const AirQualityFrame &frame, std::int64_t at);
+
+// Agregacja serii do przedziałów o długości bucketSeconds (np. 15 min -> 1 h): znacznik czasu to
+// początek przedziału, wartość - średnia niepustych pomiarów (NaN, gdy brak)
+AirQualityFrame rollupFrame(const AirQualityFrame &frame, std::int64_t bucketSeconds);
+
+// Największa liczba wierszy wykreślana bez agregacji (ok. 20 dni danych 15-minutowych)
+inline constexpr size_t MaxChartRows = 2000;
+
+// Czy seria o kroku krótszym niż godzina ma więcej wierszy niż maxRows i powinna być wykreślona
+// jako średnie godzinowe
+bool needsHourlyRollup(const AirQualityFrame &frame, size_t maxRows = MaxChartRows);
+
+// Najmniejszy odstęp między kolejnymi znacznikami czasu w sekundach (0 dla mniej niż dwóch wierszy)
+std::int64_t smallestStep(const AirQualityFrame &frame);
+
+#endif // AIRQUALITYFRAME_H
@@ -0,0 +1,286 @@
+#include "alertengine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// Podział tekstu na słowa; operatory porównania są osobnymi słowami także bez spacji ("pm10>50")
+std::vector<std::string> tokenize(const std::string &text, size_t &atOffset) {
+    std::vector<std::string> tokens;
+    atOffset = std::string::npos;
+    size_t i = 0;
+    while (i < text.size()) {
+        const unsigned char c = static_cast<unsigned char>(text[i]);
+        if (std::isspace(c)) {
+            ++i;
+        } else if (c == '<' || c == '>') {
+            const size_t length = i + 1 < text.size() && text[i + 1] == '=' ? 2 : 1;
+            tokens.push_back(text.substr(i, length));
+            i += length;
+        } else {
+            const size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i])) && text[i] != '<' && text[i] != '>')
+                ++i;
+            tokens.push_back(text.substr(start, i - start));
+            // Nazwa lokalizacji po "at" może zawierać spacje i przecinki - reszta tekstu
+            if (tokens.back() == "at") {
+                atOffset = i;
+                return tokens;
+            }
+        }
+    }
+    return tokens;
+}
+
+double parseNumber(const std::string &token) {
+    size_t used = 0;
+    double value = NaN;
+    try {
+        value = std::stod(token, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used == 0 || used != token.size() || !std::isfinite(value))
+        throw std::runtime_error("nieprawidłowa liczba '" + token + "'");
+    return value;
+}
+
+std::int64_t parseDuration(const std::string &token) {
+    if (token.size() < 2) throw std::runtime_error("nieprawidłowy czas '" + token + "' (np. 3h, 90m, 1d)");
+    std::int64_t unit = 0;
+    switch (token.back()) {
+    case 's': unit = 1; break;
+    case 'm': unit = 60; break;
+    case 'h': unit = 3600; break;
+    case 'd': unit = 86400; break;
+    default: throw std::runtime_error("nieprawidłowy czas '" + token + "' (np. 3h, 90m, 1d)");
+    }
+    const double count = parseNumber(token.substr(0, token.size() - 1));
+    if (count < 0) throw std::runtime_error("czas nie może być ujemny: '" + token + "'");
+    return static_cast<std::int64_t>(std::llround(count * unit));
+}
+
+bool compare(AlertRule::Comparison comparison, double value, double level) {
+    switch (comparison) {
+    case AlertRule::Comparison::Greater: return value > level;
+    case AlertRule::Comparison::GreaterEqual: return value >= level;
+    case AlertRule::Comparison::Less: return value < level;
+    case AlertRule::Comparison::LessEqual: return value <= level;
+    }
+    return false;
+}
+
+} // namespace
+
+AlertRule AlertRule::parse(const std::string &text) {
+    AlertRule rule;
+    rule.text = text;
+    size_t atOffset = 0;
+    const std::vector<std::string> tokens = tokenize(text, atOffset);
+    size_t pos = 0;
+    auto next = [&](const char *expected) -> const std::string & {
+        if (pos >= tokens.size()) throw std::runtime_error(std::string("oczekiwano: ") + expected);
+        return tokens[pos++];
+    };
+
+    rule.parameter = next("nazwa parametru");
+    for (char c : rule.parameter)
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_')
+            throw std::runtime_error("nieprawidłowa nazwa parametru '" + rule.parameter + "'");
+
+    if (pos < tokens.size() && (tokens[pos] == "mean" || tokens[pos] == "min" || tokens[pos] == "max")) {
+        const std::string &name = tokens[pos++];
+        rule.aggregate = name == "mean" ? Aggregate::Mean : name == "min" ? Aggregate::Min : Aggregate::Max;
+        rule.window = parseDuration(next("długość okna (np. 24h)"));
+        if (rule.window <= 0) throw std::runtime_error("okno agregatu musi być dodatnie");
+    }
+
+    const std::string &op = next("operator porównania (> >= < <=)");
+    if (op == ">") rule.comparison = Comparison::Greater;
+    else if (op == ">=") rule.comparison = Comparison::GreaterEqual;
+    else if (op == "<") rule.comparison = Comparison::Less;
+    else if (op == "<=") rule.comparison = Comparison::LessEqual;
+    else throw std::runtime_error("oczekiwano operatora porównania zamiast '" + op + "'");
+    rule.threshold = parseNumber(next("próg"));
+    rule.clearLevel = rule.threshold;
+
+    while (pos < tokens.size()) {
+        const std::string &keyword = tokens[pos++];
+        if (keyword == "for") {
+            rule.duration = parseDuration(next("czas trwania (np. 3h)"));
+        } else if (keyword == "clear") {
+            rule.clearLevel = parseNumber(next("poziom wygaszenia"));
+        } else if (keyword == "at") {
+            const size_t first = text.find_first_not_of(" \t", atOffset);
+            const size_t last = text.find_last_not_of(" \t\r\n");
+            if (first == std::string::npos || last < first) throw std::runtime_error("oczekiwano nazwy lokalizacji");
+            rule.location = text.substr(first, last - first + 1);
+        } else {
+            throw std::runtime_error("nieznane słowo '" + keyword + "'");
+        }
+    }
+
+    // Histereza: poziom wygaszenia po "bezpiecznej" stronie progu
+    const bool upward = rule.comparison == Comparison::Greater || rule.comparison == Comparison::GreaterEqual;
+    if (upward ? rule.clearLevel > rule.threshold : rule.clearLevel < rule.threshold)
+        throw std::runtime_error(upward ? "poziom wygaszenia nie może być wyższy od progu"
+                                        : "poziom wygaszenia nie może być niższy od progu");
+    return rule;
+}
+
+size_t AlertEngine::addRule(const AlertRule &rule) {
+    size_t aggregate = 0;
+    while (aggregate < aggregates.size()
+           && !(aggregates[aggregate].parameter == rule.parameter && aggregates[aggregate].aggregate == rule.aggregate
+                && aggregates[aggregate].window == rule.window))
+        ++aggregate;
+    if (aggregate == aggregates.size()) {
+        aggregates.push_back({rule.parameter, rule.aggregate, rule.window});
+        aggregateRules.emplace_back();
+    }
+
+    ruleList.push_back(rule);
+    ruleAggregate.push_back(aggregate);
+    aggregateRules[aggregate].push_back(ruleList.size() - 1);
+    return ruleList.size() - 1;
+}
+
+void AlertEngine::clearRules() {
+    ruleList.clear();
+    aggregates.clear();
+    ruleAggregate.clear();
+    aggregateRules.clear();
+    locations.clear();
+}
+
+double AlertEngine::push(WindowState &state, AlertRule::Aggregate aggregate, std::int64_t window,
+                         std::int64_t time, double value) {
+    if (aggregate == AlertRule::Aggregate::Value) return value;
+
+    // Okno (time - window, time]: najpierw usunięcie pomiarów, które z niego wypadły
+    auto &samples = state.samples;
+    while (!samples.empty() && samples.front().first <= time - window) {
+        if (aggregate == AlertRule::Aggregate::Mean) state.sum -= samples.front().second;
+        samples.pop_front();
+    }
+
+    if (!std::isnan(value)) {
+        if (aggregate == AlertRule::Aggregate::Mean) {
+            state.sum += value;
+        } else {
+            // Kolejka monotoniczna: na początku zawsze minimum (maksimum) okna
+            const bool max = aggregate == AlertRule::Aggregate::Max;
+            while (!samples.empty() && (max ? samples.back().second <= value : samples.back().second >= value))
+                samples.pop_back();
+        }
+        samples.emplace_back(time, value);
+    }
+
+    if (samples.empty()) {
+        state.sum = 0.0;
+        return NaN;
+    }
+    return aggregate == AlertRule::Aggregate::Mean ? state.sum / samples.size() : samples.front().second;
+}
+
+std::vector<AlertEvent> AlertEngine::process(const AirQualityFrame &frame, std::int64_t until) {
+    std::vector<AlertEvent> events;
+    if (ruleList.empty() || frame.time.empty()) return events;
+
+    LocationState &state = locations[frame.location];
+    state.windows.resize(aggregates.size());
+    state.rules.resize(ruleList.size());
+
+    const auto &time = frame.time;
+    const size_t begin = state.started ? std::upper_bound(time.begin(), time.end(), state.lastTime) - time.begin() : 0;
+    const size_t end = std::upper_bound(time.begin(), time.end(), until) - time.begin();
+    if (begin >= end) return events;
+
+    // Krok serii (najmniejszy odstęp) - dłuższy odstęp oznacza brakujące wiersze i przerywa odliczanie "for"
+    std::int64_t step = state.step;
+    for (size_t row = std::max<size_t>(begin, 1); row < end; ++row)
+        if (step == 0 || time[row] - time[row - 1] < step) step = time[row] - time[row - 1];
+    state.step = step;
+    const std::int64_t nominal = step > 0 ? step : 3600;
+
+    std::vector<double> values(end - begin);
+    for (size_t a = 0; a < aggregates.size(); ++a) {
+        const AggregateKey &key = aggregates[a];
+        auto column = frame.columns.find(key.parameter);
+        if (column == frame.columns.end() || column->second.size() != time.size()) continue;
+
+        WindowState &window = state.windows[a];
+        for (size_t row = begin; row < end; ++row)
+            values[row - begin] = push(window, key.aggregate, key.window, time[row], column->second[row]);
+
+        for (size_t index : aggregateRules[a]) {
+            const AlertRule &rule = ruleList[index];
+            if (!rule.location.empty() && rule.location != frame.location) continue;
+
+            RuleState &ruleState = state.rules[index];
+            std::int64_t previous = state.started ? state.lastTime : time[begin];
+            for (size_t row = begin; row < end; ++row) {
+                const std::int64_t t = time[row];
+                const double value = values[row - begin];
+                if (t - previous > nominal) ruleState.running = false;
+                previous = t;
+
+                if (std::isnan(value)) {
+                    ruleState.running = false;
+                } else if (ruleState.active) {
+                    if (!compare(rule.comparison, value, rule.clearLevel)) {
+                        ruleState.active = false;
+                        ruleState.running = false;
+                        events.push_back({index, frame.location, t, value, false});
+                    }
+                } else if (compare(rule.comparison, value, rule.threshold)) {
+                    if (!ruleState.running) {
+                        ruleState.running = true;
+                        ruleState.runStart = t;
+                    }
+                    if (t - ruleState.runStart + nominal >= rule.duration) {
+                        ruleState.active = true;
+                        events.push_back({index, frame.location, t, value, true});
+                    }
+                } else {
+                    ruleState.running = false;
+                }
+            }
+        }
+    }
+
+    // Pierwsza ocena: epizody zakończone w historii nie są zgłaszane, z trwających tylko ostatnie włączenie
+    if (!state.started) {
+        std::vector<bool> reported(ruleList.size(), false);
+        std::vector<AlertEvent> ongoing;
+        for (auto event = events.rbegin(); event != events.rend(); ++event) {
+            if (reported[event->rule]) continue;
+            reported[event->rule] = true;
+            if (event->raised) ongoing.push_back(std::move(*event));
+        }
+        events = std::move(ongoing);
+    }
+
+    state.started = true;
+    state.lastTime = time[end - 1];
+    std::stable_sort(events.begin(), events.end(), [](const AlertEvent &a, const AlertEvent &b) { return a.time < b.time; });
+    return events;
+}
+
+bool AlertEngine::isActive(size_t rule, const std::string &location) const {
+    auto it = locations.find(location);
+    return it != locations.end() && rule < it->second.rules.size() && it->second.rules[rule].active;
+}
+
+size_t AlertEngine::activeCount() const {
+    size_t total = 0;
+    for (const auto &item : locations)
+        for (const RuleState &rule : item.second.rules) total += rule.active;
+    return total;
+}
@@ -0,0 +1,112 @@
+#ifndef ALERTENGINE_H
+#define ALERTENGINE_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Reguła powiadomienia, np. "pm2_5 mean 24h > 25 for 3h clear 20 at Kraków"
+ * \details Składnia: parametr [mean|min|max okno] operator próg [for czas] [clear poziom] [at lokalizacja].
+ * Okno i czas zapisywane są liczbą z jednostką s, m, h lub d. Bez okna porównywana jest bieżąca
+ * wartość; "for" wymaga spełnienia warunku nieprzerwanie przez podany czas, "clear" to poziom
+ * wygaszenia alarmu (histereza, domyślnie równy progowi), a "at" ogranicza regułę do jednej
+ * lokalizacji (domyślnie dowolna obserwowana).
+ */
+struct AlertRule {
+    enum class Aggregate { Value, Mean, Min, Max };
+    enum class Comparison { Greater, GreaterEqual, Less, LessEqual };
+
+    std::string text;
+    std::string parameter;
+    Aggregate aggregate = Aggregate::Value;
+    std::int64_t window = 0;
+    Comparison comparison = Comparison::Greater;
+    double threshold = 0.0;
+    double clearLevel = 0.0;
+    std::int64_t duration = 0;
+    std::string location;
+
+    // Zgłasza std::runtime_error z opisem błędu składni
+    static AlertRule parse(const std::string &text);
+};
+
+// Zmiana stanu reguły dla lokalizacji: włączenie albo wygaszenie alarmu
+struct AlertEvent {
+    size_t rule;
+    std::string location;
+    std::int64_t time;
+    double value;
+    bool raised;
+};
+
+/*!
+ * \brief Przyrostowa ocena reguł powiadomień dla obserwowanych lokalizacji
+ * \details Reguły kompilowane są do automatów stanów aktualizowanych w czasie O(1) na dopisany pomiar:
+ * średnia w oknie liczona jest z bieżącej sumy, a minimum i maksimum z kolejki monotonicznej, więc
+ * historia nie jest skanowana ponownie. Reguły o tym samym parametrze, funkcji i oknie współdzielą
+ * jeden agregat. Dla każdej lokalizacji zapamiętywany jest ostatni oceniony znacznik czasu - przy
+ * kolejnym odpytaniu przetwarzane są tylko nowsze wiersze (późniejsze poprawki starszych wierszy
+ * nie są uwzględniane). Zdarzenia zgłaszane są tylko przy zmianie stanu alarmu (deduplikacja);
+ * brak pomiaru przerywa odliczanie czasu "for", ale nie wygasza aktywnego alarmu. Pierwsze
+ * odpytanie lokalizacji (także po zmianie reguł) odtwarza stan z historii bez zdarzeń - zgłaszane
+ * są tylko alarmy trwające w ostatnim ocenionym wierszu, a zakończone epizody są pomijane.
+ */
+class AlertEngine {
+public:
+    // Zwraca indeks reguły
+    size_t addRule(const AlertRule &rule);
+    void clearRules();
+    const std::vector<AlertRule> &rules() const { return ruleList; }
+
+    // Ocena wierszy serii nowszych niż poprzednio ocenione i nie późniejszych niż `until`
+    // (prognoza nie wyzwala alarmów); zdarzenia w kolejności czasu. Przy pierwszej ocenie
+    // lokalizacji tylko włączenia alarmów aktywnych na końcu historii
+    std::vector<AlertEvent> process(const AirQualityFrame &frame, std::int64_t until);
+
+    bool isActive(size_t rule, const std::string &location) const;
+    size_t activeCount() const;
+
+private:
+    struct AggregateKey {
+        std::string parameter;
+        AlertRule::Aggregate aggregate;
+        std::int64_t window;
+    };
+
+    // Stan okna agregatu dla jednej lokalizacji
+    struct WindowState {
+        std::deque<std::pair<std::int64_t, double>> samples;
+        double sum = 0.0;
+    };
+
+    struct RuleState {
+        bool active = false;
+        bool running = false;
+        std::int64_t runStart = 0;
+    };
+
+    struct LocationState {
+        bool started = false;
+        std::int64_t lastTime = 0;
+        std::int64_t step = 0;
+        std::vector<WindowState> windows;
+        std::vector<RuleState> rules;
+    };
+
+    static double push(WindowState &state, AlertRule::Aggregate aggregate, std::int64_t window,
+                       std::int64_t time, double value);
+
+    std::vector<AlertRule> ruleList;
+    std::vector<AggregateKey> aggregates;
+    std::vector<size_t> ruleAggregate;
+    std::vector<std::vector<size_t>> aggregateRules;
+    std::unordered_map<std::string, LocationState> locations;
+};
+
+#endif // ALERTENGINE_H
@@ -0,0 +1,221 @@
+#include "alertmonitor.h"
+
+#include "openmeteo.h"
+
+#include <QDateTime>
+#include <QLocalSocket>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSystemTrayIcon>
+#include <QTimer>
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+
+using json = nlohmann::json;
+
+AlertNotifier::AlertNotifier(QObject *parent) : QObject(parent),
+    socket(new QLocalSocket(this)) {
+
+    connect(socket, &QLocalSocket::connected, this, &AlertNotifier::flushSocket);
+}
+
+void AlertNotifier::setLogFile(const QString &fileName) {
+    if (log.isOpen()) log.close();
+    log.setFileName(fileName);
+    if (!fileName.isEmpty()) log.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+}
+
+void AlertNotifier::setSocketName(const QString &name) {
+    socketName = name;
+    socket->abort();
+    pendingLines.clear();
+}
+
+void AlertNotifier::deliver(const QString &title, const QString &message) {
+    const QString line = QString("%1 %2: %3").arg(QDateTime::currentDateTime().toString(Qt::ISODate), title, message);
+
+    if (log.isOpen()) {
+        log.write(line.toUtf8() + '\n');
+        log.flush();
+    }
+    if (tray && tray->isVisible()) tray->showMessage(title, message, QSystemTrayIcon::Warning);
+
+    if (socketName.isEmpty()) return;
+    pendingLines.append(line);
+    while (pendingLines.size() > maxPendingLines) pendingLines.removeFirst();
+    if (socket->state() == QLocalSocket::UnconnectedState) socket->connectToServer(socketName, QIODevice::WriteOnly);
+    flushSocket();
+}
+
+// Zapis do bufora gniazda nie blokuje - dane wysyłane są w pętli zdarzeń
+void AlertNotifier::flushSocket() {
+    if (socket->state() != QLocalSocket::ConnectedState) return;
+    for (const QString &line : pendingLines) socket->write(line.toUtf8() + '\n');
+    pendingLines.clear();
+}
+
+AlertMonitor::AlertMonitor(QObject *parent) : QObject(parent),
+    network(new QNetworkAccessManager(this)),
+    ticker(new QTimer(this)) {
+
+    connect(ticker, &QTimer::timeout, this, &AlertMonitor::poll);
+    connect(network, &QNetworkAccessManager::finished, this, &AlertMonitor::handleReply);
+}
+
+bool AlertMonitor::load(const QString &fileName) {
+    std::ifstream file(fileName.toStdString());
+    if (!file.is_open()) return false;
+
+    try {
+        json data = json::parse(file);
+        QStringList lines;
+        for (const auto &rule : data.value("rules", json::array()))
+            lines.append(QString::fromStdString(rule.get<std::string>()));
+        QString error;
+        if (!setRules(lines, error)) return false;
+
+        locations.clear();
+        for (const auto &location : data.value("watched", json::array()))
+            watch(QString::fromStdString(location.value("label", std::string())),
+                  {location.value("latitude", 0.0), location.value("longitude", 0.0)});
+    } catch (const std::exception &) {
+        return false;
+    }
+    return true;
+}
+
+bool AlertMonitor::save(const QString &fileName) const {
+    json data;
+    data["rules"] = json::array();
+    for (const QString &line : ruleText) data["rules"].push_back(line.toStdString());
+    data["watched"] = json::array();
+    for (const WatchedLocation &location : locations)
+        data["watched"].push_back({
+            {"label", location.label.toStdString()},
+            {"latitude", location.position.latitude},
+            {"longitude", location.position.longitude}
+        });
+
+    std::ofstream file(fileName.toStdString());
+    if (!file.is_open()) return false;
+    file << data.dump(2);
+    return file.good();
+}
+
+// Po zmianie reguł stan alarmów odtwarzany jest z historii w kolejnym cyklu; niezmieniona lista
+// zachowuje stan, więc trwające alarmy nie są zgłaszane ponownie
+bool AlertMonitor::setRules(const QStringList &lines, QString &error) {
+    std::vector<AlertRule> parsed;
+    QStringList kept;
+    for (int i = 0; i < lines.size(); ++i) {
+        const QString line = lines[i].section('#', 0, 0).trimmed();
+        if (line.isEmpty()) continue;
+        try {
+            parsed.push_back(AlertRule::parse(line.toStdString()));
+            kept.append(line);
+        } catch (const std::exception &e) {
+            error = QString("Linia %1: %2").arg(i + 1).arg(e.what());
+            return false;
+        }
+    }
+
+    if (kept == ruleText) return true;
+    engine.clearRules();
+    for (const AlertRule &rule : parsed) engine.addRule(rule);
+    ruleText = kept;
+    return true;
+}
+
+QStringList AlertMonitor::ruleLines() const {
+    return ruleText;
+}
+
+void AlertMonitor::watch(const QString &label, const GeoPoint &position) {
+    if (label.isEmpty() || isWatched(label)) return;
+    locations.append({label, position});
+}
+
+void AlertMonitor::unwatch(const QString &label) {
+    locations.erase(std::remove_if(locations.begin(), locations.end(),
+                                   [&](const WatchedLocation &location) { return location.label == label; }),
+                    locations.end());
+}
+
+bool AlertMonitor::isWatched(const QString &label) const {
+    return std::any_of(locations.begin(), locations.end(),
+                       [&](const WatchedLocation &location) { return location.label == label; });
+}
+
+void AlertMonitor::start(int intervalSeconds) {
+    ticker->start(std::max(60, intervalSeconds) * 1000);
+    poll();
+}
+
+void AlertMonitor::stop() {
+    ticker->stop();
+    for (QNetworkReply *reply : network->findChildren<QNetworkReply *>()) reply->abort();
+}
+
+bool AlertMonitor::isActive() const {
+    return ticker->isActive();
+}
+
+void AlertMonitor::poll() {
+    // Poprzedni cykl jeszcze trwa - kolejny zostanie wykonany przy następnym tyknięciu
+    if (pendingReplies > 0 || locations.isEmpty()) return;
+
+    cycleLocations = 0;
+    cycleEvents = 0;
+    for (int first = 0; first < locations.size(); first += pointsPerRequest) {
+        std::vector<GeoPoint> points;
+        QStringList labels;
+        for (int i = first; i < std::min<int>(first + pointsPerRequest, locations.size()); ++i) {
+            points.push_back(locations[i].position);
+            labels.append(locations[i].label);
+        }
+        QNetworkReply *reply = network->get(QNetworkRequest(airQualityRequestUrl(points)));
+        reply->setProperty("labels", labels);
+        ++pendingReplies;
+    }
+}
+
+void AlertMonitor::handleReply(QNetworkReply *reply) {
+    reply->deleteLater();
+    --pendingReplies;
+
+    if (reply->error() == QNetworkReply::NoError) {
+        try {
+            const QByteArray data = reply->readAll();
+            std::vector<AirQualityFrame> frames = framesFromJsonText(data.constData(), data.size());
+            const QStringList labels = reply->property("labels").toStringList();
+            const std::int64_t now = QDateTime::currentSecsSinceEpoch();
+
+            for (size_t i = 0; i < frames.size() && i < static_cast<size_t>(labels.size()); ++i) {
+                AirQualityFrame &frame = frames[i];
+                frame.location = labels[static_cast<int>(i)].toStdString();
+                for (const AlertEvent &event : engine.process(frame, now)) {
+                    emit alertChanged(event.raised ? "Alarm: " + labels[static_cast<int>(i)]
+                                                   : "Koniec alarmu: " + labels[static_cast<int>(i)],
+                                      describe(event));
+                    ++cycleEvents;
+                }
+                ++cycleLocations;
+                emit locationUpdated(frame);
+            }
+        } catch (const std::exception &) {
+            // Uszkodzona odpowiedź - lokalizacje zostaną odpytane w kolejnym cyklu
+        }
+    }
+
+    if (pendingReplies == 0) emit cycleFinished(cycleLocations, cycleEvents);
+}
+
+QString AlertMonitor::describe(const AlertEvent &event) const {
+    return QString("%1 (wartość %2, %3)")
+        .arg(QString::fromStdString(engine.rules()[event.rule].text))
+        .arg(event.value, 0, 'f', 1)
+        .arg(QDateTime::fromSecsSinceEpoch(event.time).toString("dd.MM.yyyy HH:mm"));
+}
@@ -0,0 +1,112 @@
+#ifndef ALERTMONITOR_H
+#define ALERTMONITOR_H
+
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+#include "airqualityframe.h"
+#include "alertengine.h"
+#include "spatialindex.h"
+
+class QLocalSocket;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QSystemTrayIcon;
+class QTimer;
+
+/*!
+ * \brief Nieblokujące dostarczanie powiadomień: plik dziennika, gniazdo lokalne, ikona w zasobniku
+ * \details Powiadomienia przyjmowane są przez slot wywoływany połączeniem kolejkowanym, więc
+ * odpytywanie nie czeka na zapis. Do gniazda lokalnego (QLocalSocket) wysyłana jest jedna linia
+ * tekstu na powiadomienie; przy braku połączenia linie czekają w ograniczonej kolejce, a po jej
+ * przepełnieniu najstarsze są odrzucane.
+ */
+class AlertNotifier : public QObject {
+    Q_OBJECT
+
+public:
+    explicit AlertNotifier(QObject *parent = nullptr);
+
+    void setLogFile(const QString &fileName);
+    void setSocketName(const QString &name);
+    void setTrayIcon(QSystemTrayIcon *icon) { tray = icon; }
+
+public slots:
+    void deliver(const QString &title, const QString &message);
+
+private:
+    void flushSocket();
+
+    QFile log;
+    QLocalSocket *socket;
+    QString socketName;
+    QSystemTrayIcon *tray = nullptr;
+    QStringList pendingLines;
+    const int maxPendingLines = 1000;
+};
+
+/*!
+ * \brief Cykliczne odpytywanie obserwowanych lokalizacji i ocena reguł powiadomień
+ * \details W każdym cyklu dane wszystkich obserwowanych lokalizacji pobierane są zapytaniami
+ * zbiorczymi (wiele punktów w jednym zapytaniu), a AlertEngine ocenia tylko wiersze nowsze od
+ * poprzedniego cyklu i nie późniejsze niż bieżąca chwila. Reguły i lista lokalizacji zapisywane
+ * są w pliku JSON.
+ */
+class AlertMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    struct WatchedLocation {
+        QString label;
+        GeoPoint position;
+    };
+
+    explicit AlertMonitor(QObject *parent = nullptr);
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+    // Zastępuje reguły listą (po jednej w linii, "#" rozpoczyna komentarz); przy błędzie reguły nie są
+    // zmieniane, a error zawiera numer linii i opis
+    bool setRules(const QStringList &lines, QString &error);
+    QStringList ruleLines() const;
+
+    void watch(const QString &label, const GeoPoint &position);
+    void unwatch(const QString &label);
+    bool isWatched(const QString &label) const;
+    const QList<WatchedLocation> &watched() const { return locations; }
+
+    void start(int intervalSeconds);
+    void stop();
+    bool isActive() const;
+    size_t activeAlerts() const { return engine.activeCount(); }
+
+public slots:
+    void poll();
+
+signals:
+    // Świeże dane obserwowanej lokalizacji (do scalenia z magazynem)
+    void locationUpdated(const AirQualityFrame &frame);
+    void alertChanged(const QString &title, const QString &message);
+    void cycleFinished(int locations, int events);
+
+private slots:
+    void handleReply(QNetworkReply *reply);
+
+private:
+    QString describe(const AlertEvent &event) const;
+
+    AlertEngine engine;
+    QStringList ruleText;
+    QList<WatchedLocation> locations;
+    QNetworkAccessManager *network;
+    QTimer *ticker;
+    int pendingReplies = 0;
+    int cycleLocations = 0;
+    int cycleEvents = 0;
+    const int pointsPerRequest = 50;
+};
+
+#endif // ALERTMONITOR_H
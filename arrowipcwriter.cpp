@@ -0,0 +1,338 @@
+#include "arrowipcwriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace {
+
+// Identyfikatory z Schema.fbs / Message.fbs specyfikacji Arrow
+const std::int16_t MetadataVersionV5 = 4;
+const std::uint8_t HeaderSchema = 1;
+const std::uint8_t HeaderRecordBatch = 3;
+const std::uint8_t TypeFloatingPoint = 3;
+const std::uint8_t TypeUtf8 = 5;
+const std::uint8_t TypeTimestamp = 10;
+const std::int16_t PrecisionSingle = 1;
+const std::int16_t PrecisionDouble = 2;
+const std::int16_t TimeUnitSecond = 0;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Węzeł drzewa FlatBuffers: tabela, napis, wektor referencji albo wektor struktur
+struct FbNode {
+    enum class Kind { Table, String, OffsetVector, StructVector };
+
+    struct Field {
+        int id;
+        size_t size;
+        std::uint64_t bits;
+        std::shared_ptr<FbNode> ref;
+    };
+
+    Kind kind = Kind::Table;
+    std::vector<Field> fields;
+    std::string text;
+    std::vector<std::shared_ptr<FbNode>> items;
+    std::vector<std::uint8_t> bytes;
+    std::uint32_t count = 0;
+
+    template <typename T>
+    FbNode &scalar(int id, T value) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(T));
+        fields.push_back({id, sizeof(T), bits, nullptr});
+        return *this;
+    }
+
+    FbNode &reference(int id, std::shared_ptr<FbNode> node) {
+        fields.push_back({id, 4, 0, std::move(node)});
+        return *this;
+    }
+};
+
+using FbRef = std::shared_ptr<FbNode>;
+
+FbRef fbTable() {
+    return std::make_shared<FbNode>();
+}
+
+FbRef fbString(const std::string &text) {
+    auto node = std::make_shared<FbNode>();
+    node->kind = FbNode::Kind::String;
+    node->text = text;
+    return node;
+}
+
+FbRef fbVector(std::vector<FbRef> items) {
+    auto node = std::make_shared<FbNode>();
+    node->kind = FbNode::Kind::OffsetVector;
+    node->items = std::move(items);
+    return node;
+}
+
+FbRef fbStructVector(std::vector<std::uint8_t> bytes, std::uint32_t count) {
+    auto node = std::make_shared<FbNode>();
+    node->kind = FbNode::Kind::StructVector;
+    node->bytes = std::move(bytes);
+    node->count = count;
+    return node;
+}
+
+/*
+ * Zapis drzewa od korzenia w przód bufora: obiekty podrzędne trafiają zawsze za obiekt
+ * nadrzędny (przesunięcia uoffset_t muszą być dodatnie), vtable tuż przed swoją tabelą.
+ */
+class FbSerializer {
+public:
+    std::vector<std::uint8_t> finish(const FbNode &root) {
+        buffer.assign(4, 0);
+        const size_t rootPosition = write(root);
+        patch(0, static_cast<std::uint32_t>(rootPosition));
+        pad(8);
+        return std::move(buffer);
+    }
+
+private:
+    std::vector<std::uint8_t> buffer;
+
+    void pad(size_t alignment) {
+        buffer.resize(alignUp(buffer.size(), alignment), 0);
+    }
+
+    template <typename T>
+    void put(T value) {
+        const size_t at = buffer.size();
+        buffer.resize(at + sizeof(T));
+        std::memcpy(buffer.data() + at, &value, sizeof(T));
+    }
+
+    void patch(size_t at, std::uint32_t value) {
+        std::memcpy(buffer.data() + at, &value, sizeof(value));
+    }
+
+    void writeChild(size_t slot, const FbNode &child) {
+        const size_t position = write(child);
+        patch(slot, static_cast<std::uint32_t>(position - slot));
+    }
+
+    size_t write(const FbNode &node) {
+        switch (node.kind) {
+        case FbNode::Kind::String: {
+            pad(4);
+            const size_t position = buffer.size();
+            put(static_cast<std::uint32_t>(node.text.size()));
+            buffer.insert(buffer.end(), node.text.begin(), node.text.end());
+            buffer.push_back(0);
+            return position;
+        }
+        case FbNode::Kind::OffsetVector: {
+            pad(4);
+            const size_t position = buffer.size();
+            put(static_cast<std::uint32_t>(node.items.size()));
+            const size_t slots = buffer.size();
+            buffer.resize(slots + 4 * node.items.size(), 0);
+            for (size_t i = 0; i < node.items.size(); ++i)
+                writeChild(slots + 4 * i, *node.items[i]);
+            return position;
+        }
+        case FbNode::Kind::StructVector: {
+            // Elementy struktur (pola int64) muszą być wyrównane do 8 bajtów
+            pad(4);
+            if ((buffer.size() + 4) % 8 != 0) put(std::uint32_t(0));
+            const size_t position = buffer.size();
+            put(node.count);
+            buffer.insert(buffer.end(), node.bytes.begin(), node.bytes.end());
+            return position;
+        }
+        case FbNode::Kind::Table:
+            break;
+        }
+
+        // Układ tabeli: soffset_t, następnie pola od największych, każde wyrównane do swojego rozmiaru
+        std::vector<size_t> order(node.fields.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+                         [&node](size_t a, size_t b) { return node.fields[a].size > node.fields[b].size; });
+
+        std::vector<size_t> fieldOffset(node.fields.size());
+        size_t tableSize = 4;
+        int maxId = -1;
+        for (size_t index : order) {
+            const size_t size = node.fields[index].size;
+            tableSize = alignUp(tableSize, size);
+            fieldOffset[index] = tableSize;
+            tableSize += size;
+            maxId = std::max(maxId, node.fields[index].id);
+        }
+
+        pad(2);
+        const size_t vtablePosition = buffer.size();
+        put(static_cast<std::uint16_t>(4 + 2 * (maxId + 1)));
+        put(static_cast<std::uint16_t>(tableSize));
+        for (int id = 0; id <= maxId; ++id) {
+            std::uint16_t offset = 0;
+            for (size_t i = 0; i < node.fields.size(); ++i)
+                if (node.fields[i].id == id) offset = static_cast<std::uint16_t>(fieldOffset[i]);
+            put(offset);
+        }
+
+        pad(8);
+        const size_t tablePosition = buffer.size();
+        buffer.resize(tablePosition + tableSize, 0);
+        const std::int32_t vtableOffset = static_cast<std::int32_t>(tablePosition - vtablePosition);
+        std::memcpy(buffer.data() + tablePosition, &vtableOffset, sizeof(vtableOffset));
+        for (size_t i = 0; i < node.fields.size(); ++i)
+            if (!node.fields[i].ref)
+                std::memcpy(buffer.data() + tablePosition + fieldOffset[i], &node.fields[i].bits, node.fields[i].size);
+
+        for (size_t i = 0; i < node.fields.size(); ++i)
+            if (node.fields[i].ref) writeChild(tablePosition + fieldOffset[i], *node.fields[i].ref);
+        return tablePosition;
+    }
+};
+
+template <typename T>
+void appendStruct(std::vector<std::uint8_t> &bytes, T value) {
+    const size_t at = bytes.size();
+    bytes.resize(at + sizeof(T));
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+}
+
+FbRef schemaTable(const std::vector<ArrowIpcWriter::Column> &columns) {
+    std::vector<FbRef> fields;
+    for (const auto &column : columns) {
+        FbRef type = fbTable();
+        std::uint8_t typeId = TypeUtf8;
+        if (column.type == ArrowIpcWriter::ColumnType::Float32 || column.type == ArrowIpcWriter::ColumnType::Float64) {
+            typeId = TypeFloatingPoint;
+            type->scalar<std::int16_t>(0, column.type == ArrowIpcWriter::ColumnType::Float32 ? PrecisionSingle
+                                                                                             : PrecisionDouble);
+        } else if (column.type == ArrowIpcWriter::ColumnType::TimestampSeconds) {
+            typeId = TypeTimestamp;
+            type->scalar<std::int16_t>(0, TimeUnitSecond).reference(1, fbString("UTC"));
+        }
+
+        FbRef field = fbTable();
+        field->reference(0, fbString(column.name))
+            .scalar<std::uint8_t>(1, 1)
+            .scalar<std::uint8_t>(2, typeId)
+            .reference(3, type)
+            .reference(5, fbVector({}));
+        fields.push_back(field);
+    }
+
+    FbRef schema = fbTable();
+    schema->scalar<std::int16_t>(0, 0).reference(1, fbVector(std::move(fields)));
+    return schema;
+}
+
+FbRef messageTable(std::uint8_t headerType, FbRef header, std::int64_t bodyLength) {
+    FbRef message = fbTable();
+    message->scalar<std::int16_t>(0, MetadataVersionV5)
+        .scalar<std::uint8_t>(1, headerType)
+        .reference(2, std::move(header))
+        .scalar<std::int64_t>(3, bodyLength);
+    return message;
+}
+
+} // namespace
+
+ArrowIpcWriter::ArrowIpcWriter(std::ostream &out) : out(out) {
+    writeBytes("ARROW1\0\0", 8);
+}
+
+void ArrowIpcWriter::writeBytes(const void *data, size_t size) {
+    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    position += static_cast<std::int64_t>(size);
+}
+
+void ArrowIpcWriter::writePadding(size_t size) {
+    static const char zeros[8] = {};
+    writeBytes(zeros, size);
+}
+
+void ArrowIpcWriter::writeSchema(const std::vector<Column> &columns) {
+    schema = columns;
+    const std::vector<std::uint8_t> metadata = FbSerializer().finish(*messageTable(HeaderSchema, schemaTable(schema), 0));
+    const std::uint32_t continuation = 0xFFFFFFFF;
+    const std::int32_t length = static_cast<std::int32_t>(metadata.size());
+    writeBytes(&continuation, 4);
+    writeBytes(&length, 4);
+    writeBytes(metadata.data(), metadata.size());
+}
+
+void ArrowIpcWriter::writeBatch(std::int64_t length, const std::vector<ColumnData> &columns) {
+    // Lista buforów ciała wiadomości, każdy wyrównany do 8 bajtów
+    struct BodyBuffer {
+        const void *data;
+        size_t size;
+    };
+    std::vector<BodyBuffer> body;
+    std::vector<std::uint8_t> nodes, buffers;
+    std::int64_t bodyLength = 0;
+    auto addBuffer = [&](const void *data, size_t size) {
+        appendStruct<std::int64_t>(buffers, bodyLength);
+        appendStruct<std::int64_t>(buffers, static_cast<std::int64_t>(size));
+        body.push_back({data, size});
+        bodyLength += static_cast<std::int64_t>(alignUp(size, 8));
+    };
+
+    for (size_t c = 0; c < columns.size() && c < schema.size(); ++c) {
+        const ColumnData &column = columns[c];
+        appendStruct<std::int64_t>(nodes, length);
+        appendStruct<std::int64_t>(nodes, column.nullCount);
+        addBuffer(column.validity, column.validity ? static_cast<size_t>((length + 7) / 8) : 0);
+        if (schema[c].type == ColumnType::Utf8) {
+            addBuffer(column.offsets, static_cast<size_t>(length + 1) * sizeof(std::int32_t));
+            addBuffer(column.values, static_cast<size_t>(column.offsets[length]));
+        } else {
+            addBuffer(column.values, column.valueBytes);
+        }
+    }
+
+    FbRef batch = fbTable();
+    batch->scalar<std::int64_t>(0, length)
+        .reference(1, fbStructVector(std::move(nodes), static_cast<std::uint32_t>(schema.size())))
+        .reference(2, fbStructVector(std::move(buffers), static_cast<std::uint32_t>(body.size())));
+    const std::vector<std::uint8_t> metadata = FbSerializer().finish(*messageTable(HeaderRecordBatch, batch, bodyLength));
+
+    const std::uint32_t continuation = 0xFFFFFFFF;
+    const std::int32_t metadataLength = static_cast<std::int32_t>(metadata.size());
+    batches.push_back({position, 8 + metadataLength, bodyLength});
+    writeBytes(&continuation, 4);
+    writeBytes(&metadataLength, 4);
+    writeBytes(metadata.data(), metadata.size());
+    for (const BodyBuffer &buffer : body) {
+        if (buffer.size) writeBytes(buffer.data, buffer.size);
+        writePadding(alignUp(buffer.size, 8) - buffer.size);
+    }
+}
+
+void ArrowIpcWriter::finish() {
+    // Znacznik końca strumienia, następnie stopka z położeniem wszystkich partii
+    const std::uint32_t endOfStream[2] = {0xFFFFFFFF, 0};
+    writeBytes(endOfStream, sizeof(endOfStream));
+
+    std::vector<std::uint8_t> blocks;
+    for (const Block &block : batches) {
+        appendStruct<std::int64_t>(blocks, block.offset);
+        appendStruct<std::int32_t>(blocks, block.metaDataLength);
+        appendStruct<std::int32_t>(blocks, 0);
+        appendStruct<std::int64_t>(blocks, block.bodyLength);
+    }
+
+    FbRef footer = fbTable();
+    footer->scalar<std::int16_t>(0, MetadataVersionV5)
+        .reference(1, schemaTable(schema))
+        .reference(2, fbStructVector({}, 0))
+        .reference(3, fbStructVector(std::move(blocks), static_cast<std::uint32_t>(batches.size())));
+    const std::vector<std::uint8_t> metadata = FbSerializer().finish(*footer);
+    const std::int32_t footerLength = static_cast<std::int32_t>(metadata.size());
+    writeBytes(metadata.data(), metadata.size());
+    writeBytes(&footerLength, 4);
+    writeBytes("ARROW1", 6);
+    out.flush();
+}
@@ -0,0 +1,55 @@
+#ifndef ARROWIPCWRITER_H
+#define ARROWIPCWRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief Strumieniowy zapis plików Apache Arrow IPC (format pliku, zgodny z Feather v2)
+ * \details Metadane (schemat, partie rekordów, stopka) kodowane są ręcznie w formacie FlatBuffers,
+ * więc aplikacja nie wymaga biblioteki Arrow. Obsługiwane są płaskie kolumny typów utf8,
+ * timestamp[s, UTC], float32 oraz float64. W pamięci przechowywana jest jedynie lista bloków do stopki.
+ */
+class ArrowIpcWriter {
+public:
+    enum class ColumnType { Utf8, TimestampSeconds, Float32, Float64 };
+
+    struct Column {
+        std::string name;
+        ColumnType type;
+    };
+
+    // Bufory jednej kolumny w partii; validity == nullptr oznacza brak wartości pustych
+    struct ColumnData {
+        const std::uint8_t *validity = nullptr;
+        std::int64_t nullCount = 0;
+        const std::int32_t *offsets = nullptr;
+        const void *values = nullptr;
+        size_t valueBytes = 0;
+    };
+
+    explicit ArrowIpcWriter(std::ostream &out);
+
+    void writeSchema(const std::vector<Column> &columns);
+    void writeBatch(std::int64_t length, const std::vector<ColumnData> &columns);
+    void finish();
+
+private:
+    struct Block {
+        std::int64_t offset;
+        std::int32_t metaDataLength;
+        std::int64_t bodyLength;
+    };
+
+    void writeBytes(const void *data, size_t size);
+    void writePadding(size_t size);
+
+    std::ostream &out;
+    std::int64_t position = 0;
+    std::vector<Column> schema;
+    std::vector<Block> batches;
+};
+
+#endif // ARROWIPCWRITER_H
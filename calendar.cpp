@@ -0,0 +1,70 @@
+#include "calendar.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::uint32_t DailyAggregates::countOn(std::int64_t day) const {
+    return day >= firstDay && day <= lastDay() ? count[static_cast<size_t>(day - firstDay)] : 0;
+}
+
+double DailyAggregates::meanOn(std::int64_t day) const {
+    const std::uint32_t samples = countOn(day);
+    return samples ? sum[static_cast<size_t>(day - firstDay)] / samples : std::numeric_limits<double>::quiet_NaN();
+}
+
+double DailyAggregates::maxOn(std::int64_t day) const {
+    return countOn(day) ? max[static_cast<size_t>(day - firstDay)] : std::numeric_limits<double>::quiet_NaN();
+}
+
+bool DailyAggregates::sameDays(const DailyAggregates &other, std::int64_t from, std::int64_t to) const {
+    for (std::int64_t day = from; day < to; ++day) {
+        const std::uint32_t samples = countOn(day);
+        if (samples != other.countOn(day)) return false;
+        if (!samples) continue;
+        const size_t a = static_cast<size_t>(day - firstDay), b = static_cast<size_t>(day - other.firstDay);
+        if (std::memcmp(&sum[a], &other.sum[b], sizeof(double)) || std::memcmp(&max[a], &other.max[b], sizeof(double)))
+            return false;
+    }
+    return true;
+}
+
+DailyAggregates dailyAggregates(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                const UtcOffsetTable &zone) {
+    DailyAggregates result;
+    const size_t rows = std::min(time.size(), values.size());
+    if (rows == 0) return result;
+
+    // Numer dnia lokalnego każdego wiersza (zamiana w miejscu czasu lokalnego)
+    std::vector<std::int64_t> day = localTimes(time, rows, zone);
+    for (std::int64_t &local : day) local = (local - ((local % 86400) + 86400) % 86400) / 86400;
+
+    // Po cofnięciu zegara numery dni nie są monotoniczne - zakres z minimum i maksimum
+    const auto [firstDay, lastDay] = std::minmax_element(day.begin(), day.end());
+    result.firstDay = *firstDay;
+    const size_t days = static_cast<size_t>(*lastDay - *firstDay + 1);
+    result.sum.assign(days, 0.0);
+    result.max.assign(days, std::numeric_limits<double>::quiet_NaN());
+    result.count.assign(days, 0);
+
+    // Dni są ciągłymi fragmentami posortowanej osi; pętla po fragmencie maskuje NaN bez rozgałęzień.
+    // Cofnięcie zegara o północy powtarza dzień po fragmencie następnego, więc fragmenty są scalane
+    for (size_t begin = 0; begin < rows;) {
+        size_t end = begin + 1;
+        while (end < rows && day[end] == day[begin]) ++end;
+        double sum = 0.0, max = -std::numeric_limits<double>::infinity();
+        std::uint32_t count = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const double value = values[i];
+            const bool present = value == value;
+            sum += present ? value : 0.0;
+            max = present && value > max ? value : max;
+            count += present;
+        }
+        const size_t index = static_cast<size_t>(day[begin] - result.firstDay);
+        if (count) result.max[index] = result.count[index] ? std::max(result.max[index], max) : max;
+        result.sum[index] += sum;
+        result.count[index] += count;
+        begin = end;
+    }
+    return result;
+}
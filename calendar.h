@@ -0,0 +1,40 @@
+#ifndef CALENDAR_H
+#define CALENDAR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "profile.h"
+
+/*!
+ * \brief Agregaty dobowe serii w czasie lokalnym: suma, maksimum i liczba pomiarów każdego dnia
+ * \details Dni numerowane są od 1970-01-01 (dzień 0) w czasie lokalnym lokalizacji; element i
+ * opisuje dzień firstDay + i. Dzień bez pomiarów ma count = 0 i maksimum NaN. Dni spoza zakresu
+ * traktowane są jak dni bez pomiarów.
+ */
+struct DailyAggregates {
+    std::int64_t firstDay = 0;
+    std::vector<double> sum;
+    std::vector<double> max;
+    std::vector<std::uint32_t> count;
+
+    size_t days() const { return count.size(); }
+    std::int64_t lastDay() const { return firstDay + static_cast<std::int64_t>(days()) - 1; }
+
+    // Wartości dnia o numerze day (nie indeksie)
+    std::uint32_t countOn(std::int64_t day) const;
+    double meanOn(std::int64_t day) const;
+    double maxOn(std::int64_t day) const;
+
+    // Czy dni [from, to) mają te same agregaty co w other (porównanie bitowe, NaN równe NaN)
+    bool sameDays(const DailyAggregates &other, std::int64_t from, std::int64_t to) const;
+};
+
+// Agregaty dobowe serii; wiersze przypisywane są do dni lokalnych (localTimes), a oś jest posortowana,
+// więc każdy dzień to ciągły fragment sumowany osobno
+DailyAggregates dailyAggregates(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                const UtcOffsetTable &zone);
+
+#endif // CALENDAR_H
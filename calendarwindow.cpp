@@ -0,0 +1,296 @@
+#include "calendarwindow.h"
+
+#include <QComboBox>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollArea>
+#include <QToolTip>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <optional>
+
+#include "profile.h"
+
+namespace {
+
+const std::int64_t UnixJulianDay = 2440588;     // dzień juliański 1970-01-01
+const int CellSize = 12;
+const int CellStep = 14;
+const int LeftMargin = 36;
+const int TopMargin = 18;
+const int YearWidth = LeftMargin + 54 * CellStep + 4;
+const int YearHeight = TopMargin + 7 * CellStep + 8;
+
+// Kolory klas EAQI jak na mapie lokalizacji
+const QColor levelColors[] = {QColor(0x50f0e6), QColor(0x50ccaa), QColor(0xf0e641),
+                              QColor(0xff5050), QColor(0x960032), QColor(0x7d2181)};
+
+std::int64_t dayNumber(const QDate &date) {
+    return date.toJulianDay() - UnixJulianDay;
+}
+
+// Dzień tygodnia, poniedziałek = 0 (1970-01-01 był czwartkiem)
+int weekday(std::int64_t day) {
+    return static_cast<int>(((day + 3) % 7 + 7) % 7);
+}
+
+QPoint cellPosition(std::int64_t day, std::int64_t yearStart) {
+    const int column = static_cast<int>((day - yearStart + weekday(yearStart)) / 7);
+    return QPoint(LeftMargin + column * CellStep, TopMargin + weekday(day) * CellStep);
+}
+
+// Dzień roku year pod punktem obrazu roku
+std::optional<std::int64_t> dayAt(int year, const QPoint &position) {
+    const int x = position.x() - LeftMargin, y = position.y() - TopMargin;
+    if (x < 0 || y < 0 || x % CellStep >= CellSize || y % CellStep >= CellSize || y / CellStep >= 7) return std::nullopt;
+    const std::int64_t yearStart = dayNumber(QDate(year, 1, 1));
+    const std::int64_t day = yearStart - weekday(yearStart) + x / CellStep * 7 + y / CellStep;
+    if (day < yearStart || day >= dayNumber(QDate(year + 1, 1, 1))) return std::nullopt;
+    return day;
+}
+
+// Skala średniej dobowej od jasnożółtego, przez pomarańczowy, do ciemnoczerwonego (0 .. scaleMax)
+QColor meanColor(double fraction) {
+    static const QColor stops[] = {QColor(255, 255, 204), QColor(253, 141, 60), QColor(189, 0, 38)};
+    const double position = std::clamp(fraction, 0.0, 1.0) * 2.0;
+    const int index = std::min(static_cast<int>(position), 1);
+    const double t = position - index;
+    const QColor &a = stops[index], &b = stops[index + 1];
+    return QColor(static_cast<int>(a.red() + (b.red() - a.red()) * t), static_cast<int>(a.green() + (b.green() - a.green()) * t),
+                  static_cast<int>(a.blue() + (b.blue() - a.blue()) * t));
+}
+
+} // namespace
+
+QImage renderCalendarYear(const DailyAggregates &aggregates, int year, CalendarColoring coloring,
+                          const Pollutant *pollutant, qreal devicePixelRatio) {
+    QImage image(QSize(YearWidth, YearHeight) * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    QFont font = painter.font();
+    font.setPointSizeF(7.5);
+    painter.setFont(font);
+    painter.setPen(Qt::darkGray);
+    static const char *const weekdays[] = {"Pn", "Śr", "Pt"};
+    for (int i = 0; i < 3; ++i)
+        painter.drawText(QRect(0, TopMargin + 2 * i * CellStep, LeftMargin - 4, CellSize), Qt::AlignRight | Qt::AlignVCenter,
+                         QString::fromUtf8(weekdays[i]));
+    static const char *const months[] = {"sty", "lut", "mar", "kwi", "maj", "cze", "lip", "sie", "wrz", "paź", "lis", "gru"};
+    const std::int64_t yearStart = dayNumber(QDate(year, 1, 1));
+    for (int month = 1; month <= 12; ++month) {
+        const QPoint cell = cellPosition(dayNumber(QDate(year, month, 1)), yearStart);
+        painter.drawText(QPoint(cell.x(), TopMargin - 5), QString::fromUtf8(months[month - 1]));
+    }
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(Qt::black);
+    painter.drawText(QRect(0, 0, LeftMargin - 4, TopMargin - 4), Qt::AlignRight | Qt::AlignVCenter, QString::number(year));
+
+    const bool bands = coloring == CalendarColoring::AqiBand && pollutant && pollutant->inAqi();
+    const double scale = pollutant ? pollutant->scaleMax : 100.0;
+    const std::int64_t yearEnd = dayNumber(QDate(year + 1, 1, 1));
+    for (std::int64_t day = yearStart; day < yearEnd; ++day) {
+        const double mean = aggregates.meanOn(day);
+        QColor color(235, 235, 235);
+        if (!std::isnan(mean)) {
+            if (bands) {
+                const auto &bounds = pollutant->aqiBounds;
+                color = levelColors[std::upper_bound(bounds.begin(), bounds.end(), mean) - bounds.begin()];
+            } else {
+                color = meanColor(mean / scale);
+            }
+        }
+        painter.fillRect(QRect(cellPosition(day, yearStart), QSize(CellSize, CellSize)), color);
+    }
+    return image;
+}
+
+CalendarView::CalendarView(QWidget *parent) : QWidget(parent) {
+    setMouseTracking(true);
+}
+
+void CalendarView::setYears(const QMap<int, QImage> &newYears, const DailyAggregates *newAggregates, const QString &newUnit) {
+    years = newYears;
+    aggregates = newAggregates;
+    unit = newUnit;
+    setMinimumSize(YearWidth, static_cast<int>(years.size()) * YearHeight);
+    update();
+}
+
+void CalendarView::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+    int top = 0;
+    for (const QImage &image : std::as_const(years)) {
+        painter.drawImage(QPoint(0, top), image);
+        top += YearHeight;
+    }
+}
+
+void CalendarView::mouseMoveEvent(QMouseEvent *event) {
+    const QPoint position = event->position().toPoint();
+    const int index = position.y() / YearHeight;
+    if (!aggregates || position.y() < 0 || index >= years.size()) {
+        QToolTip::hideText();
+        return;
+    }
+    const int year = std::next(years.constBegin(), index).key();
+    const std::optional<std::int64_t> day = dayAt(year, position - QPoint(0, index * YearHeight));
+    if (!day) {
+        QToolTip::hideText();
+        return;
+    }
+
+    const QString date = QDate::fromJulianDay(*day + UnixJulianDay).toString("yyyy-MM-dd");
+    const std::uint32_t samples = aggregates->countOn(*day);
+    QToolTip::showText(event->globalPosition().toPoint(),
+                       samples == 0 ? date + "\nbrak pomiarów"
+                                    : QString("%1\nśrednia: %2%3\nmaksimum: %4%3\npomiary: %5")
+                                          .arg(date)
+                                          .arg(aggregates->meanOn(*day), 0, 'f', 1)
+                                          .arg(unit)
+                                          .arg(aggregates->maxOn(*day), 0, 'f', 1)
+                                          .arg(samples),
+                       this);
+}
+
+CalendarWindow::CalendarWindow(const LocationStore &store, QWidget *parent) : QWidget(parent, Qt::Window),
+    store(store) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    parameterSelector->setCurrentIndex(parameterSelector->findData("pm2_5"));
+    form->addRow("Parametr:", parameterSelector);
+    coloringSelector = new QComboBox();
+    coloringSelector->addItem("Średnia dobowa", static_cast<int>(CalendarColoring::DailyMean));
+    coloringSelector->addItem("Klasa EAQI średniej dobowej", static_cast<int>(CalendarColoring::AqiBand));
+    form->addRow("Kolor:", coloringSelector);
+    locationSelector = new QComboBox();
+    locationSelector->setMinimumContentsLength(30);
+    form->addRow("Lokalizacja:", locationSelector);
+    layout->addLayout(form);
+
+    summary = new QLabel();
+    layout->addWidget(summary);
+    view = new CalendarView();
+    QScrollArea *scrollArea = new QScrollArea();
+    scrollArea->setWidget(view);
+    scrollArea->setWidgetResizable(true);
+    layout->addWidget(scrollArea, 1);
+
+    connect(parameterSelector, &QComboBox::currentIndexChanged, this, [this]() { refreshLocations(locationSelector->currentText()); });
+    connect(coloringSelector, &QComboBox::currentIndexChanged, this, [this]() { refreshLocations(locationSelector->currentText()); });
+    connect(locationSelector, &QComboBox::currentIndexChanged, this, &CalendarWindow::showSelected);
+
+    setWindowTitle("Kalendarz roczny");
+    resize(YearWidth + 60, 600);
+}
+
+QString CalendarWindow::currentLocation() const {
+    return locationSelector->currentText();
+}
+
+QString CalendarWindow::entryKey(const QString &location) const {
+    return location + "/" + parameterSelector->currentData().toString() + "/" + coloringSelector->currentData().toString();
+}
+
+void CalendarWindow::refreshLocations(const QString &current) {
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+    const Pollutant *pollutant = findPollutant(parameter);
+    const auto coloring = static_cast<CalendarColoring>(coloringSelector->currentData().toInt());
+    const qreal devicePixelRatio = devicePixelRatioF();
+
+    struct Task {
+        QString key;
+        const AirQualityFrame *frame;
+        const UtcOffsetTable *zone;
+        CalendarEntry *entry;
+        int rendered;
+        int years;
+    };
+
+    // Tabele przejść budowane w wątku głównym, po jednej na strefę
+    std::map<std::string, UtcOffsetTable> zones = utcOffsetTables(store, parameter);
+
+    // Wpisy tworzone przed obliczeniami, więc wskaźniki do nich pozostają ważne w wątkach roboczych
+    std::vector<Task> tasks;
+    for (const auto &[name, frame] : store.frames())
+        if (!frame.time.empty() && frame.columns.count(parameter)) {
+            const QString key = entryKey(QString::fromStdString(name));
+            entries[key];
+            tasks.push_back({key, &frame, &zones[frame.timezone], nullptr, 0, 0});
+        }
+    for (Task &task : tasks) task.entry = &entries[task.key];
+
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(tasks, [&parameter, pollutant, coloring, devicePixelRatio](Task &task) {
+        DailyAggregates updated = dailyAggregates(task.frame->time, task.frame->columns.at(parameter), *task.zone);
+        QMap<int, QImage> years;
+        if (updated.days() > 0) {
+            const int firstYear = QDate::fromJulianDay(updated.firstDay + UnixJulianDay).year();
+            const int lastYear = QDate::fromJulianDay(updated.lastDay() + UnixJulianDay).year();
+            for (int year = firstYear; year <= lastYear; ++year) {
+                // Obraz roku pozostaje ważny, dopóki nie zmienią się agregaty żadnego z jego dni
+                auto cached = task.entry->years.constFind(year);
+                if (cached != task.entry->years.constEnd()
+                    && task.entry->aggregates.sameDays(updated, dayNumber(QDate(year, 1, 1)), dayNumber(QDate(year + 1, 1, 1)))) {
+                    years.insert(year, *cached);
+                } else {
+                    years.insert(year, renderCalendarYear(updated, year, coloring, pollutant, devicePixelRatio));
+                    ++task.rendered;
+                }
+            }
+        }
+        task.years = static_cast<int>(years.size());
+        task.entry->aggregates = std::move(updated);
+        task.entry->years = std::move(years);
+    });
+
+    int rendered = 0, years = 0;
+    QStringList names;
+    for (const Task &task : tasks) {
+        rendered += task.rendered;
+        years += task.years;
+        names.append(QString::fromStdString(task.frame->location));
+    }
+    QString text = QString("Lokalizacje: %1, narysowane lata: %2 z %3 (%4 ms)")
+                       .arg(tasks.size()).arg(rendered).arg(years).arg(timer.elapsed());
+    if (coloring == CalendarColoring::AqiBand && !(pollutant && pollutant->inAqi()))
+        text += " - parametr spoza indeksu EAQI, kolor według średniej dobowej";
+    summary->setText(text);
+
+    {
+        QSignalBlocker blocker(locationSelector);
+        locationSelector->clear();
+        locationSelector->addItems(names);
+        const int index = locationSelector->findText(current);
+        locationSelector->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    showSelected();
+}
+
+void CalendarWindow::showSelected() {
+    auto it = entries.constFind(entryKey(locationSelector->currentText()));
+    if (it == entries.constEnd()) {
+        view->setYears({}, nullptr, QString());
+        return;
+    }
+    const Pollutant *pollutant = findPollutant(parameterSelector->currentData().toString().toStdString());
+    const QString unit = pollutant && *pollutant->unit ? " " + QString::fromUtf8(pollutant->unit) : QString();
+    view->setYears(it->years, &it->aggregates, unit);
+}
@@ -0,0 +1,81 @@
+#ifndef CALENDARWINDOW_H
+#define CALENDARWINDOW_H
+
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QWidget>
+
+#include "airqualityframe.h"
+#include "calendar.h"
+#include "pollutants.h"
+
+class QComboBox;
+class QLabel;
+
+enum class CalendarColoring { DailyMean, AqiBand };
+
+// Obraz kalendarza jednego roku (tygodnie w kolumnach, dni tygodnia w wierszach); rysowanie tylko
+// przez QImage i QPainter, więc może odbywać się w wątku roboczym
+QImage renderCalendarYear(const DailyAggregates &aggregates, int year, CalendarColoring coloring,
+                          const Pollutant *pollutant, qreal devicePixelRatio);
+
+/*!
+ * \brief Widżet kolejnych lat kalendarza: gotowe obrazy lat jeden pod drugim
+ * \details Podpowiedź pod kursorem podaje datę, średnią i maksimum dnia oraz liczbę pomiarów.
+ */
+class CalendarView : public QWidget {
+public:
+    explicit CalendarView(QWidget *parent = nullptr);
+
+    // Obrazy lat (rosnąco) i agregaty, z których powstały; aggregates musi pozostać ważne do następnego wywołania
+    void setYears(const QMap<int, QImage> &years, const DailyAggregates *aggregates, const QString &unit);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+    QMap<int, QImage> years;
+    const DailyAggregates *aggregates = nullptr;
+    QString unit;
+};
+
+/*!
+ * \brief Okno kalendarza rocznego: jedna komórka na dzień, kolor według średniej dobowej lub klasy EAQI
+ * \details Agregaty dobowe (w czasie lokalnym lokalizacji) liczone są równolegle dla wszystkich
+ * lokalizacji magazynu, a każdy rok rysowany jest do osobnego obrazu. Przy ponownym obliczeniu
+ * obraz roku jest rysowany od nowa tylko wtedy, gdy zmieniły się agregaty któregoś z jego dni,
+ * więc zmiana lokalizacji sprowadza się do skopiowania gotowych obrazów.
+ */
+class CalendarWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CalendarWindow(const LocationStore &store, QWidget *parent = nullptr);
+
+    // Ponowne obliczenie agregatów po zmianie magazynu; current - lokalizacja wybrana po odświeżeniu
+    void refreshLocations(const QString &current = QString());
+    QString currentLocation() const;
+
+private slots:
+    void showSelected();
+
+private:
+    struct CalendarEntry {
+        DailyAggregates aggregates;
+        QMap<int, QImage> years;
+    };
+
+    QString entryKey(const QString &location) const;
+
+    const LocationStore &store;
+    QComboBox *parameterSelector;
+    QComboBox *coloringSelector;
+    QComboBox *locationSelector;
+    QLabel *summary;
+    CalendarView *view;
+    QHash<QString, CalendarEntry> entries;     // klucz "lokalizacja/parametr/tryb"
+};
+
+#endif // CALENDARWINDOW_H
@@ -0,0 +1,221 @@
+#include "columnarexporter.h"
+
+#include "arrowipcwriter.h"
+#include "pollutants.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <set>
+
+namespace {
+
+// Partia wierszy o stałej maksymalnej liczbie wierszy, przechowywana kolumnowo
+struct ExportBatch {
+    size_t rows = 0;
+    std::string locationData;
+    std::vector<std::int32_t> locationOffsets{0};
+    std::vector<std::int64_t> time;
+    std::vector<std::vector<double>> values;
+
+    void clear() {
+        rows = 0;
+        locationData.clear();
+        locationOffsets.assign(1, 0);
+        time.clear();
+        for (auto &column : values) column.clear();
+    }
+};
+
+class BatchSink {
+public:
+    virtual ~BatchSink() = default;
+    virtual void write(const ExportBatch &batch) = 0;
+    virtual void finish() = 0;
+};
+
+class CsvSink : public BatchSink {
+public:
+    CsvSink(std::ostream &out, const std::vector<std::string> &names) : out(out) {
+        out << "location,time";
+        for (const auto &name : names) out << ',' << name;
+        out << '\n';
+    }
+
+    void write(const ExportBatch &batch) override {
+        buffer.clear();
+        char number[32];
+        for (size_t r = 0; r < batch.rows; ++r) {
+            appendLocation(std::string_view(batch.locationData).substr(
+                batch.locationOffsets[r], batch.locationOffsets[r + 1] - batch.locationOffsets[r]));
+            buffer.push_back(',');
+            buffer.append(number, formatIsoTimestamp(batch.time[r], number));
+            for (const auto &column : batch.values) {
+                buffer.push_back(',');
+                if (std::isnan(column[r])) continue;
+                auto result = std::to_chars(number, number + sizeof(number), column[r]);
+                buffer.append(number, result.ptr);
+            }
+            buffer.push_back('\n');
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    void finish() override { out.flush(); }
+
+private:
+    std::ostream &out;
+    std::string buffer;
+
+    void appendLocation(std::string_view location) {
+        if (location.find_first_of(",\"\n") == std::string_view::npos) {
+            buffer.append(location);
+            return;
+        }
+        buffer.push_back('"');
+        for (char c : location) {
+            if (c == '"') buffer.push_back('"');
+            buffer.push_back(c);
+        }
+        buffer.push_back('"');
+    }
+};
+
+class ArrowSink : public BatchSink {
+public:
+    ArrowSink(std::ostream &out, const std::vector<std::string> &names)
+        : writer(out), validity(names.size()), narrowed(names.size()) {
+        std::vector<ArrowIpcWriter::Column> columns = {
+            {"location", ArrowIpcWriter::ColumnType::Utf8},
+            {"time", ArrowIpcWriter::ColumnType::TimestampSeconds},
+        };
+        // Typ kolumny parametru z tabeli parametrów; pozostałe kolumny (np. pogodowe) jako float64
+        for (const auto &name : names) {
+            const Pollutant *pollutant = findPollutant(name);
+            const bool single = pollutant && pollutant->storage == ColumnStorage::Float32;
+            singlePrecision.push_back(single);
+            columns.push_back({name, single ? ArrowIpcWriter::ColumnType::Float32 : ArrowIpcWriter::ColumnType::Float64});
+        }
+        writer.writeSchema(columns);
+    }
+
+    void write(const ExportBatch &batch) override {
+        const auto length = static_cast<std::int64_t>(batch.rows);
+        std::vector<ArrowIpcWriter::ColumnData> columns(2 + batch.values.size());
+        columns[0].offsets = batch.locationOffsets.data();
+        columns[0].values = batch.locationData.data();
+        columns[1].values = batch.time.data();
+        columns[1].valueBytes = batch.rows * sizeof(std::int64_t);
+
+        // NaN zapisywany jest jako null: bit ważności ustawiony tylko dla zmierzonych wartości
+        for (size_t c = 0; c < batch.values.size(); ++c) {
+            const std::vector<double> &values = batch.values[c];
+            std::vector<std::uint8_t> &bitmap = validity[c];
+            bitmap.assign((batch.rows + 7) / 8, 0);
+            std::int64_t nullCount = 0;
+            for (size_t r = 0; r < batch.rows; ++r) {
+                if (std::isnan(values[r])) ++nullCount;
+                else bitmap[r >> 3] |= static_cast<std::uint8_t>(1u << (r & 7));
+            }
+            ArrowIpcWriter::ColumnData &column = columns[2 + c];
+            column.validity = nullCount ? bitmap.data() : nullptr;
+            column.nullCount = nullCount;
+            if (singlePrecision[c]) {
+                narrowed[c].assign(values.begin(), values.begin() + batch.rows);
+                column.values = narrowed[c].data();
+                column.valueBytes = batch.rows * sizeof(float);
+            } else {
+                column.values = values.data();
+                column.valueBytes = batch.rows * sizeof(double);
+            }
+        }
+        writer.writeBatch(length, columns);
+    }
+
+    void finish() override { writer.finish(); }
+
+private:
+    ArrowIpcWriter writer;
+    std::vector<std::vector<std::uint8_t>> validity;
+    std::vector<bool> singlePrecision;
+    std::vector<std::vector<float>> narrowed;
+};
+
+} // namespace
+
+ColumnarExporter::Format ColumnarExporter::formatForFile(const std::string &fileName) {
+    const size_t dot = fileName.find_last_of('.');
+    std::string extension = dot == std::string::npos ? std::string() : fileName.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == "arrow" || extension == "feather" || extension == "ipc" ? Format::ArrowIpc : Format::Csv;
+}
+
+bool ColumnarExporter::exportStore(const LocationStore &store, const std::string &fileName, Format format,
+                                   std::string &error, size_t batchRows) {
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.is_open()) {
+        error = "Nie można otworzyć pliku do zapisu";
+        return false;
+    }
+    batchRows = std::max<size_t>(batchRows, 1);
+
+    std::set<std::string> nameSet;
+    for (const auto &item : store.frames())
+        for (const auto &column : item.second.columns) nameSet.insert(column.first);
+    const std::vector<std::string> names(nameSet.begin(), nameSet.end());
+
+    std::unique_ptr<BatchSink> sink;
+    if (format == Format::ArrowIpc) sink = std::make_unique<ArrowSink>(file, names);
+    else sink = std::make_unique<CsvSink>(file, names);
+
+    ExportBatch batch;
+    batch.values.resize(names.size());
+    batch.time.reserve(batchRows);
+    batch.locationOffsets.reserve(batchRows + 1);
+    for (auto &column : batch.values) column.reserve(batchRows);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (const auto &[location, frame] : store.frames()) {
+        std::vector<const std::vector<double> *> sources;
+        for (const auto &name : names) {
+            auto it = frame.columns.find(name);
+            sources.push_back(it != frame.columns.end() ? &it->second : nullptr);
+        }
+
+        // Kopiowanie wycinków kolumn serii do partii, aż do jej zapełnienia
+        for (size_t row = 0; row < frame.size();) {
+            const size_t take = std::min(frame.size() - row, batchRows - batch.rows);
+            batch.time.insert(batch.time.end(), frame.time.begin() + row, frame.time.begin() + row + take);
+            for (size_t c = 0; c < names.size(); ++c) {
+                if (sources[c])
+                    batch.values[c].insert(batch.values[c].end(), sources[c]->begin() + row,
+                                           sources[c]->begin() + row + take);
+                else
+                    batch.values[c].insert(batch.values[c].end(), take, nan);
+            }
+            for (size_t i = 0; i < take; ++i) {
+                batch.locationData += location;
+                batch.locationOffsets.push_back(static_cast<std::int32_t>(batch.locationData.size()));
+            }
+            batch.rows += take;
+            row += take;
+
+            if (batch.rows == batchRows) {
+                sink->write(batch);
+                batch.clear();
+            }
+        }
+    }
+    if (batch.rows > 0) sink->write(batch);
+    sink->finish();
+
+    if (!file.good()) {
+        error = "Błąd zapisu pliku";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,25 @@
+#ifndef COLUMNAREXPORTER_H
+#define COLUMNAREXPORTER_H
+
+#include <string>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Eksport lokalnego magazynu do formatów kolumnowych (CSV, Arrow IPC / Feather)
+ * \details Dane zapisywane są w "długiej" tabeli location, time, <parametry>, partiami o stałej
+ * liczbie wierszy kopiowanymi bezpośrednio z kolumn serii, więc zużycie pamięci nie zależy
+ * od rozmiaru archiwum. Brak pomiaru zapisywany jest jako puste pole (CSV) lub null (Arrow).
+ */
+class ColumnarExporter {
+public:
+    enum class Format { Csv, ArrowIpc };
+
+    // Format na podstawie rozszerzenia: .arrow, .feather, .ipc - Arrow, pozostałe - CSV
+    static Format formatForFile(const std::string &fileName);
+
+    static bool exportStore(const LocationStore &store, const std::string &fileName, Format format,
+                            std::string &error, size_t batchRows = 65536);
+};
+
+#endif // COLUMNAREXPORTER_H
@@ -0,0 +1,169 @@
+#include "correlation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+const size_t Lanes = 8;
+
+// Sumy jednej pary kolumn potrzebne do współczynnika Pearsona przy brakach liczonych parami
+struct PairSums {
+    double n = 0, sx = 0, sy = 0, sxx = 0, syy = 0, sxy = 0;
+};
+
+} // namespace
+
+void CorrelationMatrix::build(const std::vector<CorrelationInput> &inputs, std::int64_t bucketSeconds) {
+    labelList.clear();
+    tileList.clear();
+    rowCount = 0;
+
+    std::int64_t first = std::numeric_limits<std::int64_t>::max(), last = std::numeric_limits<std::int64_t>::min();
+    for (const CorrelationInput &input : inputs) {
+        labelList.push_back(input.label);
+        if (input.time->empty()) continue;
+        first = std::min(first, input.time->front());
+        last = std::max(last, input.time->back());
+    }
+    const size_t columns = labelList.size();
+    auto bucketOf = [&](std::int64_t t) { return static_cast<size_t>((t - first) / bucketSeconds); };
+    if (first <= last) {
+        first -= ((first % bucketSeconds) + bucketSeconds) % bucketSeconds;
+        rowCount = bucketOf(last) + 1;
+    }
+    stride = (rowCount + BlockRows - 1) / BlockRows * BlockRows;
+
+    values.assign(columns * stride, 0.0f);
+    squares.assign(columns * stride, 0.0f);
+    masks.assign(columns * stride, 0.0f);
+
+    // Średnie w przedziałach, następnie standaryzacja kolumny po jej własnych pomiarach
+    std::vector<double> sums(rowCount);
+    std::vector<std::uint32_t> counts(rowCount);
+    for (size_t c = 0; c < columns; ++c) {
+        const std::vector<std::int64_t> &time = *inputs[c].time;
+        const std::vector<double> &column = *inputs[c].values;
+        std::fill(sums.begin(), sums.end(), 0.0);
+        std::fill(counts.begin(), counts.end(), 0u);
+        for (size_t i = 0; i < std::min(time.size(), column.size()); ++i) {
+            if (std::isnan(column[i])) continue;
+            const size_t bucket = bucketOf(time[i]);
+            sums[bucket] += column[i];
+            ++counts[bucket];
+        }
+
+        double total = 0.0, totalSquares = 0.0;
+        size_t present = 0;
+        for (size_t r = 0; r < rowCount; ++r) {
+            if (!counts[r]) continue;
+            sums[r] /= counts[r];
+            total += sums[r];
+            totalSquares += sums[r] * sums[r];
+            ++present;
+        }
+        if (present < 2) continue;
+        const double mean = total / present;
+        const double deviation = std::sqrt(std::max(0.0, totalSquares / present - mean * mean));
+        if (!(deviation > 0)) continue;
+
+        float *x = values.data() + c * stride, *x2 = squares.data() + c * stride, *m = masks.data() + c * stride;
+        for (size_t r = 0; r < rowCount; ++r) {
+            if (!counts[r]) continue;
+            x[r] = static_cast<float>((sums[r] - mean) / deviation);
+            x2[r] = x[r] * x[r];
+            m[r] = 1.0f;
+        }
+    }
+
+    for (size_t i = 0; i < columns; i += TileColumns)
+        for (size_t j = i; j < columns; j += TileColumns) tileList.emplace_back(i, j);
+    correlation.assign(columns * columns, std::numeric_limits<double>::quiet_NaN());
+    overlapCount.assign(columns * columns, 0);
+}
+
+void CorrelationMatrix::computeTile(size_t tile) {
+    const size_t columns = labelList.size();
+    const size_t i0 = tileList[tile].first, j0 = tileList[tile].second;
+    const size_t i1 = std::min(i0 + TileColumns, columns), j1 = std::min(j0 + TileColumns, columns);
+    std::vector<PairSums> sums(TileColumns * TileColumns);
+
+    // Blok wierszy wszystkich kolumn kafelka mieści się w pamięci podręcznej; częściowe sumy
+    // w pojedynczej precyzji (osobno dla każdego toru, więc pętla jest wektoryzowana) dodawane są
+    // do sum w podwójnej precyzji po każdym bloku
+    for (size_t begin = 0; begin < stride; begin += BlockRows) {
+        for (size_t i = i0; i < i1; ++i) {
+            const float *xi = values.data() + i * stride + begin;
+            const float *x2i = squares.data() + i * stride + begin;
+            const float *mi = masks.data() + i * stride + begin;
+            for (size_t j = std::max(j0, i0 == j0 ? i : j0); j < j1; ++j) {
+                const float *xj = values.data() + j * stride + begin;
+                const float *x2j = squares.data() + j * stride + begin;
+                const float *mj = masks.data() + j * stride + begin;
+                float n[Lanes] = {}, sx[Lanes] = {}, sy[Lanes] = {}, sxx[Lanes] = {}, syy[Lanes] = {}, sxy[Lanes] = {};
+                for (size_t r = 0; r < BlockRows; r += Lanes) {
+                    for (size_t k = 0; k < Lanes; ++k) {
+                        n[k] += mi[r + k] * mj[r + k];
+                        sx[k] += xi[r + k] * mj[r + k];
+                        sy[k] += mi[r + k] * xj[r + k];
+                        sxx[k] += x2i[r + k] * mj[r + k];
+                        syy[k] += mi[r + k] * x2j[r + k];
+                        sxy[k] += xi[r + k] * xj[r + k];
+                    }
+                }
+                PairSums &pair = sums[(i - i0) * TileColumns + (j - j0)];
+                for (size_t k = 0; k < Lanes; ++k) {
+                    pair.n += n[k];
+                    pair.sx += sx[k];
+                    pair.sy += sy[k];
+                    pair.sxx += sxx[k];
+                    pair.syy += syy[k];
+                    pair.sxy += sxy[k];
+                }
+            }
+        }
+    }
+
+    for (size_t i = i0; i < i1; ++i) {
+        for (size_t j = std::max(j0, i0 == j0 ? i : j0); j < j1; ++j) {
+            const PairSums &pair = sums[(i - i0) * TileColumns + (j - j0)];
+            const size_t count = static_cast<size_t>(std::llround(pair.n));
+            double r = std::numeric_limits<double>::quiet_NaN();
+            const double varianceX = pair.n * pair.sxx - pair.sx * pair.sx;
+            const double varianceY = pair.n * pair.syy - pair.sy * pair.sy;
+            if (count >= MinOverlap && varianceX > 0 && varianceY > 0)
+                r = std::clamp((pair.n * pair.sxy - pair.sx * pair.sy) / std::sqrt(varianceX * varianceY), -1.0, 1.0);
+            correlation[i * columns + j] = correlation[j * columns + i] = r;
+            overlapCount[i * columns + j] = overlapCount[j * columns + i] = static_cast<std::uint32_t>(count);
+        }
+    }
+}
+
+bool CorrelationMatrix::exportCsv(const std::string &fileName) const {
+    std::ofstream file(fileName);
+    if (!file.is_open()) return false;
+
+    // Etykiety w cudzysłowach - nazwy lokalizacji zawierają przecinki
+    auto quoted = [](const std::string &text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    };
+    file << "\"\"";
+    for (const std::string &label : labelList) file << ';' << quoted(label);
+    file << '\n';
+    for (size_t i = 0; i < labelList.size(); ++i) {
+        file << quoted(labelList[i]);
+        for (size_t j = 0; j < labelList.size(); ++j) {
+            file << ';';
+            if (!std::isnan(at(i, j))) file << at(i, j);
+        }
+        file << '\n';
+    }
+    return file.good();
+}
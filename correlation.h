@@ -0,0 +1,61 @@
+#ifndef CORRELATION_H
+#define CORRELATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Seria wejściowa macierzy korelacji: oś czasu i wartości (NaN - brak pomiaru)
+struct CorrelationInput {
+    std::string label;
+    const std::vector<std::int64_t> *time;
+    const std::vector<double> *values;
+};
+
+/*!
+ * \brief Macierz korelacji Pearsona wielu serii wyrównanych na wspólnej osi czasu
+ * \details Serie uśredniane są do przedziałów o długości bucketSeconds na wspólnej osi, a każda
+ * kolumna standaryzowana (średnia 0, odchylenie 1), co poprawia dokładność sum w pojedynczej
+ * precyzji. Braki obsługiwane są parami: dla każdej pary kolumn sumy liczone są tylko z wierszy,
+ * w których obie mają pomiar, co sprowadza się do iloczynów macierzy wartości (z zerami w lukach)
+ * i macierzy masek. Iloczyn liczony jest kafelkami kolumn i blokami wierszy mieszczącymi się
+ * w pamięci podręcznej; kafelki (tylko nad przekątną) są niezależne, więc mogą być liczone
+ * równolegle przez computeTile.
+ */
+class CorrelationMatrix {
+public:
+    void build(const std::vector<CorrelationInput> &inputs, std::int64_t bucketSeconds = 3600);
+
+    // Pary kafelków (pierwsza kolumna wierszy, pierwsza kolumna kolumn) do policzenia
+    const std::vector<std::pair<size_t, size_t>> &tiles() const { return tileList; }
+    // Bezpieczne do wywołania równolegle dla różnych kafelków
+    void computeTile(size_t tile);
+
+    size_t size() const { return labelList.size(); }
+    size_t rows() const { return rowCount; }
+    const std::vector<std::string> &labels() const { return labelList; }
+    // Współczynnik korelacji (NaN, gdy wspólnych pomiarów jest mniej niż MinOverlap) i ich liczba
+    double at(size_t i, size_t j) const { return correlation[i * labelList.size() + j]; }
+    size_t overlap(size_t i, size_t j) const { return overlapCount[i * labelList.size() + j]; }
+
+    bool exportCsv(const std::string &fileName) const;
+
+    static const size_t MinOverlap = 24;
+    static const size_t TileColumns = 32;
+    static const size_t BlockRows = 256;
+
+private:
+    std::vector<std::string> labelList;
+    size_t rowCount = 0;
+    size_t stride = 0;               // długość kolumny w buforach (wielokrotność BlockRows)
+    std::vector<float> values;       // wartości standaryzowane, 0 w lukach
+    std::vector<float> squares;      // kwadraty wartości
+    std::vector<float> masks;        // 1 - pomiar, 0 - luka
+    std::vector<std::pair<size_t, size_t>> tileList;
+    std::vector<double> correlation;
+    std::vector<std::uint32_t> overlapCount;
+};
+
+#endif // CORRELATION_H
@@ -0,0 +1,191 @@
+#include "correlationwindow.h"
+
+#include <QApplication>
+#include <QComboBox>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPushButton>
+#include <QToolTip>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrent>
+
+#include <cmath>
+#include <numeric>
+
+#include "pollutants.h"
+
+namespace {
+
+// Skala rozbieżna: -1 niebieski, 0 biały, 1 czerwony; brak wartości szary
+QRgb correlationColor(double r) {
+    if (std::isnan(r)) return qRgb(200, 200, 200);
+    const int fade = static_cast<int>(std::round(255 * (1.0 - std::abs(r))));
+    return r >= 0 ? qRgb(255, fade, fade) : qRgb(fade, fade, 255);
+}
+
+} // namespace
+
+CorrelationView::CorrelationView(QWidget *parent) : QWidget(parent) {
+    setMinimumSize(400, 400);
+    setMouseTracking(true);
+}
+
+void CorrelationView::setMatrix(const CorrelationMatrix *newMatrix) {
+    matrix = newMatrix;
+    image = QImage();
+    if (matrix && matrix->size() > 0) {
+        const int n = static_cast<int>(matrix->size());
+        image = QImage(n, n, QImage::Format_RGB32);
+        for (int i = 0; i < n; ++i) {
+            QRgb *line = reinterpret_cast<QRgb *>(image.scanLine(i));
+            for (int j = 0; j < n; ++j) line[j] = correlationColor(matrix->at(i, j));
+        }
+    }
+    update();
+}
+
+QRect CorrelationView::matrixRect() const {
+    const int side = std::min(width(), height());
+    return QRect((width() - side) / 2, (height() - side) / 2, side, side);
+}
+
+void CorrelationView::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+    if (image.isNull()) return;
+
+    const QRect target = matrixRect();
+    painter.drawImage(target, image);
+
+    // Przy niewielkiej macierzy wartości wpisywane są w komórki
+    const int n = image.width();
+    const double cell = static_cast<double>(target.width()) / n;
+    if (cell < 28) return;
+    painter.setPen(Qt::black);
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j) {
+            const QRectF box(target.left() + j * cell, target.top() + i * cell, cell, cell);
+            const double r = matrix->at(i, j);
+            painter.drawText(box, Qt::AlignCenter, std::isnan(r) ? "-" : QString::number(r, 'f', 2));
+        }
+}
+
+void CorrelationView::mouseMoveEvent(QMouseEvent *event) {
+    if (image.isNull()) return;
+    const QRect target = matrixRect();
+    const QPoint position = event->position().toPoint();
+    if (!target.contains(position)) {
+        QToolTip::hideText();
+        return;
+    }
+
+    const int n = image.width();
+    const int j = std::min(n - 1, (position.x() - target.left()) * n / target.width());
+    const int i = std::min(n - 1, (position.y() - target.top()) * n / target.height());
+    const double r = matrix->at(i, j);
+    QToolTip::showText(event->globalPosition().toPoint(),
+                       QString("%1\n%2\nr = %3 (wspólnych godzin: %4)")
+                           .arg(QString::fromStdString(matrix->labels()[i]), QString::fromStdString(matrix->labels()[j]),
+                                std::isnan(r) ? QString("brak") : QString::number(r, 'f', 3))
+                           .arg(matrix->overlap(i, j)),
+                       this);
+}
+
+CorrelationWindow::CorrelationWindow(const LocationStore &store, QWidget *parent) : QWidget(parent, Qt::Window),
+    store(store) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    modeSelector = new QComboBox();
+    modeSelector->addItem("Jeden parametr - wszystkie lokalizacje");
+    modeSelector->addItem("Wszystkie parametry - jedna lokalizacja");
+    form->addRow("Macierz:", modeSelector);
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    form->addRow("Parametr:", parameterSelector);
+    locationSelector = new QComboBox();
+    locationSelector->setMinimumContentsLength(30);
+    locationSelector->setEnabled(false);
+    form->addRow("Lokalizacja:", locationSelector);
+    layout->addLayout(form);
+
+    QHBoxLayout *buttons = new QHBoxLayout();
+    QPushButton *computeButton = new QPushButton("Oblicz");
+    QPushButton *exportButton = new QPushButton("Eksportuj CSV");
+    buttons->addWidget(computeButton);
+    buttons->addWidget(exportButton);
+    layout->addLayout(buttons);
+
+    summary = new QLabel();
+    layout->addWidget(summary);
+    view = new CorrelationView();
+    layout->addWidget(view, 1);
+
+    connect(modeSelector, &QComboBox::currentIndexChanged, this, [this](int mode) {
+        parameterSelector->setEnabled(mode == 0);
+        locationSelector->setEnabled(mode == 1);
+    });
+    connect(computeButton, &QPushButton::clicked, this, &CorrelationWindow::compute);
+    connect(exportButton, &QPushButton::clicked, this, &CorrelationWindow::exportMatrix);
+
+    setWindowTitle("Macierz korelacji");
+    resize(800, 900);
+}
+
+void CorrelationWindow::refreshLocations(const QString &current) {
+    locationSelector->clear();
+    for (const auto &item : store.frames())
+        locationSelector->addItem(QString::fromStdString(item.first));
+    locationSelector->setCurrentIndex(std::max(0, locationSelector->findText(current)));
+}
+
+void CorrelationWindow::compute() {
+    std::vector<CorrelationInput> inputs;
+    if (modeSelector->currentIndex() == 0) {
+        const std::string parameter = parameterSelector->currentData().toString().toStdString();
+        for (const auto &[location, frame] : store.frames()) {
+            auto column = frame.columns.find(parameter);
+            if (column != frame.columns.end()) inputs.push_back({location, &frame.time, &column->second});
+        }
+    } else if (const AirQualityFrame *frame = store.find(locationSelector->currentText().toStdString())) {
+        for (const auto &[name, column] : frame->columns) inputs.push_back({name, &frame->time, &column});
+    }
+    if (inputs.size() < 2) {
+        QMessageBox::warning(this, "Błąd", "Do macierzy korelacji potrzebne są co najmniej dwie serie");
+        return;
+    }
+
+    view->setMatrix(nullptr);
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    matrix.build(inputs);
+    std::vector<size_t> tiles(matrix.tiles().size());
+    std::iota(tiles.begin(), tiles.end(), 0);
+    QtConcurrent::blockingMap(tiles, [this](size_t tile) { matrix.computeTile(tile); });
+    const qint64 elapsed = timer.elapsed();
+    QApplication::restoreOverrideCursor();
+
+    summary->setText(QString("%1 serii, %2 godzin, %3 kafelków - %4 ms")
+                         .arg(matrix.size()).arg(matrix.rows()).arg(tiles.size()).arg(elapsed));
+    view->setMatrix(&matrix);
+}
+
+void CorrelationWindow::exportMatrix() {
+    if (matrix.size() == 0) {
+        QMessageBox::warning(this, "Błąd", "Najpierw oblicz macierz");
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(this, "Zapisz macierz korelacji", "correlation.csv", "CSV (*.csv)");
+    if (fileName.isEmpty()) return;
+    if (!matrix.exportCsv(fileName.toStdString()))
+        QMessageBox::warning(this, "Błąd", "Nie można zapisać pliku.");
+}
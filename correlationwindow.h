@@ -0,0 +1,64 @@
+#ifndef CORRELATIONWINDOW_H
+#define CORRELATIONWINDOW_H
+
+#include <QImage>
+#include <QWidget>
+
+#include "airqualityframe.h"
+#include "correlation.h"
+
+class QComboBox;
+class QLabel;
+
+/*!
+ * \brief Widżet mapy cieplnej macierzy korelacji (od -1 niebieski, przez 0 biały, do 1 czerwony)
+ * \details Jeden piksel obrazu odpowiada jednej parze serii; obraz skalowany jest do rozmiaru
+ * widżetu bez wygładzania. Podpowiedź pod kursorem podaje nazwy serii, współczynnik i liczbę
+ * wspólnych pomiarów.
+ */
+class CorrelationView : public QWidget {
+public:
+    explicit CorrelationView(QWidget *parent = nullptr);
+
+    void setMatrix(const CorrelationMatrix *matrix);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+
+private:
+    QRect matrixRect() const;
+
+    const CorrelationMatrix *matrix = nullptr;
+    QImage image;
+};
+
+/*!
+ * \brief Okno macierzy korelacji: jeden parametr między lokalizacjami lub parametry jednej lokalizacji
+ * \details Serie z magazynu wyrównywane są do średnich godzinowych, a kafelki macierzy liczone
+ * równolegle. Macierz można zapisać do pliku CSV.
+ */
+class CorrelationWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CorrelationWindow(const LocationStore &store, QWidget *parent = nullptr);
+
+    // Odświeżenie listy lokalizacji po zmianie magazynu
+    void refreshLocations(const QString &current = QString());
+
+private slots:
+    void compute();
+    void exportMatrix();
+
+private:
+    const LocationStore &store;
+    QComboBox *modeSelector;
+    QComboBox *parameterSelector;
+    QComboBox *locationSelector;
+    QLabel *summary;
+    CorrelationView *view;
+    CorrelationMatrix matrix;
+};
+
+#endif // CORRELATIONWINDOW_H
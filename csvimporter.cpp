@@ -0,0 +1,354 @@
+#include "csvimporter.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+enum class ColumnRole { Location, Time, Latitude, Longitude, Value, Ignored };
+
+struct CsvSchema {
+    char delimiter = ',';
+    bool decimalComma = false;
+    bool hasLocation = false;
+    bool hasTime = false;
+    std::vector<ColumnRole> roles;
+    std::vector<int> valueSlot;
+    std::vector<std::string> valueNames;
+};
+
+// Wiersze jednej lokalizacji z jednego fragmentu pliku; wartości zapisane wierszami
+struct LocationRows {
+    std::vector<std::int64_t> time;
+    std::vector<double> values;
+    double latitude = NaN;
+    double longitude = NaN;
+};
+
+struct ChunkTask {
+    const char *begin = nullptr;
+    const char *end = nullptr;
+    std::vector<std::pair<std::string, LocationRows>> locations;
+    size_t rows = 0;
+    size_t rejected = 0;
+};
+
+struct LocationGroup {
+    std::string location;
+    std::vector<const LocationRows *> parts;
+    AirQualityFrame frame;
+};
+
+std::string_view trimField(std::string_view field) {
+    auto isSpace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+    while (!field.empty() && isSpace(field.front())) field.remove_prefix(1);
+    while (!field.empty() && isSpace(field.back())) field.remove_suffix(1);
+    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+        field.remove_prefix(1);
+        field.remove_suffix(1);
+    }
+    return field;
+}
+
+// Zwraca koniec pola zaczynającego się w pos, pomijając separatory wewnątrz cudzysłowów
+const char *fieldEnd(const char *pos, const char *lineEnd, char delimiter) {
+    if (pos < lineEnd && *pos == '"') {
+        for (++pos; pos < lineEnd; ++pos) {
+            if (*pos != '"') continue;
+            if (pos + 1 < lineEnd && pos[1] == '"') { ++pos; continue; }
+            ++pos;
+            break;
+        }
+    }
+    const void *hit = std::memchr(pos, delimiter, lineEnd - pos);
+    return hit ? static_cast<const char *>(hit) : lineEnd;
+}
+
+double parseNumber(std::string_view field, bool decimalComma) {
+    field = trimField(field);
+    if (field.empty()) return NaN;
+
+    char buffer[64];
+    if (decimalComma && field.size() < sizeof(buffer)) {
+        std::memcpy(buffer, field.data(), field.size());
+        std::replace(buffer, buffer + field.size(), ',', '.');
+        field = std::string_view(buffer, field.size());
+    }
+    if (field.front() == '+') field.remove_prefix(1);
+
+    double value;
+    const char *last = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), last, value);
+    return ec == std::errc() && ptr == last ? value : NaN;
+}
+
+// Ujednolica nazwę kolumny: małe litery, bez jednostki, podkreślenia zamiast spacji i kropek
+std::string normalizeHeader(std::string_view field) {
+    field = trimField(field);
+    const size_t unit = field.find_first_of("[(");
+    if (unit != std::string_view::npos) field = trimField(field.substr(0, unit));
+
+    std::string name;
+    name.reserve(field.size());
+    for (char c : field) {
+        if (c == ' ' || c == '.' || c == '-') c = '_';
+        else if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        name.push_back(c);
+    }
+    return name;
+}
+
+ColumnRole roleForHeader(const std::string &name) {
+    static const std::unordered_map<std::string, ColumnRole> roles = {
+        {"location", ColumnRole::Location}, {"station", ColumnRole::Location},
+        {"station_code", ColumnRole::Location}, {"stacja", ColumnRole::Location},
+        {"kod_stacji", ColumnRole::Location}, {"site", ColumnRole::Location},
+        {"time", ColumnRole::Time}, {"datetime", ColumnRole::Time}, {"date_time", ColumnRole::Time},
+        {"date", ColumnRole::Time}, {"timestamp", ColumnRole::Time}, {"data", ColumnRole::Time},
+        {"czas", ColumnRole::Time},
+        {"latitude", ColumnRole::Latitude}, {"lat", ColumnRole::Latitude},
+        {"longitude", ColumnRole::Longitude}, {"lon", ColumnRole::Longitude}, {"lng", ColumnRole::Longitude},
+    };
+    auto it = roles.find(name);
+    return it != roles.end() ? it->second : ColumnRole::Value;
+}
+
+// Nazwy parametrów z eksportów sieci pomiarowych sprowadzane do nazw Open-Meteo
+std::string parameterName(const std::string &name) {
+    static const std::unordered_map<std::string, std::string> aliases = {
+        {"pm25", "pm2_5"}, {"no2", "nitrogen_dioxide"}, {"o3", "ozone"},
+        {"so2", "sulphur_dioxide"}, {"co", "carbon_monoxide"},
+    };
+    auto it = aliases.find(name);
+    return it != aliases.end() ? it->second : name;
+}
+
+CsvSchema parseHeader(std::string_view header) {
+    CsvSchema schema;
+    const auto semicolons = std::count(header.begin(), header.end(), ';');
+    const auto tabs = std::count(header.begin(), header.end(), '\t');
+    const auto commas = std::count(header.begin(), header.end(), ',');
+    if (semicolons >= commas && semicolons >= tabs && semicolons > 0) schema.delimiter = ';';
+    else if (tabs > commas) schema.delimiter = '\t';
+    schema.decimalComma = schema.delimiter != ',';
+
+    const char *lineEnd = header.data() + header.size();
+    for (const char *field = header.data(); field <= lineEnd;) {
+        const char *end = fieldEnd(field, lineEnd, schema.delimiter);
+        const std::string name = normalizeHeader(std::string_view(field, end - field));
+        field = end + 1;
+
+        ColumnRole role = name.empty() ? ColumnRole::Ignored : roleForHeader(name);
+        int slot = -1;
+        if ((role == ColumnRole::Location && schema.hasLocation) || (role == ColumnRole::Time && schema.hasTime))
+            role = ColumnRole::Ignored;
+        if (role == ColumnRole::Location) schema.hasLocation = true;
+        if (role == ColumnRole::Time) schema.hasTime = true;
+        if (role == ColumnRole::Value) {
+            const std::string parameter = parameterName(name);
+            if (std::find(schema.valueNames.begin(), schema.valueNames.end(), parameter) != schema.valueNames.end()) {
+                role = ColumnRole::Ignored;
+            } else {
+                slot = static_cast<int>(schema.valueNames.size());
+                schema.valueNames.push_back(parameter);
+            }
+        }
+        schema.roles.push_back(role);
+        schema.valueSlot.push_back(slot);
+    }
+    return schema;
+}
+
+void parseChunk(ChunkTask &task, const CsvSchema &schema, const std::string &defaultLocation) {
+    const size_t valueCount = schema.valueNames.size();
+    std::unordered_map<std::string, size_t> index;
+    std::string_view lastLocation;
+    size_t lastIndex = std::string::npos;
+    std::vector<double> rowValues(valueCount);
+
+    for (const char *pos = task.begin; pos < task.end;) {
+        const void *newline = std::memchr(pos, '\n', task.end - pos);
+        const char *lineEnd = newline ? static_cast<const char *>(newline) : task.end;
+        const std::string_view line = trimField(std::string_view(pos, lineEnd - pos));
+        const char *field = pos;
+        pos = lineEnd + 1;
+        if (line.empty()) continue;
+
+        std::string_view location;
+        std::optional<std::int64_t> timestamp;
+        double latitude = NaN, longitude = NaN;
+        std::fill(rowValues.begin(), rowValues.end(), NaN);
+
+        for (size_t col = 0; col < schema.roles.size() && field <= lineEnd; ++col) {
+            const char *end = fieldEnd(field, lineEnd, schema.delimiter);
+            const std::string_view text(field, end - field);
+            field = end + 1;
+            switch (schema.roles[col]) {
+            case ColumnRole::Location: location = trimField(text); break;
+            case ColumnRole::Time: timestamp = parseIsoTimestamp(trimField(text)); break;
+            case ColumnRole::Latitude: latitude = parseNumber(text, schema.decimalComma); break;
+            case ColumnRole::Longitude: longitude = parseNumber(text, schema.decimalComma); break;
+            case ColumnRole::Value: rowValues[schema.valueSlot[col]] = parseNumber(text, schema.decimalComma); break;
+            case ColumnRole::Ignored: break;
+            }
+        }
+
+        if (!timestamp || (schema.hasLocation && location.empty())) {
+            ++task.rejected;
+            continue;
+        }
+
+        // Eksporty są zwykle pogrupowane według stacji, więc najczęściej wystarcza porównanie z poprzednim wierszem
+        if (lastIndex == std::string::npos || location != lastLocation) {
+            std::string key = schema.hasLocation ? std::string(location) : defaultLocation;
+            auto [it, inserted] = index.emplace(std::move(key), task.locations.size());
+            if (inserted) task.locations.emplace_back(it->first, LocationRows());
+            lastIndex = it->second;
+            lastLocation = location;
+        }
+
+        LocationRows &rows = task.locations[lastIndex].second;
+        rows.time.push_back(*timestamp);
+        rows.values.insert(rows.values.end(), rowValues.begin(), rowValues.end());
+        if (!std::isnan(latitude)) rows.latitude = latitude;
+        if (!std::isnan(longitude)) rows.longitude = longitude;
+        ++task.rows;
+    }
+}
+
+void buildFrame(LocationGroup &group, const CsvSchema &schema) {
+    const size_t valueCount = schema.valueNames.size();
+    AirQualityFrame &frame = group.frame;
+    frame.location = group.location;
+    frame.station = group.location;
+
+    size_t total = 0;
+    for (const LocationRows *part : group.parts) total += part->time.size();
+
+    frame.time.reserve(total);
+    for (const LocationRows *part : group.parts) {
+        frame.time.insert(frame.time.end(), part->time.begin(), part->time.end());
+        if (!std::isnan(part->latitude)) frame.latitude = part->latitude;
+        if (!std::isnan(part->longitude)) frame.longitude = part->longitude;
+    }
+
+    for (size_t v = 0; v < valueCount; ++v) {
+        std::vector<double> column;
+        column.reserve(total);
+        bool hasData = false;
+        for (const LocationRows *part : group.parts) {
+            for (size_t r = 0; r < part->time.size(); ++r) {
+                const double value = part->values[r * valueCount + v];
+                hasData = hasData || !std::isnan(value);
+                column.push_back(value);
+            }
+        }
+        // Kolumny bez żadnego pomiaru dla tej stacji są pomijane
+        if (hasData) frame.columns.emplace(schema.valueNames[v], std::move(column));
+    }
+    frame.sortByTime();
+}
+
+} // namespace
+
+CsvImporter::Result CsvImporter::importData(const char *data, qint64 size, const QString &defaultLocation) {
+    Result result;
+    result.bytes = size;
+
+    const char *begin = data;
+    const char *end = data + size;
+    if (size >= 3 && std::memcmp(begin, "\xEF\xBB\xBF", 3) == 0) begin += 3;
+
+    const void *newline = std::memchr(begin, '\n', end - begin);
+    const char *headerEnd = newline ? static_cast<const char *>(newline) : end;
+    const CsvSchema schema = parseHeader(std::string_view(begin, headerEnd - begin));
+    if (!schema.hasTime) {
+        result.error = "Brak kolumny czasu w nagłówku pliku CSV";
+        return result;
+    }
+    if (schema.valueNames.empty()) {
+        result.error = "Brak kolumn z wartościami parametrów w pliku CSV";
+        return result;
+    }
+
+    // Podział na fragmenty wyrównane do granic wierszy, co najmniej 1 MB na fragment
+    const char *body = headerEnd < end ? headerEnd + 1 : end;
+    const size_t bodySize = static_cast<size_t>(end - body);
+    const size_t maxChunks = static_cast<size_t>(std::max(1, QThread::idealThreadCount() * 4));
+    const size_t chunkCount = std::clamp<size_t>(bodySize >> 20, 1, maxChunks);
+
+    std::vector<ChunkTask> tasks;
+    tasks.reserve(chunkCount);
+    for (size_t k = 1, offset = 0; k <= chunkCount && offset < bodySize; ++k) {
+        size_t chunkEnd = k == chunkCount ? bodySize : std::max(offset, bodySize / chunkCount * k);
+        if (chunkEnd < bodySize) {
+            const void *next = std::memchr(body + chunkEnd, '\n', bodySize - chunkEnd);
+            chunkEnd = next ? static_cast<size_t>(static_cast<const char *>(next) - body) + 1 : bodySize;
+        }
+        ChunkTask task;
+        task.begin = body + offset;
+        task.end = body + chunkEnd;
+        tasks.push_back(std::move(task));
+        offset = chunkEnd;
+    }
+
+    const std::string fallbackLocation = defaultLocation.toStdString();
+    QtConcurrent::blockingMap(tasks, [&](ChunkTask &task) { parseChunk(task, schema, fallbackLocation); });
+
+    // Fragmenty każdej lokalizacji łączone są w kolejności występowania w pliku
+    std::vector<LocationGroup> groups;
+    std::unordered_map<std::string, size_t> groupIndex;
+    for (const ChunkTask &task : tasks) {
+        result.rows += task.rows;
+        result.rejectedRows += task.rejected;
+        for (const auto &[location, rows] : task.locations) {
+            auto [it, inserted] = groupIndex.emplace(location, groups.size());
+            if (inserted) {
+                groups.emplace_back();
+                groups.back().location = location;
+            }
+            groups[it->second].parts.push_back(&rows);
+        }
+    }
+
+    QtConcurrent::blockingMap(groups, [&schema](LocationGroup &group) { buildFrame(group, schema); });
+
+    result.frames.reserve(groups.size());
+    for (LocationGroup &group : groups)
+        result.frames.push_back(std::move(group.frame));
+    return result;
+}
+
+CsvImporter::Result CsvImporter::importFile(const QString &fileName) {
+    Result result;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = file.errorString();
+        return result;
+    }
+    if (file.size() == 0) {
+        result.error = "Plik jest pusty";
+        return result;
+    }
+
+    const QString defaultLocation = QFileInfo(fileName).completeBaseName();
+    if (uchar *mapped = file.map(0, file.size())) {
+        result = importData(reinterpret_cast<const char *>(mapped), file.size(), defaultLocation);
+        file.unmap(mapped);
+        return result;
+    }
+
+    // Awaryjnie, gdy mapowanie nie jest dostępne
+    const QByteArray content = file.readAll();
+    return importData(content.constData(), content.size(), defaultLocation);
+}
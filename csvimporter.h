@@ -0,0 +1,34 @@
+#ifndef CSVIMPORTER_H
+#define CSVIMPORTER_H
+
+#include <QString>
+
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Import historycznych pomiarów z dużych plików CSV
+ * \details Plik jest mapowany do pamięci i dzielony na fragmenty wyrównane do granic wierszy,
+ * które parsowane są równolegle (liczby przez std::from_chars, bez kopiowania tekstu).
+ * Wiersze są następnie grupowane i sortowane według lokalizacji. Pierwszy wiersz pliku musi
+ * być nagłówkiem; rozpoznawane są kolumny lokalizacji/stacji, czasu, współrzędnych oraz
+ * kolumny parametrów (np. "PM10", "PM2.5", "NO2"). Separator (przecinek, średnik lub tabulator)
+ * wykrywany jest automatycznie, przy średniku dopuszczalny jest przecinek dziesiętny.
+ * Pola w cudzysłowach nie mogą zawierać znaków nowej linii.
+ */
+class CsvImporter {
+public:
+    struct Result {
+        std::vector<AirQualityFrame> frames;
+        size_t rows = 0;
+        size_t rejectedRows = 0;
+        qint64 bytes = 0;
+        QString error;
+    };
+
+    static Result importFile(const QString &fileName);
+    static Result importData(const char *data, qint64 size, const QString &defaultLocation);
+};
+
+#endif // CSVIMPORTER_H
@@ -0,0 +1,296 @@
+#include "dashboardwindow.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QHelpEvent>
+#include <QLabel>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <QScrollBar>
+#include <QToolTip>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+#include "pollutants.h"
+
+QImage renderSparklineTile(const SparklineTile &tile, const QSize &size, qreal devicePixelRatio) {
+    QImage image(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QRectF frame = QRectF(QPointF(0, 0), QSizeF(size)).adjusted(0.5, 0.5, -0.5, -0.5);
+    painter.setPen(QColor(200, 200, 200));
+    painter.setBrush(Qt::white);
+    painter.drawRoundedRect(frame, 4, 4);
+
+    // Nagłówek: nazwa lokalizacji (skrócona) i ostatnia wartość
+    QFont font = painter.font();
+    font.setPointSizeF(8.5);
+    painter.setFont(font);
+    const QRect header(6, 2, size.width() - 12, 16);
+    const SparklineSeries &series = tile.series;
+    const bool above = !series.empty() && !std::isnan(tile.guideline) && series.last > tile.guideline;
+    const QString value = series.empty() ? QString("brak danych") : QString::number(series.last, 'f', 1) + tile.unit;
+    painter.setPen(series.empty() ? Qt::gray : above ? Qt::red : Qt::black);
+    painter.drawText(header, Qt::AlignRight | Qt::AlignVCenter, value);
+    const int valueWidth = painter.fontMetrics().horizontalAdvance(value) + 8;
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(Qt::black);
+    painter.drawText(header.adjusted(0, 0, -valueWidth, 0), Qt::AlignLeft | Qt::AlignVCenter,
+                     painter.fontMetrics().elidedText(tile.label, Qt::ElideRight, header.width() - valueWidth));
+    if (series.empty()) return image;
+
+    // Skala od zera (lub minimum, gdy ujemne) do maksimum, z miejscem na linię wytycznej
+    const QRectF plot(6, 20, series.low.size(), size.height() - 26);
+    double low = std::min(0.0, series.min);
+    double high = series.max;
+    if (!std::isnan(tile.guideline)) high = std::max(high, tile.guideline * 1.1);
+    if (high <= low) high = low + 1.0;
+    auto y = [&](double v) { return plot.bottom() - (v - low) / (high - low) * plot.height(); };
+
+    if (!std::isnan(tile.guideline)) {
+        painter.setPen(QPen(QColor(220, 0, 0, 160), 1, Qt::DashLine));
+        painter.drawLine(QPointF(plot.left(), y(tile.guideline)), QPointF(plot.right(), y(tile.guideline)));
+    }
+
+    // Kolumny z pomiarami łączone są w jedną linię (przez minimum i maksimum kolumny); kolumny bez
+    // pomiarów przerywają linię tylko przy dłuższej luce, a pojedyncze brakujące piksele są pomijane
+    QPainterPath path;
+    bool open = false;
+    int lastColumn = -1;
+    for (size_t x = 0; x < series.low.size(); ++x) {
+        if (std::isnan(series.low[x])) continue;
+        const qreal px = plot.left() + x + 0.5;
+        const bool rising = open && series.low[x] >= series.high[static_cast<size_t>(lastColumn)];
+        const QPointF first(px, y(rising ? series.low[x] : series.high[x]));
+        const QPointF second(px, y(rising ? series.high[x] : series.low[x]));
+        if (open && static_cast<int>(x) - lastColumn <= 3) path.lineTo(first);
+        else path.moveTo(first);
+        if (series.low[x] != series.high[x]) path.lineTo(second);
+        else if (!open || static_cast<int>(x) - lastColumn > 3) path.lineTo(px + 0.01, first.y());
+        open = true;
+        lastColumn = static_cast<int>(x);
+    }
+    painter.setPen(QPen(tile.color, 1.2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawPath(path);
+    return image;
+}
+
+SparklineGrid::SparklineGrid(QWidget *parent) : QAbstractScrollArea(parent) {
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(TileHeight / 2);
+    viewport()->setMouseTracking(true);
+}
+
+void SparklineGrid::setTiles(const QStringList &newLabels) {
+    labels = newLabels;
+    images = QList<QImage>(labels.size());
+    toolTips = QStringList(labels.size());
+    updateScrollBar();
+    viewport()->update();
+}
+
+void SparklineGrid::setImage(int tile, const QImage &image, const QString &toolTip) {
+    if (tile < 0 || tile >= images.size()) return;
+    images[tile] = image;
+    toolTips[tile] = toolTip;
+    const int column = tile % columns(), row = tile / columns();
+    viewport()->update(Spacing + column * (TileWidth + Spacing),
+                       Spacing + row * (TileHeight + Spacing) - verticalScrollBar()->value(), TileWidth, TileHeight);
+}
+
+int SparklineGrid::columns() const {
+    return std::max(1, (viewport()->width() - Spacing) / (TileWidth + Spacing));
+}
+
+std::pair<int, int> SparklineGrid::visibleTiles() const {
+    const int rowHeight = TileHeight + Spacing;
+    const int top = verticalScrollBar()->value();
+    const int firstRow = top / rowHeight;
+    const int lastRow = (top + viewport()->height()) / rowHeight + 1;
+    return {std::min<int>(firstRow * columns(), labels.size()), std::min<int>(lastRow * columns(), labels.size())};
+}
+
+int SparklineGrid::tileAt(const QPoint &position) const {
+    const int x = position.x() - Spacing;
+    const int y = position.y() + verticalScrollBar()->value() - Spacing;
+    if (x < 0 || y < 0 || x % (TileWidth + Spacing) >= TileWidth || y % (TileHeight + Spacing) >= TileHeight) return -1;
+    const int column = x / (TileWidth + Spacing);
+    if (column >= columns()) return -1;
+    const int tile = y / (TileHeight + Spacing) * columns() + column;
+    return tile < labels.size() ? tile : -1;
+}
+
+void SparklineGrid::updateScrollBar() {
+    const int rows = (static_cast<int>(labels.size()) + columns() - 1) / columns();
+    const int contentHeight = Spacing + rows * (TileHeight + Spacing);
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setRange(0, std::max(0, contentHeight - viewport()->height()));
+}
+
+void SparklineGrid::paintEvent(QPaintEvent *) {
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), palette().window());
+
+    // Tylko widoczne miniatury; obrazy mają już docelowy rozmiar i gęstość pikseli, więc są kopiowane bez skalowania
+    const int top = verticalScrollBar()->value();
+    const int count = columns();
+    const auto [first, last] = visibleTiles();
+    for (int tile = first; tile < last; ++tile) {
+        const QPoint position(Spacing + tile % count * (TileWidth + Spacing),
+                              Spacing + tile / count * (TileHeight + Spacing) - top);
+        if (images[tile].isNull()) painter.fillRect(QRect(position, tileSize()), QColor(230, 230, 230));
+        else painter.drawImage(position, images[tile]);
+    }
+}
+
+void SparklineGrid::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+}
+
+void SparklineGrid::mouseDoubleClickEvent(QMouseEvent *event) {
+    const int tile = tileAt(event->position().toPoint());
+    if (tile >= 0) emit tileActivated(tile);
+}
+
+bool SparklineGrid::viewportEvent(QEvent *event) {
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent *help = static_cast<QHelpEvent *>(event);
+        const int tile = tileAt(help->pos());
+        if (tile >= 0 && !toolTips[tile].isEmpty()) QToolTip::showText(help->globalPos(), toolTips[tile], viewport());
+        else QToolTip::hideText();
+        return true;
+    }
+    return QAbstractScrollArea::viewportEvent(event);
+}
+
+DashboardWindow::DashboardWindow(const LocationStore &store, QWidget *parent) : QWidget(parent, Qt::Window),
+    store(store) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    parameterSelector->setCurrentIndex(parameterSelector->findData("pm2_5"));
+    form->addRow("Parametr:", parameterSelector);
+    rangeSelector = new QComboBox();
+    rangeSelector->addItem("24 godziny", 24 * 3600);
+    rangeSelector->addItem("7 dni", 7 * 24 * 3600);
+    rangeSelector->addItem("30 dni", 30 * 24 * 3600);
+    rangeSelector->setCurrentIndex(1);
+    form->addRow("Okres:", rangeSelector);
+    layout->addLayout(form);
+
+    summary = new QLabel();
+    layout->addWidget(summary);
+    grid = new SparklineGrid();
+    layout->addWidget(grid, 1);
+
+    connect(parameterSelector, &QComboBox::currentIndexChanged, this, &DashboardWindow::refresh);
+    connect(rangeSelector, &QComboBox::currentIndexChanged, this, &DashboardWindow::refresh);
+    connect(grid, &SparklineGrid::tileActivated, this, [this](int tile) {
+        if (tile < locations.size()) emit locationActivated(locations[tile]);
+    });
+    connect(&renderWatcher, &QFutureWatcher<RenderedTile>::resultReadyAt, this, &DashboardWindow::tileRendered);
+
+    setWindowTitle("Panel obserwowanych lokalizacji");
+    resize(880, 700);
+}
+
+DashboardWindow::~DashboardWindow() {
+    renderWatcher.cancel();
+    renderWatcher.waitForFinished();
+}
+
+void DashboardWindow::setLocations(const QStringList &newLocations) {
+    if (newLocations == locations) return;
+    locations = newLocations;
+    tileIndex.clear();
+    for (int i = 0; i < locations.size(); ++i) tileIndex.insert(locations[i], i);
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (tileIndex.contains(it.key())) ++it;
+        else it = cache.erase(it);
+    }
+    grid->setTiles(locations);
+}
+
+void DashboardWindow::refresh() {
+    renderWatcher.cancel();
+
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+    const Pollutant *pollutant = findPollutant(parameter);
+    const std::int64_t range = rangeSelector->currentData().toLongLong();
+    // Okno kończy się na pełnej godzinie, więc skrót danych (i obraz) nie zmienia się w ciągu godziny
+    const std::int64_t to = QDateTime::currentSecsSinceEpoch() / 3600 * 3600;
+    const std::int64_t from = to - range;
+    const QSize size = grid->tileSize();
+    const qreal devicePixelRatio = devicePixelRatioF();
+    const int plotWidth = size.width() - 12;
+    const std::uint64_t seed = (static_cast<std::uint64_t>(size.width()) << 48) ^ (static_cast<std::uint64_t>(size.height()) << 32)
+                               ^ static_cast<std::uint64_t>(devicePixelRatio * 100);
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<RenderJob> jobs;
+    const auto [firstVisible, lastVisible] = grid->visibleTiles();
+    for (int i = 0; i < locations.size(); ++i) {
+        const AirQualityFrame *frame = store.find(locations[i].toStdString());
+        const std::uint64_t hash = frame ? sparklineHash(*frame, parameter, from, to, seed) : seed;
+        auto cached = cache.constFind(locations[i]);
+        if (cached != cache.constEnd() && cached->hash == hash) {
+            grid->setImage(i, cached->image, cached->toolTip);
+            continue;
+        }
+
+        RenderJob job{locations[i], hash, QString(), {}};
+        job.tile.label = locations[i];
+        job.tile.unit = pollutant && *pollutant->unit ? " " + QString::fromUtf8(pollutant->unit) : QString();
+        job.tile.color = pollutant ? QColor::fromRgb(pollutant->color) : QColor(Qt::black);
+        job.tile.guideline = pollutant ? pollutant->whoGuideline : NoLimit;
+        if (frame) job.tile.series = decimateSparkline(*frame, parameter, from, to, plotWidth);
+        const SparklineSeries &series = job.tile.series;
+        job.toolTip = series.empty() ? locations[i] + "\nbrak danych w okresie"
+                                     : QString("%1\nostatni pomiar: %2%3 (%4)\nzakres: %5 - %6\npomiary: %7")
+                                           .arg(locations[i])
+                                           .arg(series.last, 0, 'f', 1)
+                                           .arg(job.tile.unit)
+                                           .arg(QDateTime::fromSecsSinceEpoch(series.lastTime).toString("yyyy-MM-dd HH:mm"))
+                                           .arg(series.min, 0, 'f', 1)
+                                           .arg(series.max, 0, 'f', 1)
+                                           .arg(series.samples);
+        jobs.push_back(std::move(job));
+    }
+
+    // Najpierw miniatury widoczne w oknie
+    std::stable_partition(jobs.begin(), jobs.end(), [&, firstVisible = firstVisible, lastVisible = lastVisible](const RenderJob &job) {
+        const int index = tileIndex.value(job.location, -1);
+        return index >= firstVisible && index < lastVisible;
+    });
+    summary->setText(QString("Lokalizacje: %1, rysowane ponownie: %2 (przygotowanie %3 ms, dwuklik otwiera wykresy)")
+                         .arg(locations.size()).arg(jobs.size()).arg(timer.elapsed()));
+    if (jobs.empty()) return;
+
+    renderWatcher.setFuture(QtConcurrent::mapped(std::move(jobs), [size, devicePixelRatio](const RenderJob &job) {
+        return RenderedTile{job.location, job.hash, job.toolTip, renderSparklineTile(job.tile, size, devicePixelRatio)};
+    }));
+}
+
+void DashboardWindow::tileRendered(int index) {
+    const RenderedTile tile = renderWatcher.resultAt(index);
+    cache.insert(tile.location, {tile.hash, tile.image, tile.toolTip});
+    auto position = tileIndex.constFind(tile.location);
+    if (position != tileIndex.constEnd()) grid->setImage(*position, tile.image, tile.toolTip);
+}
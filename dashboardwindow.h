@@ -0,0 +1,125 @@
+#ifndef DASHBOARDWINDOW_H
+#define DASHBOARDWINDOW_H
+
+#include <QAbstractScrollArea>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QImage>
+#include <QWidget>
+
+#include "airqualityframe.h"
+#include "sparkline.h"
+
+class QComboBox;
+class QLabel;
+
+// Dane jednej miniatury: wszystko, czego potrzebuje rysowanie poza wątkiem GUI
+struct SparklineTile {
+    QString label;
+    QString unit;
+    QColor color;
+    double guideline;
+    SparklineSeries series;
+};
+
+// Rysowanie miniatury (nazwa, ostatnia wartość, przebieg min/max, linia wytycznej) do obrazu o rozmiarze
+// logicznym size; bezpieczne w wątkach roboczych - używa tylko QImage i QPainter
+QImage renderSparklineTile(const SparklineTile &tile, const QSize &size, qreal devicePixelRatio);
+
+/*!
+ * \brief Siatka gotowych obrazów miniatur
+ * \details Widżet nie tworzy elementów potomnych: paintEvent przegląda tylko wiersze siatki widoczne
+ * w oknie przewijania i kopiuje gotowe obrazy, więc koszt klatki nie zależy od liczby miniatur.
+ * Miniatury bez obrazu (jeszcze rysowane) mają szare tło.
+ */
+class SparklineGrid : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit SparklineGrid(QWidget *parent = nullptr);
+
+    void setTiles(const QStringList &labels);
+    void setImage(int tile, const QImage &image, const QString &toolTip);
+    QSize tileSize() const { return QSize(TileWidth, TileHeight); }
+
+    // Zakres [first, last) miniatur widocznych w bieżącym położeniu przewijania
+    std::pair<int, int> visibleTiles() const;
+
+signals:
+    void tileActivated(int tile);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    bool viewportEvent(QEvent *event) override;
+
+private:
+    static const int TileWidth = 200;
+    static const int TileHeight = 64;
+    static const int Spacing = 6;
+
+    int columns() const;
+    int tileAt(const QPoint &position) const;
+    void updateScrollBar();
+
+    QStringList labels;
+    QList<QImage> images;
+    QStringList toolTips;
+};
+
+/*!
+ * \brief Panel obserwowanych lokalizacji: siatka miniatur przebiegu wybranego parametru
+ * \details Serie redukowane są w wątku GUI do szerokości miniatury (min/max w kolumnie pikseli,
+ * koszt proporcjonalny do liczby pomiarów w oknie), a obrazy rysowane są w puli wątków -
+ * najpierw widoczne. Gotowe obrazy przechowywane są ze skrótem danych okna, więc po cyklu
+ * odpytywania rysowane są ponownie tylko miniatury lokalizacji, których dane się zmieniły.
+ */
+class DashboardWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit DashboardWindow(const LocationStore &store, QWidget *parent = nullptr);
+    ~DashboardWindow() override;
+
+    void setLocations(const QStringList &locations);
+
+public slots:
+    void refresh();
+
+signals:
+    void locationActivated(const QString &location);
+
+private:
+    struct CachedTile {
+        std::uint64_t hash = 0;
+        QImage image;
+        QString toolTip;
+    };
+    struct RenderJob {
+        QString location;
+        std::uint64_t hash;
+        QString toolTip;
+        SparklineTile tile;
+    };
+    struct RenderedTile {
+        QString location;
+        std::uint64_t hash;
+        QString toolTip;
+        QImage image;
+    };
+
+    void tileRendered(int index);
+
+    const LocationStore &store;
+    QComboBox *parameterSelector;
+    QComboBox *rangeSelector;
+    QLabel *summary;
+    SparklineGrid *grid;
+    QStringList locations;
+    QHash<QString, int> tileIndex;
+    QHash<QString, CachedTile> cache;
+    QFutureWatcher<RenderedTile> renderWatcher;
+};
+
+#endif // DASHBOARDWINDOW_H
@@ -0,0 +1,185 @@
+#include "distributionwindow.h"
+
+#include <QComboBox>
+#include <QDateEdit>
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QtCharts/QBarCategoryAxis>
+#include <QtCharts/QBarSeries>
+#include <QtCharts/QBarSet>
+#include <QtCharts/QChartView>
+#include <QtCharts/QValueAxis>
+#include <QtConcurrent/QtConcurrent>
+
+#include <limits>
+
+#include "pollutants.h"
+
+namespace {
+
+std::int64_t dayStart(const QDate &date) {
+    return QDateTime(date, QTime(0, 0), Qt::UTC).toSecsSinceEpoch();
+}
+
+} // namespace
+
+QChart *createHistogramChart(const Histogram &histogram, const QString &title, const QColor &color) {
+    QBarSet *set = new QBarSet(title);
+    set->setColor(color);
+    set->setBorderColor(color.darker(130));
+    QStringList categories;
+    if (histogram.underflow() > 0) {
+        categories << "< " + QString::number(histogram.lowerEdge(0), 'g', 3);
+        *set << static_cast<qreal>(histogram.underflow());
+    }
+    for (int bin = 0; bin < histogram.bins(); ++bin) {
+        categories << QString::number(histogram.lowerEdge(bin), 'g', 3);
+        *set << static_cast<qreal>(histogram.count(bin));
+    }
+    if (histogram.overflow() > 0) {
+        categories << "≥ " + QString::number(histogram.upperEdge(histogram.bins() - 1), 'g', 3);
+        *set << static_cast<qreal>(histogram.overflow());
+    }
+
+    QBarSeries *series = new QBarSeries();
+    series->setBarWidth(1.0);
+    series->append(set);
+
+    QChart *chart = new QChart();
+    chart->addSeries(series);
+    chart->setTitle(title);
+    chart->legend()->setVisible(false);
+
+    QBarCategoryAxis *axisX = new QBarCategoryAxis();
+    axisX->append(categories);
+    axisX->setLabelsAngle(-90);
+    axisX->setTitleText(histogram.scale() == HistogramScale::Log ? "Wartość (skala logarytmiczna)" : "Wartość");
+    chart->addAxis(axisX, Qt::AlignBottom);
+    series->attachAxis(axisX);
+
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setTitleText("Liczba pomiarów");
+    axisY->setLabelFormat("%d");
+    chart->addAxis(axisY, Qt::AlignLeft);
+    series->attachAxis(axisY);
+    return chart;
+}
+
+DistributionWindow::DistributionWindow(const LocationStore &store, QWidget *parent) : QWidget(parent, Qt::Window),
+    store(store) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    form->addRow("Parametr:", parameterSelector);
+    locationSelector = new QComboBox();
+    locationSelector->setMinimumContentsLength(30);
+    form->addRow("Lokalizacja:", locationSelector);
+    scaleSelector = new QComboBox();
+    scaleSelector->addItem("liniowa", static_cast<int>(HistogramScale::Linear));
+    scaleSelector->addItem("logarytmiczna", static_cast<int>(HistogramScale::Log));
+    form->addRow("Skala przedziałów:", scaleSelector);
+    QHBoxLayout *range = new QHBoxLayout();
+    fromEdit = new QDateEdit();
+    fromEdit->setCalendarPopup(true);
+    fromEdit->setDisplayFormat("yyyy-MM-dd");
+    toEdit = new QDateEdit(QDate::currentDate());
+    toEdit->setCalendarPopup(true);
+    toEdit->setDisplayFormat("yyyy-MM-dd");
+    range->addWidget(fromEdit);
+    range->addWidget(new QLabel("-"));
+    range->addWidget(toEdit);
+    form->addRow("Okres:", range);
+    layout->addLayout(form);
+
+    QPushButton *computeButton = new QPushButton("Oblicz");
+    layout->addWidget(computeButton);
+    summary = new QLabel();
+    layout->addWidget(summary);
+    view = new QChartView();
+    view->setRenderHint(QPainter::Antialiasing);
+    view->setMinimumHeight(400);
+    layout->addWidget(view, 1);
+
+    connect(computeButton, &QPushButton::clicked, this, &DistributionWindow::compute);
+
+    setWindowTitle("Rozkład wartości");
+    resize(900, 700);
+}
+
+void DistributionWindow::refreshLocations(const QString &current) {
+    locationSelector->clear();
+    locationSelector->addItem("Wszystkie lokalizacje");
+    std::int64_t first = std::numeric_limits<std::int64_t>::max();
+    for (const auto &[location, frame] : store.frames()) {
+        locationSelector->addItem(QString::fromStdString(location));
+        if (!frame.time.empty()) first = std::min(first, frame.time.front());
+    }
+    locationSelector->setCurrentIndex(std::max(0, locationSelector->findText(current)));
+    if (first != std::numeric_limits<std::int64_t>::max())
+        fromEdit->setDate(QDateTime::fromSecsSinceEpoch(first, Qt::UTC).date());
+}
+
+void DistributionWindow::compute() {
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+    const auto scale = static_cast<HistogramScale>(scaleSelector->currentData().toInt());
+    const bool allLocations = locationSelector->currentIndex() == 0;
+
+    struct Task {
+        QString key;
+        const AirQualityFrame *frame;
+        HistogramArchive *archive;
+    };
+
+    // Archiwa tworzone w wątku głównym; wskaźniki pobierane dopiero po dodaniu wszystkich wpisów
+    const std::string selected = locationSelector->currentText().toStdString();
+    std::vector<Task> tasks;
+    for (const auto &[location, frame] : store.frames()) {
+        if (!allLocations && location != selected) continue;
+        if (!frame.columns.count(parameter)) continue;
+        const QString key = QString::fromStdString(location + "/" + parameter);
+        if (!archives.contains(key)) archives.insert(key, HistogramArchive(parameter));
+        tasks.push_back({key, &frame, nullptr});
+    }
+    for (Task &task : tasks) task.archive = &archives[task.key];
+
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(tasks, [](Task &task) { task.archive->update(*task.frame); });
+
+    const std::int64_t from = dayStart(fromEdit->date());
+    const std::int64_t to = dayStart(toEdit->date().addDays(1));
+    Histogram total = parameterHistogram(parameter, scale);
+    size_t blocks = 0;
+    for (const Task &task : tasks) {
+        total.merge(task.archive->histogram(scale, from, to));
+        blocks += task.archive->blocks();
+    }
+    const qint64 elapsed = timer.elapsed();
+
+    const Pollutant *pollutant = findPollutant(parameter);
+    const QColor color = pollutant ? QColor::fromRgb(pollutant->color) : QColor(Qt::darkBlue);
+    QString title = parameterSelector->currentText() + " - " + (allLocations ? "wszystkie lokalizacje" : locationSelector->currentText());
+    QChart *previous = view->chart();
+    view->setChart(createHistogramChart(total, title, color));
+    delete previous;
+
+    if (total.total() == 0) {
+        summary->setText("Brak pomiarów w wybranym okresie");
+        return;
+    }
+    summary->setText(QString("%1 pomiarów z %2 lokalizacji (%3 bloków po %4 dni) - %5 ms\n"
+                             "Mediana: %6, P90: %7, P98: %8")
+                         .arg(total.total()).arg(tasks.size()).arg(blocks)
+                         .arg(HistogramArchive::BlockSeconds / 86400).arg(elapsed)
+                         .arg(total.quantile(0.5), 0, 'f', 1)
+                         .arg(total.quantile(0.9), 0, 'f', 1)
+                         .arg(total.quantile(0.98), 0, 'f', 1));
+}
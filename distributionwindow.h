@@ -0,0 +1,49 @@
+#ifndef DISTRIBUTIONWINDOW_H
+#define DISTRIBUTIONWINDOW_H
+
+#include <QHash>
+#include <QWidget>
+
+#include "airqualityframe.h"
+#include "histogram.h"
+
+class QChart;
+class QChartView;
+class QComboBox;
+class QDateEdit;
+class QLabel;
+
+// Wykres słupkowy histogramu; niedomiar i nadmiar jako skrajne słupki, jeśli nie są puste
+QChart *createHistogramChart(const Histogram &histogram, const QString &title, const QColor &color);
+
+/*!
+ * \brief Okno rozkładu wartości parametru dla jednej lub wszystkich lokalizacji w wybranym okresie
+ * \details Histogram składany jest z archiwów histogramów bloków (HistogramArchive) kolejnych
+ * lokalizacji, aktualizowanych równolegle tylko o dane dopisane od poprzedniego obliczenia -
+ * rozkład wieloletniego archiwum nie wymaga ponownego przeglądania pomiarów.
+ */
+class DistributionWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit DistributionWindow(const LocationStore &store, QWidget *parent = nullptr);
+
+    // Odświeżenie listy lokalizacji i zakresu dat po zmianie magazynu
+    void refreshLocations(const QString &current = QString());
+
+private slots:
+    void compute();
+
+private:
+    const LocationStore &store;
+    QComboBox *parameterSelector;
+    QComboBox *locationSelector;
+    QComboBox *scaleSelector;
+    QDateEdit *fromEdit;
+    QDateEdit *toEdit;
+    QLabel *summary;
+    QChartView *view;
+    QHash<QString, HistogramArchive> archives;     // klucz "lokalizacja/parametr"
+};
+
+#endif // DISTRIBUTIONWINDOW_H
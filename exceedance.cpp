@@ -0,0 +1,130 @@
+#include "exceedance.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const size_t BlockRows = 4096;
+
+} // namespace
+
+ExceedanceTracker::ExceedanceTracker(double threshold, std::int64_t maxGap, std::int64_t averaging)
+    : limit(threshold), maxGap(maxGap), averaging(averaging) {}
+
+void ExceedanceTracker::update(const AirQualityFrame &frame, const std::string &param) {
+    static const std::vector<double> empty;
+    auto column = frame.columns.find(param);
+    const std::vector<double> &raw = column != frame.columns.end() ? column->second : empty;
+    const std::vector<std::int64_t> &time = frame.time;
+
+    const std::optional<std::int64_t> changed = frame.changedSince(scannedRevision);
+    scannedRevision = frame.revision;
+    if (!changed) return;
+    size_t from = std::lower_bound(time.begin(), time.end(), *changed) - time.begin();
+    const std::vector<double> &values = averaging > 0 ? averageFrom(from, time, raw) : raw;
+
+    // Epizody sięgające zmienionych wierszy są liczone od nowa; ostatni wcześniejszy epizod także, jeśli
+    // do zmienionych wierszy prowadzą tylko braki pomiaru (mógł połączyć się z nowym przekroczeniem)
+    size_t reopened = from;
+    while (!found.empty() && found.back().lastRow >= from) {
+        reopened = std::min(reopened, found.back().firstRow);
+        found.pop_back();
+    }
+    if (reopened < from) {
+        from = reopened;
+    } else if (!found.empty()) {
+        size_t row = from;
+        while (row > found.back().lastRow + 1 && std::isnan(values[row - 1])) --row;
+        if (row == found.back().lastRow + 1) {
+            from = found.back().firstRow;
+            found.pop_back();
+        }
+    }
+    if (from == 0) found.clear();
+    scanFrom(from, time, values);
+}
+
+const std::vector<double> &ExceedanceTracker::averageFrom(size_t row, const std::vector<std::int64_t> &time,
+                                                          const std::vector<double> &values) {
+    const size_t rows = std::min(time.size(), values.size());
+    averaged.resize(rows);
+    if (row >= rows) return averaged;
+
+    // Średnie wierszy przed row nie zależą od zmienionych wierszy; okno pierwszego liczonego wiersza
+    // zbierane jest od nowa, dalej bieżąca suma jak w AlertEngine
+    size_t first = std::upper_bound(time.begin(), time.begin() + row, time[row] - averaging) - time.begin();
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t r = first; r < row; ++r) {
+        if (std::isnan(values[r])) continue;
+        sum += values[r];
+        ++count;
+    }
+    for (size_t r = row; r < rows; ++r) {
+        while (time[first] <= time[r] - averaging) {
+            if (!std::isnan(values[first])) {
+                sum -= values[first];
+                --count;
+            }
+            ++first;
+        }
+        if (!std::isnan(values[r])) {
+            sum += values[r];
+            ++count;
+        }
+        if (count == 0) sum = 0.0;
+        averaged[r] = count ? sum / count : std::numeric_limits<double>::quiet_NaN();
+    }
+    return averaged;
+}
+
+size_t ExceedanceTracker::exceedingSamples() const {
+    size_t total = 0;
+    for (const ExceedanceEpisode &episode : found) total += episode.samples;
+    return total;
+}
+
+void ExceedanceTracker::scanFrom(size_t row, const std::vector<std::int64_t> &time, const std::vector<double> &values) {
+    const size_t rows = std::min(time.size(), values.size());
+    std::vector<std::uint8_t> mask(BlockRows);
+    bool open = false;
+    ExceedanceEpisode current{};
+    double sum = 0.0;
+
+    for (size_t begin = row; begin < rows; begin += BlockRows) {
+        const size_t count = std::min(BlockRows, rows - begin);
+        const double *block = values.data() + begin;
+
+        // Porównanie całego bloku naraz: 0 - brak pomiaru, 1 - poniżej progu, 2 - powyżej
+        for (size_t i = 0; i < count; ++i)
+            mask[i] = static_cast<std::uint8_t>((block[i] == block[i]) + (block[i] > limit));
+
+        for (size_t i = 0; i < count; ++i) {
+            if (mask[i] == 0) continue;
+            const size_t r = begin + i;
+            if (open && (mask[i] == 1 || time[r] - current.end > maxGap)) {
+                current.mean = sum / current.samples;
+                found.push_back(current);
+                open = false;
+            }
+            if (mask[i] == 1) continue;
+
+            if (!open) {
+                current = {time[r], time[r], block[i], 0.0, 0, r, r};
+                sum = 0.0;
+                open = true;
+            }
+            current.end = time[r];
+            current.lastRow = r;
+            current.peak = std::max(current.peak, block[i]);
+            sum += block[i];
+            ++current.samples;
+        }
+    }
+    if (open) {
+        current.mean = sum / current.samples;
+        found.push_back(current);
+    }
+}
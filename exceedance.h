@@ -0,0 +1,58 @@
+#ifndef EXCEEDANCE_H
+#define EXCEEDANCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+
+// Nieprzerwany ciąg pomiarów powyżej progu
+struct ExceedanceEpisode {
+    std::int64_t start;
+    std::int64_t end;       // znacznik ostatniego pomiaru epizodu
+    double peak;
+    double mean;
+    size_t samples;
+    size_t firstRow;
+    size_t lastRow;
+};
+
+/*!
+ * \brief Wykrywanie epizodów przekroczeń progu w serii pomiarów
+ * \details Kolumna porównywana jest z progiem blokami do tablicy masek (pętla bez rozgałęzień,
+ * wektoryzowana przez kompilator), a maska kodowana jest ciągami (RLE) w epizody. Braki pomiaru (NaN)
+ * są pomijane; epizod przerywa pomiar nie większy od progu lub przerwa między kolejnymi pomiarami
+ * powyżej progu dłuższa niż maxGap. Przy averaging > 0 z progiem porównywana jest średnia krocząca
+ * z okna (t - averaging, t] zamiast pojedynczych pomiarów (np. wytyczne WHO dla średniej dobowej);
+ * wtedy szczyt i średnia epizodu także dotyczą średnich kroczących.
+ * Serie z magazynu (LocationStore) podają w dzienniku rewizji najwcześniejszy zmieniony znacznik, więc
+ * update() skanuje ponownie tylko wiersze od tego znacznika (po dopisaniu danych albo poprawkach
+ * prognozy) oraz epizod, który mógł się z nimi połączyć; pozostałe serie skanowane są w całości.
+ */
+class ExceedanceTracker {
+public:
+    explicit ExceedanceTracker(double threshold = 0.0, std::int64_t maxGap = 3600, std::int64_t averaging = 0);
+
+    // Aktualizacja dla kolumny param serii, która mogła zmienić się od poprzedniego wywołania
+    void update(const AirQualityFrame &frame, const std::string &param);
+
+    double threshold() const { return limit; }
+    std::int64_t averagingWindow() const { return averaging; }
+    const std::vector<ExceedanceEpisode> &episodes() const { return found; }
+    size_t exceedingSamples() const;
+
+private:
+    void scanFrom(size_t row, const std::vector<std::int64_t> &time, const std::vector<double> &values);
+    const std::vector<double> &averageFrom(size_t row, const std::vector<std::int64_t> &time, const std::vector<double> &values);
+
+    double limit;
+    std::int64_t maxGap;
+    std::int64_t averaging;
+    std::vector<double> averaged;   // średnie kroczące wszystkich wierszy (przy averaging > 0)
+    std::vector<ExceedanceEpisode> found;
+    std::uint64_t scannedRevision = 0;
+};
+
+#endif // EXCEEDANCE_H
@@ -0,0 +1,275 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Liczba wierszy przetwarzanych naraz: kilka rejestrów po 8 KB mieści się w pamięci L1/L2
+const size_t BlockRows = 1024;
+
+} // namespace
+
+// Parser rekurencyjny generujący instrukcje bezpośrednio w trakcie analizy składni
+class ExpressionCompiler {
+public:
+    explicit ExpressionCompiler(const std::string &text) : text(text) {}
+
+    ExpressionPlan compile() {
+        plan.result = comparison();
+        skipSpaces();
+        if (position < text.size()) fail("nieoczekiwany znak '" + std::string(1, text[position]) + "'");
+        return std::move(plan);
+    }
+
+private:
+    using Op = ExpressionPlan::Op;
+    using Operand = ExpressionPlan::Operand;
+
+    const std::string &text;
+    size_t position = 0;
+    ExpressionPlan plan;
+    std::vector<int> freeRegisters;
+
+    [[noreturn]] void fail(const std::string &message) const {
+        throw std::runtime_error("Błąd w wyrażeniu (pozycja " + std::to_string(position + 1) + "): " + message);
+    }
+
+    void skipSpaces() {
+        while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) ++position;
+    }
+
+    bool accept(const char *token) {
+        skipSpaces();
+        const size_t length = std::char_traits<char>::length(token);
+        if (text.compare(position, length, token) != 0) return false;
+        position += length;
+        return true;
+    }
+
+    void expect(const char *token) {
+        if (!accept(token)) fail(std::string("oczekiwano '") + token + "'");
+    }
+
+    Operand constant(double value) {
+        plan.constants.push_back(value);
+        return {Operand::Kind::Constant, static_cast<int>(plan.constants.size()) - 1};
+    }
+
+    void release(const Operand &operand) {
+        if (operand.kind == Operand::Kind::Register) freeRegisters.push_back(operand.index);
+    }
+
+    // Instrukcja zapisująca wynik do wolnego rejestru; dla dwóch stałych wynik liczony jest od razu
+    Operand emit(Op op, Operand left, Operand right) {
+        if (left.kind == Operand::Kind::Constant && right.kind == Operand::Kind::Constant)
+            return constant(ExpressionPlan::applyScalar(op, plan.constants[left.index], plan.constants[right.index]));
+
+        // Operacje jednoargumentowe przekazują ten sam argument dwukrotnie - rejestr zwalniany jest raz
+        release(left);
+        if (right.kind != left.kind || right.index != left.index) release(right);
+        int target;
+        if (!freeRegisters.empty()) {
+            target = freeRegisters.back();
+            freeRegisters.pop_back();
+        } else {
+            target = plan.registerCount++;
+        }
+        plan.code.push_back({op, target, left, right});
+        return {Operand::Kind::Register, target};
+    }
+
+    Operand comparison() {
+        Operand left = additive();
+        static const std::pair<const char *, Op> operators[] = {
+            {"<=", Op::LessEqual}, {">=", Op::GreaterEqual}, {"==", Op::Equal}, {"!=", Op::NotEqual},
+            {"<", Op::Less}, {">", Op::Greater}
+        };
+        for (const auto &[token, op] : operators)
+            if (accept(token)) return emit(op, left, additive());
+        return left;
+    }
+
+    Operand additive() {
+        Operand left = term();
+        for (;;) {
+            if (accept("+")) left = emit(Op::Add, left, term());
+            else if (accept("-")) left = emit(Op::Sub, left, term());
+            else return left;
+        }
+    }
+
+    Operand term() {
+        Operand left = unary();
+        for (;;) {
+            if (accept("*")) left = emit(Op::Mul, left, unary());
+            else if (accept("/")) left = emit(Op::Div, left, unary());
+            else return left;
+        }
+    }
+
+    Operand unary() {
+        if (accept("-")) {
+            Operand operand = unary();
+            return emit(Op::Neg, operand, operand);
+        }
+        return primary();
+    }
+
+    Operand primary() {
+        skipSpaces();
+        if (position >= text.size()) fail("niepełne wyrażenie");
+
+        if (accept("(")) {
+            Operand inner = comparison();
+            expect(")");
+            return inner;
+        }
+
+        const char c = text[position];
+        if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            // from_chars nie zależy od locale (strtod po setlocale w QApplication może oczekiwać przecinka)
+            const char *begin = text.data() + position;
+            double value;
+            const auto [end, error] = std::from_chars(begin, text.data() + text.size(), value);
+            if (error != std::errc()) fail("nieprawidłowa liczba");
+            position += static_cast<size_t>(end - begin);
+            return constant(value);
+        }
+
+        if (!std::isalpha(static_cast<unsigned char>(c)) && c != '_') fail("nieoczekiwany znak '" + std::string(1, c) + "'");
+        const size_t start = position;
+        while (position < text.size() && (std::isalnum(static_cast<unsigned char>(text[position])) || text[position] == '_'))
+            ++position;
+        const std::string name = text.substr(start, position - start);
+
+        if (accept("(")) return call(name);
+
+        auto it = std::find(plan.columnNames.begin(), plan.columnNames.end(), name);
+        if (it == plan.columnNames.end()) it = plan.columnNames.insert(plan.columnNames.end(), name);
+        return {Operand::Kind::Column, static_cast<int>(it - plan.columnNames.begin())};
+    }
+
+    Operand call(const std::string &name) {
+        Operand first = comparison();
+        if (name == "abs" || name == "sqrt") {
+            expect(")");
+            return emit(name == "abs" ? Op::Abs : Op::Sqrt, first, first);
+        }
+        if (name == "min" || name == "max") {
+            expect(",");
+            Operand second = comparison();
+            expect(")");
+            return emit(name == "min" ? Op::Min : Op::Max, first, second);
+        }
+        fail("nieznana funkcja '" + name + "'");
+    }
+};
+
+namespace {
+
+// Pętla instrukcji po bloku: jedna operacja na ciągłych tablicach, bez rozgałęzień zależnych od danych
+template <typename F>
+void blockLoop(double *out, const double *a, const double *b, size_t count, F f) {
+    for (size_t i = 0; i < count; ++i) out[i] = f(a[i], b[i]);
+}
+
+// Porównanie z zachowaniem luk: NaN w argumencie daje NaN zamiast 0
+template <typename F>
+void compareLoop(double *out, const double *a, const double *b, size_t count, F f) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t i = 0; i < count; ++i) {
+        const double result = f(a[i], b[i]) ? 1.0 : 0.0;
+        out[i] = (a[i] == a[i] && b[i] == b[i]) ? result : nan;
+    }
+}
+
+} // namespace
+
+double ExpressionPlan::applyScalar(Op op, double a, double b) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const bool valid = !std::isnan(a) && !std::isnan(b);
+    switch (op) {
+    case Op::Add: return a + b;
+    case Op::Sub: return a - b;
+    case Op::Mul: return a * b;
+    case Op::Div: return a / b;
+    case Op::Neg: return -a;
+    case Op::Less: return valid ? double(a < b) : nan;
+    case Op::LessEqual: return valid ? double(a <= b) : nan;
+    case Op::Greater: return valid ? double(a > b) : nan;
+    case Op::GreaterEqual: return valid ? double(a >= b) : nan;
+    case Op::Equal: return valid ? double(a == b) : nan;
+    case Op::NotEqual: return valid ? double(a != b) : nan;
+    case Op::Min: return valid ? std::min(a, b) : nan;
+    case Op::Max: return valid ? std::max(a, b) : nan;
+    case Op::Abs: return std::fabs(a);
+    case Op::Sqrt: return std::sqrt(a);
+    }
+    return nan;
+}
+
+ExpressionPlan ExpressionPlan::compile(const std::string &text) {
+    return ExpressionCompiler(text).compile();
+}
+
+std::vector<double> ExpressionPlan::evaluate(const AirQualityFrame &frame) const {
+    const size_t rows = frame.size();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> output(rows, nan);
+    if (rows == 0) return output;
+
+    std::vector<const double *> columnData;
+    for (const std::string &name : columnNames) {
+        auto it = frame.columns.find(name);
+        if (it == frame.columns.end()) return output;
+        columnData.push_back(it->second.data());
+    }
+
+    // Stałe rozwinięte do pełnych bloków, by każda instrukcja działała na dwóch ciągłych tablicach
+    std::vector<double> constantBlocks(constants.size() * BlockRows);
+    for (size_t c = 0; c < constants.size(); ++c)
+        std::fill_n(constantBlocks.begin() + c * BlockRows, BlockRows, constants[c]);
+    std::vector<double> registers(static_cast<size_t>(registerCount) * BlockRows);
+
+    for (size_t begin = 0; begin < rows; begin += BlockRows) {
+        const size_t count = std::min(BlockRows, rows - begin);
+        auto data = [&](const Operand &operand) -> const double * {
+            switch (operand.kind) {
+            case Operand::Kind::Column: return columnData[operand.index] + begin;
+            case Operand::Kind::Constant: return constantBlocks.data() + operand.index * BlockRows;
+            case Operand::Kind::Register: break;
+            }
+            return registers.data() + operand.index * BlockRows;
+        };
+
+        for (const Instruction &instruction : code) {
+            double *out = registers.data() + instruction.target * BlockRows;
+            const double *a = data(instruction.left);
+            const double *b = data(instruction.right);
+            switch (instruction.op) {
+            case Op::Add: blockLoop(out, a, b, count, [](double x, double y) { return x + y; }); break;
+            case Op::Sub: blockLoop(out, a, b, count, [](double x, double y) { return x - y; }); break;
+            case Op::Mul: blockLoop(out, a, b, count, [](double x, double y) { return x * y; }); break;
+            case Op::Div: blockLoop(out, a, b, count, [](double x, double y) { return x / y; }); break;
+            case Op::Neg: blockLoop(out, a, b, count, [](double x, double) { return -x; }); break;
+            case Op::Abs: blockLoop(out, a, b, count, [](double x, double) { return std::fabs(x); }); break;
+            case Op::Sqrt: blockLoop(out, a, b, count, [](double x, double) { return std::sqrt(x); }); break;
+            case Op::Min: blockLoop(out, a, b, count, [](double x, double y) { return x != x || y != y ? x + y : (y < x ? y : x); }); break;
+            case Op::Max: blockLoop(out, a, b, count, [](double x, double y) { return x != x || y != y ? x + y : (y > x ? y : x); }); break;
+            case Op::Less: compareLoop(out, a, b, count, [](double x, double y) { return x < y; }); break;
+            case Op::LessEqual: compareLoop(out, a, b, count, [](double x, double y) { return x <= y; }); break;
+            case Op::Greater: compareLoop(out, a, b, count, [](double x, double y) { return x > y; }); break;
+            case Op::GreaterEqual: compareLoop(out, a, b, count, [](double x, double y) { return x >= y; }); break;
+            case Op::Equal: compareLoop(out, a, b, count, [](double x, double y) { return x == y; }); break;
+            case Op::NotEqual: compareLoop(out, a, b, count, [](double x, double y) { return x != y; }); break;
+            }
+        }
+        std::copy_n(data(result), count, output.begin() + begin);
+    }
+    return output;
+}
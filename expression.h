@@ -0,0 +1,57 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Skompilowane wyrażenie definiujące serię pochodną, np. "pm2_5 / pm10"
+ * \details Język obejmuje liczby, nazwy kolumn serii, operatory + - * /, porównania
+ * (< <= > >= == !=, wynik 1 lub 0) oraz funkcje abs, sqrt, min, max. Wyrażenie kompilowane jest
+ * raz do listy instrukcji na rejestrach (ze zwinięciem stałych), a wykonywane blokami wierszy
+ * mieszczącymi się w pamięci podręcznej procesora: każda instrukcja to prosta pętla po bloku,
+ * którą kompilator wektoryzuje. Brak pomiaru (NaN) w argumencie daje NaN w wyniku.
+ */
+class ExpressionPlan {
+public:
+    // Zgłasza std::runtime_error z opisem błędu składni
+    static ExpressionPlan compile(const std::string &text);
+
+    // Nazwy kolumn użytych w wyrażeniu
+    const std::vector<std::string> &columns() const { return columnNames; }
+
+    // Wartości wyrażenia dla wszystkich wierszy serii; brak kolumny w serii daje same NaN
+    std::vector<double> evaluate(const AirQualityFrame &frame) const;
+
+private:
+    enum class Op { Add, Sub, Mul, Div, Neg, Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual,
+                    Min, Max, Abs, Sqrt };
+
+    // Argument instrukcji: kolumna, stała lub rejestr
+    struct Operand {
+        enum class Kind { Column, Constant, Register } kind;
+        int index;
+    };
+
+    struct Instruction {
+        Op op;
+        int target;
+        Operand left;
+        Operand right;
+    };
+
+    friend class ExpressionCompiler;
+
+    // Wartość operacji dla dwóch stałych (zwijanie stałych przy kompilacji)
+    static double applyScalar(Op op, double a, double b);
+
+    std::vector<std::string> columnNames;
+    std::vector<double> constants;
+    std::vector<Instruction> code;
+    Operand result{Operand::Kind::Constant, 0};
+    int registerCount = 0;
+};
+
+#endif // EXPRESSION_H
@@ -0,0 +1,162 @@
+#include "forecast.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+const double Alphas[] = {0.05, 0.1, 0.2, 0.3, 0.5, 0.7};
+const double Betas[] = {0.0, 0.01, 0.05};
+const double Gammas[] = {0.05, 0.15, 0.3};
+const size_t Variants = std::size(Alphas) * std::size(Betas) * std::size(Gammas);
+const double Z95 = 1.959963984540054;
+
+std::int64_t hourOf(std::int64_t time) {
+    return (time >= 0 ? time : time - HoltWintersForecaster::Step + 1) / HoltWintersForecaster::Step;
+}
+
+int slotOf(std::int64_t hour) {
+    return static_cast<int>(((hour % HoltWintersForecaster::Period) + HoltWintersForecaster::Period)
+                            % HoltWintersForecaster::Period);
+}
+
+} // namespace
+
+bool HoltWintersForecaster::fit(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                std::int64_t until) {
+    initialized = false;
+    const size_t end = std::upper_bound(time.begin(), time.begin() + std::min(time.size(), values.size()), until) - time.begin();
+    if (end == 0) return false;
+
+    // Regularna siatka godzinowa ostatnich FitHours godzin (NaN w godzinach bez pomiaru)
+    const std::int64_t lastHour = hourOf(time[end - 1]);
+    const std::int64_t firstHour = std::max(hourOf(time.front()), lastHour - static_cast<std::int64_t>(FitHours) + 1);
+    const size_t hours = static_cast<size_t>(lastHour - firstHour + 1);
+    if (hours < 3 * Period) return false;
+    std::vector<double> grid(hours, std::numeric_limits<double>::quiet_NaN());
+    for (size_t i = std::lower_bound(time.begin(), time.begin() + end, firstHour * Step) - time.begin(); i < end; ++i)
+        if (!std::isnan(values[i])) grid[static_cast<size_t>(hourOf(time[i]) - firstHour)] = values[i];
+
+    // Stan początkowy z dwóch pierwszych okresów: poziom, trend i odchylenia sezonowe
+    double periodMean[2];
+    for (int p = 0; p < 2; ++p) {
+        double sum = 0.0;
+        int count = 0;
+        for (int i = 0; i < Period; ++i)
+            if (!std::isnan(grid[p * Period + i])) {
+                sum += grid[p * Period + i];
+                ++count;
+            }
+        if (count == 0) return false;
+        periodMean[p] = sum / count;
+    }
+    std::array<double, Period> initialSeason{};
+    for (int i = 0; i < Period; ++i) {
+        double sum = 0.0;
+        int count = 0;
+        for (int p = 0; p < 2; ++p)
+            if (!std::isnan(grid[p * Period + i])) {
+                sum += grid[p * Period + i] - periodMean[p];
+                ++count;
+            }
+        initialSeason[slotOf(firstHour + i)] = count ? sum / count : 0.0;
+    }
+    const double initialTrend = (periodMean[1] - periodMean[0]) / Period;
+    const double initialLevel = periodMean[1] + initialTrend * (Period - 1) / 2.0;
+
+    // Wszystkie warianty parametrów w jednym przebiegu: tablice stanów indeksowane wariantem
+    double alpha[Variants], beta[Variants], gamma[Variants];
+    double lv[Variants], tr[Variants], sse[Variants];
+    std::vector<std::array<double, Variants>> seasons(Period);
+    size_t k = 0;
+    for (double a : Alphas)
+        for (double b : Betas)
+            for (double g : Gammas) {
+                alpha[k] = a;
+                beta[k] = b;
+                gamma[k] = g;
+                lv[k] = initialLevel;
+                tr[k] = initialTrend;
+                sse[k] = 0.0;
+                ++k;
+            }
+    for (int s = 0; s < Period; ++s) seasons[s].fill(initialSeason[s]);
+
+    size_t observed = 0;
+    for (size_t h = 2 * Period; h < hours; ++h) {
+        double *seasonal = seasons[slotOf(firstHour + static_cast<std::int64_t>(h))].data();
+        const double x = grid[h];
+        if (std::isnan(x)) {
+            for (size_t v = 0; v < Variants; ++v) lv[v] += tr[v];
+            continue;
+        }
+        ++observed;
+        for (size_t v = 0; v < Variants; ++v) {
+            const double error = x - (lv[v] + tr[v] + seasonal[v]);
+            sse[v] += error * error;
+            const double newLevel = alpha[v] * (x - seasonal[v]) + (1.0 - alpha[v]) * (lv[v] + tr[v]);
+            tr[v] = beta[v] * (newLevel - lv[v]) + (1.0 - beta[v]) * tr[v];
+            seasonal[v] = gamma[v] * (x - newLevel) + (1.0 - gamma[v]) * seasonal[v];
+            lv[v] = newLevel;
+        }
+    }
+    if (observed == 0) return false;
+
+    const size_t best = std::min_element(sse, sse + Variants) - sse;
+    smoothing = {alpha[best], beta[best], gamma[best]};
+    level = lv[best];
+    trend = tr[best];
+    for (int s = 0; s < Period; ++s) season[s] = seasons[s][best];
+    errorSquares = sse[best];
+    errors = observed;
+    last = lastHour * Step;
+    initialized = true;
+    return true;
+}
+
+void HoltWintersForecaster::update(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                   std::int64_t until) {
+    if (!initialized) return;
+    const size_t rows = std::min(time.size(), values.size());
+    for (size_t i = std::upper_bound(time.begin(), time.begin() + rows, last) - time.begin(); i < rows && time[i] <= until; ++i) {
+        const std::int64_t hour = hourOf(time[i]);
+        if (hour <= hourOf(last)) continue;
+        for (std::int64_t gap = hourOf(last) + 1; gap < hour; ++gap) step(std::numeric_limits<double>::quiet_NaN());
+        step(values[i]);
+    }
+}
+
+void HoltWintersForecaster::step(double value) {
+    const std::int64_t hour = hourOf(last) + 1;
+    last = hour * Step;
+    double &seasonal = season[slotOf(hour)];
+    if (std::isnan(value)) {
+        level += trend;
+        return;
+    }
+
+    const auto [alpha, beta, gamma] = smoothing;
+    const double error = value - (level + trend + seasonal);
+    errorSquares += error * error;
+    ++errors;
+    const double newLevel = alpha * (value - seasonal) + (1.0 - alpha) * (level + trend);
+    trend = beta * (newLevel - level) + (1.0 - beta) * trend;
+    seasonal = gamma * (value - newLevel) + (1.0 - gamma) * seasonal;
+    level = newLevel;
+}
+
+std::vector<ForecastPoint> HoltWintersForecaster::forecast(int hours) const {
+    std::vector<ForecastPoint> points;
+    if (!initialized) return points;
+
+    const double sigma = std::sqrt(errorSquares / std::max<size_t>(errors, 1));
+    const std::int64_t lastHour = hourOf(last);
+    for (int h = 1; h <= hours; ++h) {
+        const double mean = level + h * trend + season[slotOf(lastHour + h)];
+        const double spread = Z95 * sigma * std::sqrt(1.0 + (h - 1) * smoothing[0] * smoothing[0]);
+        points.push_back({(lastHour + h) * Step, mean, mean - spread, mean + spread});
+    }
+    return points;
+}
@@ -0,0 +1,62 @@
+#ifndef FORECAST_H
+#define FORECAST_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Punkt prognozy z 95% przedziałem
+struct ForecastPoint {
+    std::int64_t time;
+    double mean;
+    double lower;
+    double upper;
+};
+
+/*!
+ * \brief Prognoza krótkoterminowa Holta-Wintersa (addytywna, sezonowość dobowa) dla serii godzinowej
+ * \details fit() wybiera parametry wygładzania z siatki: wszystkie warianty przeliczane są naraz
+ * w jednym przebiegu po historii (stan każdego wariantu w osobnym torze tablic, więc pętla po
+ * wariantach jest wektoryzowana), a wygrywa wariant o najmniejszym błędzie prognozy o krok.
+ * Później update() dopisuje tylko nowe godziny - koszt O(1) na godzinę, bez ponownego dopasowania.
+ * Godziny bez pomiaru przesuwają stan bez korekty. Indeks sezonu to godzina UTC, więc przerwy
+ * w danych nie przesuwają sezonowości. Przedział prognozy wynika z wariancji błędów prognozy
+ * o krok, rozszerzanej z horyzontem jak w modelu prostego wygładzania.
+ */
+class HoltWintersForecaster {
+public:
+    static const int Period = 24;
+    static const std::int64_t Step = 3600;
+
+    // Dopasowanie do wierszy nie późniejszych niż until (z historii nie dłuższej niż FitHours);
+    // false przy zbyt krótkiej historii
+    bool fit(const std::vector<std::int64_t> &time, const std::vector<double> &values, std::int64_t until);
+
+    // Dopisanie wierszy nowszych niż lastTime() i nie późniejszych niż until
+    void update(const std::vector<std::int64_t> &time, const std::vector<double> &values, std::int64_t until);
+
+    std::vector<ForecastPoint> forecast(int hours) const;
+
+    bool ready() const { return initialized; }
+    std::int64_t lastTime() const { return last; }
+    double alpha() const { return smoothing[0]; }
+    double beta() const { return smoothing[1]; }
+    double gamma() const { return smoothing[2]; }
+
+    static const size_t FitHours = 60 * 24;
+
+private:
+    void step(double value);
+
+    std::array<double, 3> smoothing{0.3, 0.01, 0.1};
+    double level = 0.0;
+    double trend = 0.0;
+    std::array<double, Period> season{};
+    double errorSquares = 0.0;
+    size_t errors = 0;
+    std::int64_t last = 0;
+    bool initialized = false;
+};
+
+#endif // FORECAST_H
@@ -0,0 +1,75 @@
+#include "framejoin.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+
+// Wspólna oś czasu: suma posortowanych osi bez powtórzeń, ewentualnie przycięta do wspólnego zakresu
+std::vector<std::int64_t> joinedAxis(const std::vector<JoinSource> &sources, JoinRange range) {
+    std::vector<std::int64_t> axis;
+    if (sources.empty()) return axis;
+    if (range == JoinRange::First) return sources.front().frame->time;
+
+    std::vector<std::int64_t> merged;
+    for (const JoinSource &source : sources) {
+        const std::vector<std::int64_t> &time = source.frame->time;
+        merged.clear();
+        merged.reserve(axis.size() + time.size());
+        std::set_union(axis.begin(), axis.end(), time.begin(), time.end(), std::back_inserter(merged));
+        axis.swap(merged);
+    }
+
+    if (range == JoinRange::Intersection) {
+        std::int64_t from = std::numeric_limits<std::int64_t>::min();
+        std::int64_t to = std::numeric_limits<std::int64_t>::max();
+        for (const JoinSource &source : sources) {
+            if (source.frame->time.empty()) continue;
+            from = std::max(from, source.frame->time.front());
+            to = std::min(to, source.frame->time.back());
+        }
+        axis.erase(std::upper_bound(axis.begin(), axis.end(), to), axis.end());
+        axis.erase(axis.begin(), std::lower_bound(axis.begin(), axis.end(), from));
+    }
+    return axis;
+}
+
+} // namespace
+
+AirQualityFrame joinFrames(const std::vector<JoinSource> &sources, JoinRange range) {
+    AirQualityFrame joined;
+    if (sources.empty()) return joined;
+
+    const AirQualityFrame &first = *sources.front().frame;
+    joined.location = first.location;
+    joined.station = first.station;
+    joined.timezone = first.timezone;
+    joined.latitude = first.latitude;
+    joined.longitude = first.longitude;
+    joined.time = joinedAxis(sources, range);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const size_t rows = joined.time.size();
+    std::vector<std::ptrdiff_t> sourceRow(rows);
+
+    for (const JoinSource &source : sources) {
+        const std::vector<std::int64_t> &time = source.frame->time;
+
+        // Dwa wskaźniki po posortowanych osiach: -1 oznacza lukę w źródle
+        size_t j = 0;
+        for (size_t r = 0; r < rows; ++r) {
+            while (j < time.size() && time[j] < joined.time[r]) ++j;
+            sourceRow[r] = j < time.size() && time[j] == joined.time[r] ? static_cast<std::ptrdiff_t>(j) : -1;
+        }
+
+        for (const auto &[name, values] : source.frame->columns) {
+            auto [it, inserted] = joined.columns.try_emplace(source.prefix + name);
+            std::vector<double> &column = it->second;
+            if (inserted) column.assign(rows, nan);
+            for (size_t r = 0; r < rows; ++r)
+                if (sourceRow[r] >= 0 && std::isnan(column[r])) column[r] = values[sourceRow[r]];
+        }
+    }
+    return joined;
+}
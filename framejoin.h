@@ -0,0 +1,28 @@
+#ifndef FRAMEJOIN_H
+#define FRAMEJOIN_H
+
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+
+struct JoinSource {
+    const AirQualityFrame *frame;
+    std::string prefix;     // dodawany do nazw kolumn źródła (np. "weather_"), może być pusty
+};
+
+enum class JoinRange {
+    Union,          // wszystkie znaczniki czasu ze wszystkich źródeł
+    Intersection,   // tylko wspólny zakres czasu wszystkich niepustych źródeł
+    First           // oś czasu pierwszego źródła
+};
+
+// Złączenie kilku serii (np. jakości powietrza i pogody) w jedną szeroką serię na wspólnej osi czasu.
+// Osie źródeł muszą być posortowane (jak po AirQualityFrame::sortByTime) i w UTC. Złączenie jest
+// scalaniem posortowanych osi: dla każdego źródła jednokrotny przebieg dwoma wskaźnikami wyznacza
+// wiersz źródła dla każdego wiersza wyniku, a kolumny kopiowane są według tego odwzorowania.
+// Brak wiersza w źródle daje NaN; kolumny o tej samej nazwie są uzupełniane wartościami
+// późniejszych źródeł tam, gdzie wcześniejsze mają NaN. Metadane pochodzą z pierwszego źródła.
+AirQualityFrame joinFrames(const std::vector<JoinSource> &sources, JoinRange range = JoinRange::Union);
+
+#endif // FRAMEJOIN_H
@@ -0,0 +1,272 @@
+#include "gaps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const std::int64_t SecondsPerDay = 24 * 3600;
+
+size_t words(size_t rows) {
+    return (rows + 63) / 64;
+}
+
+// Pierwszy wiersz od from (włącznie) o bicie równym set; rows, gdy brak. Słowa bez szukanego
+// bitu pomijane są w całości.
+size_t nextRow(const std::vector<std::uint64_t> &bits, size_t from, size_t rows, bool set) {
+    if (from >= rows) return rows;
+    size_t w = from / 64;
+    std::uint64_t word = (set ? bits[w] : ~bits[w]) & (~0ull << (from % 64));
+    while (word == 0) {
+        if (++w >= bits.size()) return rows;
+        word = set ? bits[w] : ~bits[w];
+    }
+    return std::min(rows, w * 64 + static_cast<size_t>(__builtin_ctzll(word)));
+}
+
+void setRows(std::vector<std::uint64_t> &bits, size_t begin, size_t end) {
+    for (size_t row = begin; row < end; ++row) bits[row / 64] |= 1ull << (row % 64);
+}
+
+// Najmniejszy odstęp między kolejnymi pomiarami kolumny (0, gdy pomiarów jest mniej niż dwa)
+std::int64_t columnStep(const std::vector<std::int64_t> &time, const std::vector<double> &values, size_t rows) {
+    std::int64_t step = 0;
+    size_t previous = rows;
+    for (size_t i = 0; i < rows; ++i) {
+        if (std::isnan(values[i])) continue;
+        if (previous < rows) {
+            const std::int64_t delta = time[i] - time[previous];
+            if (delta > 0 && (step == 0 || delta < step)) step = delta;
+        }
+        previous = i;
+    }
+    return step;
+}
+
+} // namespace
+
+DenseFrame denseFrame(const AirQualityFrame &frame, std::int64_t step) {
+    DenseFrame dense;
+    if (frame.time.empty()) return dense;
+
+    std::int64_t frameStep = step > 0 ? step : smallestStep(frame);
+    if (frameStep <= 0) frameStep = 3600;
+    const std::int64_t first = frame.time.front(), last = frame.time.back();
+
+    for (const auto &[name, values] : frame.columns) {
+        const size_t rows = std::min(values.size(), frame.time.size());
+        DenseColumn &column = dense.columns[name];
+        column.step = step > 0 ? step : columnStep(frame.time, values, rows);
+        if (column.step <= 0) column.step = frameStep;
+
+        // Siatka przechodzi przez pierwszy pomiar kolumny i zaczyna się nie wcześniej niż seria
+        size_t firstValid = 0;
+        while (firstValid < rows && std::isnan(values[firstValid])) ++firstValid;
+        column.start = first;
+        if (firstValid < rows) {
+            const std::int64_t anchor = frame.time[firstValid];
+            column.start = anchor - (anchor - first) / column.step * column.step;
+        }
+        column.rows = static_cast<size_t>((last - column.start) / column.step) + 1;
+        column.values.assign(column.rows, 0.0);
+        column.valid.assign(words(column.rows), 0);
+        column.filled.assign(words(column.rows), 0);
+        for (size_t i = firstValid; i < rows; ++i) {
+            if (std::isnan(values[i])) continue;
+            const size_t row = static_cast<size_t>((frame.time[i] - column.start) / column.step);
+            column.values[row] = values[i];
+            column.valid[row / 64] |= 1ull << (row % 64);
+        }
+    }
+    return dense;
+}
+
+AirQualityFrame sparseFrame(const DenseFrame &dense, const AirQualityFrame &header) {
+    AirQualityFrame frame;
+    frame.location = header.location;
+    frame.station = header.station;
+    frame.timezone = header.timezone;
+    frame.latitude = header.latitude;
+    frame.longitude = header.longitude;
+
+    // Oś czasu: suma siatek kolumn (przy wspólnej siatce - po prostu ta siatka)
+    for (const auto &item : dense.columns) {
+        const DenseColumn &column = item.second;
+        const size_t size = frame.time.size();
+        for (size_t row = 0; row < column.rows; ++row) frame.time.push_back(column.timeAt(row));
+        std::inplace_merge(frame.time.begin(), frame.time.begin() + size, frame.time.end());
+        frame.time.erase(std::unique(frame.time.begin(), frame.time.end()), frame.time.end());
+    }
+
+    for (const auto &[name, column] : dense.columns) {
+        std::vector<double> &values = frame.columns[name];
+        values.assign(frame.time.size(), std::numeric_limits<double>::quiet_NaN());
+        auto position = frame.time.begin();
+        for (size_t w = 0; w < column.valid.size(); ++w) {
+            std::uint64_t word = column.valid[w] | column.filled[w];
+            for (; word; word &= word - 1) {
+                const size_t row = w * 64 + static_cast<size_t>(__builtin_ctzll(word));
+                position = std::lower_bound(position, frame.time.end(), column.timeAt(row));
+                values[static_cast<size_t>(position - frame.time.begin())] = column.values[row];
+            }
+        }
+    }
+    return frame;
+}
+
+GapStats analyzeGaps(const DenseColumn &column) {
+    const size_t rows = column.rows;
+    GapStats stats;
+    stats.rows = rows;
+    for (std::uint64_t word : column.valid) stats.present += static_cast<size_t>(__builtin_popcountll(word));
+
+    for (size_t from = 0;;) {
+        const size_t begin = nextRow(column.valid, from, rows, false);
+        if (begin >= rows) break;
+        const size_t end = nextRow(column.valid, begin, rows, true);
+        ++stats.gaps;
+        if (end - begin > stats.longestGap) {
+            stats.longestGap = end - begin;
+            stats.longestGapStart = begin;
+        }
+        from = end;
+    }
+    return stats;
+}
+
+MaskedSummary maskedSummary(const DenseColumn &column, const std::vector<Histogram *> &histograms) {
+    const size_t rows = column.rows;
+    double low = std::numeric_limits<double>::infinity();
+    double high = -std::numeric_limits<double>::infinity();
+    double sum = 0.0;
+    size_t count = 0;
+    const double *values = column.values.data();
+
+    // Pełne słowa (64 pomiary z rzędu) liczone są ciasną pętlą bez warunków, częściowe - po ustawionych
+    // bitach; pomiary słowa trafiają do histogramów jednym blokiem, póki są w pamięci podręcznej
+    double packed[64];
+    for (size_t w = 0; w < column.valid.size() && w * 64 < rows; ++w) {
+        std::uint64_t word = column.valid[w];
+        const double *block = values + w * 64;
+        if (word == ~0ull) {
+            double blockLow = block[0], blockHigh = block[0], blockSum = 0.0;
+            for (size_t k = 0; k < 64; ++k) {
+                blockLow = std::min(blockLow, block[k]);
+                blockHigh = std::max(blockHigh, block[k]);
+                blockSum += block[k];
+            }
+            low = std::min(low, blockLow);
+            high = std::max(high, blockHigh);
+            sum += blockSum;
+            count += 64;
+            for (Histogram *histogram : histograms) histogram->addBlock(block, 64);
+            continue;
+        }
+        size_t packedCount = 0;
+        for (; word; word &= word - 1) {
+            const double value = block[__builtin_ctzll(word)];
+            low = std::min(low, value);
+            high = std::max(high, value);
+            sum += value;
+            packed[packedCount++] = value;
+        }
+        count += packedCount;
+        for (Histogram *histogram : histograms) histogram->addBlock(packed, packedCount);
+    }
+
+    MaskedSummary summary;
+    summary.count = count;
+    if (count == 0) return summary;
+    summary.min = low;
+    summary.max = high;
+    summary.mean = sum / count;
+    return summary;
+}
+
+size_t maskedCountAbove(const DenseColumn &column, double threshold) {
+    const size_t rows = column.rows;
+    size_t count = 0;
+    const double *values = column.values.data();
+    for (size_t w = 0; w < column.valid.size() && w * 64 < rows; ++w) {
+        const double *block = values + w * 64;
+        std::uint64_t word = column.valid[w];
+        if (word == ~0ull) {
+            size_t above = 0;
+            for (size_t k = 0; k < 64; ++k) above += block[k] > threshold;
+            count += above;
+            continue;
+        }
+        for (; word; word &= word - 1) count += block[__builtin_ctzll(word)] > threshold;
+    }
+    return count;
+}
+
+size_t fillGaps(DenseColumn &column, GapFill method, size_t maxGap) {
+    const size_t rows = column.rows;
+    if (method == GapFill::None || rows < 3) return 0;
+
+    // Wcześniejsze uzupełnienie jest zastępowane
+    for (size_t w = 0; w < column.filled.size(); ++w)
+        for (std::uint64_t word = column.filled[w]; word; word &= word - 1)
+            column.values[w * 64 + static_cast<size_t>(__builtin_ctzll(word))] = 0.0;
+    std::fill(column.filled.begin(), column.filled.end(), 0);
+
+    // Składnik sezonowy: średnia pomiarów w tej samej porze doby (UTC); interpolowane są odchylenia
+    // od niego. Przy kroku, który nie dzieli doby, lub przy interpolacji liniowej składnik jest zerowy.
+    std::vector<double> season(rows, 0.0);
+    const std::int64_t period = column.step > 0 && SecondsPerDay % column.step == 0 ? SecondsPerDay / column.step : 0;
+    if (method == GapFill::Seasonal && period >= 2) {
+        const size_t first = static_cast<size_t>(((column.start / column.step) % period + period) % period);
+        std::vector<double> sums(static_cast<size_t>(period), 0.0);
+        std::vector<size_t> counts(static_cast<size_t>(period), 0);
+        double total = 0.0;
+        size_t present = 0;
+        for (size_t w = 0; w < column.valid.size(); ++w)
+            for (std::uint64_t word = column.valid[w]; word; word &= word - 1) {
+                const size_t row = w * 64 + static_cast<size_t>(__builtin_ctzll(word));
+                const size_t slot = (first + row) % static_cast<size_t>(period);
+                sums[slot] += column.values[row];
+                ++counts[slot];
+                total += column.values[row];
+                ++present;
+            }
+        if (present == 0) return 0;
+        for (size_t slot = 0; slot < sums.size(); ++slot)
+            sums[slot] = counts[slot] ? sums[slot] / counts[slot] : total / present;
+        for (size_t row = 0, slot = first; row < rows; ++row) {
+            season[row] = sums[slot];
+            if (++slot == sums.size()) slot = 0;
+        }
+    }
+
+    // Tylko luki z pomiarem po obu stronach; wnętrze luki to prosta pętla arytmetyczna (wektoryzowana)
+    size_t filledRows = 0;
+    double *values = column.values.data();
+    const double *seasonal = season.data();
+    for (size_t from = 0;;) {
+        const size_t begin = nextRow(column.valid, from, rows, false);
+        if (begin >= rows) break;
+        const size_t end = nextRow(column.valid, begin, rows, true);
+        from = end;
+        if (begin == 0 || end >= rows || (maxGap > 0 && end - begin > maxGap)) continue;
+
+        const size_t before = begin - 1;
+        const double left = values[before] - seasonal[before];
+        const double slope = (values[end] - seasonal[end] - left) / static_cast<double>(end - before);
+        for (size_t row = begin; row < end; ++row)
+            values[row] = seasonal[row] + left + slope * static_cast<double>(row - before);
+        setRows(column.filled, begin, end);
+        filledRows += end - begin;
+    }
+    return filledRows;
+}
+
+size_t fillGaps(DenseFrame &frame, GapFill method, std::int64_t maxGap) {
+    size_t filledRows = 0;
+    for (auto &item : frame.columns) {
+        DenseColumn &column = item.second;
+        filledRows += fillGaps(column, method, maxGap > 0 ? static_cast<size_t>(std::max<std::int64_t>(1, maxGap / column.step)) : 0);
+    }
+    return filledRows;
+}
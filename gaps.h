@@ -0,0 +1,92 @@
+#ifndef GAPS_H
+#define GAPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+#include "histogram.h"
+
+/*!
+ * \brief Kolumna na regularnej siatce czasu (start + i * step) z mapą bitową pomiarów obecnych w danych źródłowych
+ * \details Bit row % 64 słowa row / 64 mapy valid oznacza, że wiersz pochodzi z pomiaru. Wartości
+ * wierszy bez pomiaru są zerami albo wynikiem uzupełniania luk (oznaczonym w mapie filled) - mapa
+ * valid nie zmienia się przy uzupełnianiu, więc statystyki liczone z nią pomijają wartości uzupełnione.
+ */
+struct DenseColumn {
+    std::int64_t start = 0;
+    std::int64_t step = 0;
+    size_t rows = 0;
+    std::vector<double> values;
+    std::vector<std::uint64_t> valid;
+    std::vector<std::uint64_t> filled;
+
+    bool isValid(size_t row) const { return (valid[row / 64] >> (row % 64)) & 1u; }
+    bool isFilled(size_t row) const { return (filled[row / 64] >> (row % 64)) & 1u; }
+    std::int64_t timeAt(size_t row) const { return start + static_cast<std::int64_t>(row) * step; }
+};
+
+/*!
+ * \brief Seria lokalizacji wyrównana do regularnych siatek czasu
+ * \details Każda kolumna ma własną siatkę o kroku wyznaczonym z jej pomiarów, więc po złączeniu serii
+ * godzinowej z 15-minutową kolumny godzinowe nie mają trzech czwartych wierszy pustych. Siatka kolumny
+ * obejmuje cały zakres czasu serii; brakujące znaczniki stają się wierszami bez pomiaru, a znaczniki
+ * spoza siatki zaokrąglane są w dół do najbliższego wiersza.
+ */
+struct DenseFrame {
+    std::map<std::string, DenseColumn> columns;
+};
+
+// Statystyki luk jednej kolumny (długości w wierszach siatki)
+struct GapStats {
+    size_t rows = 0;
+    size_t present = 0;
+    size_t gaps = 0;
+    size_t longestGap = 0;
+    size_t longestGapStart = 0;
+
+    size_t missing() const { return rows - present; }
+    double coverage() const { return rows ? static_cast<double>(present) / rows : 0.0; }
+};
+
+// Podsumowanie kolumny liczone tylko z wierszy z pomiarem
+struct MaskedSummary {
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    size_t count = 0;
+};
+
+enum class GapFill {
+    None,
+    Linear,     // interpolacja liniowa między pomiarami na brzegach luki
+    Seasonal    // interpolacja liniowa odchyleń od średniego profilu dobowego
+};
+
+// Wyrównanie serii do siatek o kroku step (0 - dla każdej kolumny najmniejszy odstęp między jej pomiarami)
+DenseFrame denseFrame(const AirQualityFrame &frame, std::int64_t step = 0);
+
+// Powrót do serii kolumnowej z osią czasu będącą sumą siatek kolumn (opis lokalizacji z header);
+// wiersze bez pomiaru i bez uzupełnienia zapisywane są jako NaN
+AirQualityFrame sparseFrame(const DenseFrame &dense, const AirQualityFrame &header);
+
+GapStats analyzeGaps(const DenseColumn &column);
+
+// Podsumowanie w jednym przebiegu z dopisaniem pomiarów do histogramów (np. w skali liniowej i logarytmicznej)
+MaskedSummary maskedSummary(const DenseColumn &column, const std::vector<Histogram *> &histograms = {});
+
+// Liczba wierszy z pomiarem powyżej progu
+size_t maskedCountAbove(const DenseColumn &column, double threshold);
+
+// Uzupełnianie luk kolumny ograniczonych z obu stron pomiarami i nie dłuższych niż maxGap wierszy
+// (0 - bez ograniczenia); zwraca liczbę uzupełnionych wierszy
+size_t fillGaps(DenseColumn &column, GapFill method, size_t maxGap = 0);
+
+// Uzupełnienie luk wszystkich kolumn nie dłuższych niż maxGap sekund (0 - bez ograniczenia);
+// zwraca łączną liczbę uzupełnionych wierszy
+size_t fillGaps(DenseFrame &frame, GapFill method, std::int64_t maxGap = 0);
+
+#endif // GAPS_H
@@ -0,0 +1,238 @@
+#include "geocoder.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <fstream>
+
+using json = nlohmann::json;
+
+GeocodeEntry entryFromResult(const json &result) {
+    GeocodeEntry entry;
+    entry.name = QString::fromStdString(result.value("name", std::string()));
+    entry.country = QString::fromStdString(result.value("country", std::string()));
+    entry.region = QString::fromStdString(result.value("admin1", std::string()));
+    entry.latitude = result.value("latitude", 0.0);
+    entry.longitude = result.value("longitude", 0.0);
+    return entry;
+}
+
+QString normalizeAddress(const QString &address) {
+    const QString text = address.normalized(QString::NormalizationForm_C).simplified().toLower();
+    QStringList parts;
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+        QString trimmed = part.trimmed();
+        while (trimmed.endsWith('.')) trimmed.chop(1);
+        if (!trimmed.isEmpty()) parts.append(trimmed);
+    }
+    return parts.join(", ");
+}
+
+QUrl geocodeRequestUrl(const QString &address, int count) {
+    QStringList parts;
+    for (const QString &part : address.split(',', Qt::SkipEmptyParts))
+        if (!part.trimmed().isEmpty()) parts.append(part.trimmed());
+
+    // API wyszukuje po nazwie miejscowości, więc wysyłany jest pierwszy człon adresu
+    QString countryCode;
+    if (parts.size() > 1 && parts.last().size() == 2 && parts.last().at(0).isLetter() && parts.last().at(1).isLetter())
+        countryCode = parts.takeLast().toUpper();
+
+    QUrlQuery query;
+    query.addQueryItem("name", parts.isEmpty() ? address.trimmed() : parts.first());
+    query.addQueryItem("count", QString::number(count));
+    query.addQueryItem("language", "pl");
+    query.addQueryItem("format", "json");
+    if (!countryCode.isEmpty()) query.addQueryItem("countryCode", countryCode);
+
+    QUrl url("https://geocoding-api.open-meteo.com/v1/search");
+    url.setQuery(query);
+    return url;
+}
+
+bool GeocodeCache::load(const QString &fileName) {
+    std::ifstream file(fileName.toStdString());
+    if (!file.is_open()) return false;
+
+    try {
+        json data = json::parse(file);
+        for (auto it = data.begin(); it != data.end(); ++it) {
+            GeocodeEntry entry = entryFromResult(it.value());
+            entry.candidates = it.value().value("candidates", 1);
+            entry.ambiguous = it.value().value("ambiguous", false);
+            items.insert(QString::fromStdString(it.key()), entry);
+        }
+    } catch (const std::exception &) {
+        return false;
+    }
+    return true;
+}
+
+bool GeocodeCache::save(const QString &fileName) const {
+    json data = json::object();
+    for (auto it = items.begin(); it != items.end(); ++it) {
+        data[it.key().toStdString()] = {
+            {"name", it->name.toStdString()},
+            {"country", it->country.toStdString()},
+            {"admin1", it->region.toStdString()},
+            {"latitude", it->latitude},
+            {"longitude", it->longitude},
+            {"candidates", it->candidates},
+            {"ambiguous", it->ambiguous}
+        };
+    }
+
+    std::ofstream file(fileName.toStdString());
+    if (!file.is_open()) return false;
+    file << data.dump(2);
+    return file.good();
+}
+
+const GeocodeEntry *GeocodeCache::find(const QString &key) const {
+    auto it = items.constFind(key);
+    return it != items.constEnd() ? &it.value() : nullptr;
+}
+
+void GeocodeCache::insert(const QString &key, const GeocodeEntry &entry) {
+    items.insert(key, entry);
+}
+
+BulkGeocoder::BulkGeocoder(GeocodeCache &cache, QObject *parent) : QObject(parent),
+    cache(cache),
+    network(new QNetworkAccessManager(this)),
+    ticker(new QTimer(this)) {
+
+    ticker->setInterval(tickMilliseconds);
+    connect(ticker, &QTimer::timeout, this, &BulkGeocoder::dispatch);
+    connect(network, &QNetworkAccessManager::finished, this, &BulkGeocoder::handleReply);
+}
+
+void BulkGeocoder::setLimits(int concurrent, int perSecond) {
+    maxConcurrent = std::max(1, concurrent);
+    requestsPerSecond = std::max(1, perSecond);
+}
+
+void BulkGeocoder::start(const QStringList &addresses) {
+    // Zapytania poprzedniego wsadu są przerywane; handleReply pomija je po numerze wsadu
+    ++batch;
+    for (QNetworkReply *reply : network->findChildren<QNetworkReply *>())
+        if (reply->isRunning()) reply->abort();
+    inFlight = 0;
+    pausedTicks = 0;
+    requestBudget = 0.0;
+
+    resultList.clear();
+    rowsByKey.clear();
+    queue.clear();
+    resolvedKeys = 0;
+
+    for (const QString &address : addresses) {
+        const QString key = normalizeAddress(address);
+        if (key.isEmpty()) continue;
+
+        Result result;
+        result.address = address.trimmed();
+        QList<int> &rows = rowsByKey[key];
+        if (rows.isEmpty() && !cache.find(key)) queue.append(key);
+        rows.append(resultList.size());
+        resultList.append(result);
+    }
+    totalKeys = rowsByKey.size();
+
+    for (auto it = rowsByKey.cbegin(); it != rowsByKey.cend(); ++it)
+        if (const GeocodeEntry *entry = cache.find(it.key())) resolve(it.key(), entry, QString(), true);
+
+    emit progress(resolvedKeys, totalKeys);
+    ticker->start();
+    QTimer::singleShot(0, this, &BulkGeocoder::checkFinished);
+}
+
+void BulkGeocoder::cancel() {
+    queue.clear();
+    for (QNetworkReply *reply : network->findChildren<QNetworkReply *>())
+        reply->abort();
+    checkFinished();
+}
+
+void BulkGeocoder::dispatch() {
+    if (pausedTicks > 0) {
+        --pausedTicks;
+        return;
+    }
+
+    // Przydział narasta o część limitu na sekundę przypadającą na takt; niewykorzystany przechodzi dalej
+    // najwyżej o jedno zapytanie, więc po przestoju nie ma serii ponad limit
+    const double perTick = requestsPerSecond * tickMilliseconds / 1000.0;
+    requestBudget = std::min(requestBudget + perTick, perTick + 1.0);
+    while (!queue.isEmpty() && inFlight < maxConcurrent && requestBudget >= 1.0) {
+        const QString key = queue.takeFirst();
+        QNetworkReply *reply = network->get(QNetworkRequest(geocodeRequestUrl(key, 5)));
+        reply->setProperty("geocodeKey", key);
+        reply->setProperty("batch", batch);
+        ++inFlight;
+        requestBudget -= 1.0;
+    }
+}
+
+void BulkGeocoder::handleReply(QNetworkReply *reply) {
+    reply->deleteLater();
+    if (reply->property("batch").toInt() != batch) return;
+    --inFlight;
+    const QString key = reply->property("geocodeKey").toString();
+
+    // Przekroczony limit API: adres wraca na początek kolejki, wysyłanie wstrzymane na chwilę
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 429) {
+        queue.prepend(key);
+        pausedTicks = 1000 / tickMilliseconds;
+        requestBudget = 0.0;
+        return;
+    }
+
+    if (reply->error() != QNetworkReply::NoError) {
+        resolve(key, nullptr, reply->errorString());
+    } else {
+        try {
+            json response = json::parse(reply->readAll().toStdString());
+            if (!response.contains("results") || response["results"].empty()) {
+                resolve(key, nullptr, "Nie znaleziono lokalizacji");
+            } else {
+                const json &candidates = response["results"];
+                GeocodeEntry entry = entryFromResult(candidates[0]);
+                entry.candidates = static_cast<int>(candidates.size());
+                for (size_t i = 1; i < candidates.size() && !entry.ambiguous; ++i) {
+                    const GeocodeEntry other = entryFromResult(candidates[i]);
+                    entry.ambiguous = other.name.compare(entry.name, Qt::CaseInsensitive) == 0
+                                      && (other.region != entry.region || other.country != entry.country);
+                }
+                cache.insert(key, entry);
+                resolve(key, &entry, QString());
+            }
+        } catch (const std::exception &e) {
+            resolve(key, nullptr, QString("Błąd przetwarzania danych: %1").arg(e.what()));
+        }
+    }
+    checkFinished();
+}
+
+void BulkGeocoder::resolve(const QString &key, const GeocodeEntry *entry, const QString &error, bool fromCache) {
+    for (int row : rowsByKey.value(key)) {
+        Result &result = resultList[row];
+        result.found = entry != nullptr;
+        result.fromCache = fromCache;
+        result.error = error;
+        if (entry) result.entry = *entry;
+    }
+    ++resolvedKeys;
+    emit progress(resolvedKeys, totalKeys);
+}
+
+void BulkGeocoder::checkFinished() {
+    if (!queue.isEmpty() || inFlight > 0 || !ticker->isActive()) return;
+    ticker->stop();
+    emit finished();
+}
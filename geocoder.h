@@ -0,0 +1,109 @@
+#ifndef GEOCODER_H
+#define GEOCODER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QUrl>
+
+#include <nlohmann/json.hpp>
+
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+struct GeocodeEntry {
+    QString name;
+    QString country;
+    QString region;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    int candidates = 1;
+    bool ambiguous = false;
+};
+
+// Ujednolicenie adresu do klucza pamięci podręcznej (NFC, małe litery, pojedyncze spacje, ", " jako separator)
+QString normalizeAddress(const QString &address);
+
+// Adres zapytania do Open-Meteo Geocoding API; końcowy człon "XX" traktowany jest jako kod kraju
+QUrl geocodeRequestUrl(const QString &address, int count);
+
+// Wpis z elementu tablicy "results" odpowiedzi Geocoding API (lub wpisu zapisanej pamięci podręcznej)
+GeocodeEntry entryFromResult(const nlohmann::json &result);
+
+/*!
+ * \brief Trwała pamięć podręczna wyników geokodowania
+ * \details Wpisy indeksowane są znormalizowanym adresem i zapisywane w pliku JSON, dzięki czemu
+ * ponowne wyszukanie tego samego adresu nie wymaga zapytania do API.
+ */
+class GeocodeCache {
+public:
+    bool load(const QString &fileName);
+    bool save(const QString &fileName) const;
+
+    const GeocodeEntry *find(const QString &key) const;
+    void insert(const QString &key, const GeocodeEntry &entry);
+    const QHash<QString, GeocodeEntry> &entries() const { return items; }
+
+private:
+    QHash<QString, GeocodeEntry> items;
+};
+
+/*!
+ * \brief Zbiorcze geokodowanie list adresów
+ * \details Adresy są normalizowane i deduplikowane, trafienia z pamięci podręcznej rozwiązywane
+ * od razu, a pozostałe wysyłane równolegle: w każdym takcie zegara tyle zapytań, ile pozwala
+ * limit zapytań w locie i budżet zapytań na sekundę (przydział narastający co takt). Wynik jest niejednoznaczny, gdy API zwraca kilka miejscowości o tej samej nazwie
+ * w różnych regionach lub krajach - wybierany jest wtedy pierwszy (najtrafniejszy) kandydat.
+ * Ponowne start() przerywa zapytania poprzedniego wsadu; ich odpowiedzi są pomijane.
+ */
+class BulkGeocoder : public QObject {
+    Q_OBJECT
+
+public:
+    struct Result {
+        QString address;
+        bool found = false;
+        bool fromCache = false;
+        GeocodeEntry entry;
+        QString error;
+    };
+
+    BulkGeocoder(GeocodeCache &cache, QObject *parent = nullptr);
+
+    void setLimits(int maxConcurrent, int requestsPerSecond);
+    void start(const QStringList &addresses);
+    void cancel();
+    const QList<Result> &results() const { return resultList; }
+
+signals:
+    void progress(int done, int total);
+    void finished();
+
+private slots:
+    void dispatch();
+    void handleReply(QNetworkReply *reply);
+
+private:
+    void resolve(const QString &key, const GeocodeEntry *entry, const QString &error, bool fromCache = false);
+    void checkFinished();
+
+    GeocodeCache &cache;
+    QNetworkAccessManager *network;
+    QTimer *ticker;
+    QList<Result> resultList;
+    QHash<QString, QList<int>> rowsByKey;
+    QStringList queue;
+    const int tickMilliseconds = 250;
+    int maxConcurrent = 8;
+    int requestsPerSecond = 10;
+    double requestBudget = 0.0;     // zapytania, które można jeszcze wysłać w ramach limitu na sekundę
+    int inFlight = 0;
+    int resolvedKeys = 0;
+    int totalKeys = 0;
+    int pausedTicks = 0;
+    int batch = 0;
+};
+
+#endif // GEOCODER_H
@@ -0,0 +1,286 @@
+#include "heatmap.h"
+
+#include <QComboBox>
+#include <QDateTime>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QPainter>
+#include <QPushButton>
+#include <QSlider>
+#include <QSpinBox>
+#include <QTimeZone>
+#include <QVBoxLayout>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+#include "openmeteo.h"
+#include "pollutants.h"
+
+namespace {
+
+const int BlockWidth = 8;
+const int RowsPerTask = 16;
+
+// Skala kolorów od zielonego (czyste powietrze) do fioletowego (wartości powyżej zakresu)
+QRgb colorFor(float fraction) {
+    static const QColor stops[] = {QColor(0, 160, 60), QColor(240, 220, 0), QColor(245, 130, 0),
+                                   QColor(220, 20, 30), QColor(120, 0, 120)};
+    const float position = std::clamp(fraction, 0.0f, 1.0f) * 4.0f;
+    const int index = std::min(static_cast<int>(position), 3);
+    const float t = position - index;
+    const QColor &a = stops[index], &b = stops[index + 1];
+    return qRgba(static_cast<int>(a.red() + (b.red() - a.red()) * t),
+                 static_cast<int>(a.green() + (b.green() - a.green()) * t),
+                 static_cast<int>(a.blue() + (b.blue() - a.blue()) * t), 210);
+}
+
+// Górna granica skali kolorów dla parametru
+float scaleFor(const std::string &parameter) {
+    const Pollutant *pollutant = findPollutant(parameter);
+    return pollutant ? static_cast<float>(pollutant->scaleMax) : 100.0f;
+}
+
+} // namespace
+
+void interpolateIdwRows(const IdwSamples &samples, int width, int rowBegin, int rowEnd, float *raster) {
+    const size_t count = samples.value.size();
+    std::vector<float> dy2(count);
+
+    for (int row = rowBegin; row < rowEnd; ++row) {
+        const float py = row + 0.5f;
+        for (size_t i = 0; i < count; ++i) {
+            const float dy = py - samples.y[i];
+            dy2[i] = dy * dy;
+        }
+
+        // Blok kolejnych pikseli liczony jednocześnie: pętla wewnętrzna bez rozgałęzień, gotowa do wektoryzacji
+        for (int x0 = 0; x0 < width; x0 += BlockWidth) {
+            float numerator[BlockWidth] = {};
+            float denominator[BlockWidth] = {};
+            for (size_t i = 0; i < count; ++i) {
+                const float sx = samples.x[i], sdy2 = dy2[i], value = samples.value[i];
+                for (int k = 0; k < BlockWidth; ++k) {
+                    const float dx = (x0 + k + 0.5f) - sx;
+                    const float weight = 1.0f / (dx * dx + sdy2 + 1e-3f);
+                    numerator[k] += weight * value;
+                    denominator[k] += weight;
+                }
+            }
+            const int limit = std::min(BlockWidth, width - x0);
+            float *out = raster + static_cast<size_t>(row) * width + x0;
+            for (int k = 0; k < limit; ++k)
+                out[k] = denominator[k] > 0.0f ? numerator[k] / denominator[k] : std::nanf("");
+        }
+    }
+}
+
+void HeatmapView::setImage(const QImage &newImage, const QList<QPointF> &newPoints) {
+    image = newImage;
+    points = newPoints;
+    update();
+}
+
+void HeatmapView::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+    if (image.isNull()) return;
+
+    const QSize size = image.size().scaled(this->size(), Qt::KeepAspectRatio);
+    const QRect target(QPoint((width() - size.width()) / 2, (height() - size.height()) / 2), size);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawImage(target, image);
+
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    for (const QPointF &point : points)
+        painter.drawEllipse(QPointF(target.left() + point.x() * target.width(),
+                                    target.top() + point.y() * target.height()), 2.0, 2.0);
+}
+
+HeatmapWindow::HeatmapWindow(QWidget *parent) : QWidget(parent, Qt::Window),
+    network(new QNetworkAccessManager(this)) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    bboxInput = new QLineEdit("49.0, 14.1, 54.9, 24.2");
+    bboxInput->setToolTip("Szerokość min, długość min, szerokość max, długość max");
+    form->addRow("Obszar:", bboxInput);
+
+    gridSize = new QSpinBox();
+    gridSize->setRange(2, 40);
+    gridSize->setValue(12);
+    form->addRow("Punkty siatki na bok:", gridSize);
+
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    form->addRow("Parametr:", parameterSelector);
+    layout->addLayout(form);
+
+    QPushButton *fetchButton = new QPushButton("Pobierz siatkę");
+    layout->addWidget(fetchButton);
+
+    QHBoxLayout *sliderLayout = new QHBoxLayout();
+    hourSlider = new QSlider(Qt::Horizontal);
+    hourSlider->setEnabled(false);
+    hourLabel = new QLabel();
+    sliderLayout->addWidget(hourSlider);
+    sliderLayout->addWidget(hourLabel);
+    layout->addLayout(sliderLayout);
+
+    view = new HeatmapView();
+    layout->addWidget(view, 1);
+
+    connect(fetchButton, &QPushButton::clicked, this, &HeatmapWindow::fetchGrid);
+    connect(network, &QNetworkAccessManager::finished, this, &HeatmapWindow::handleReply);
+    connect(hourSlider, &QSlider::valueChanged, this, &HeatmapWindow::render);
+    connect(parameterSelector, &QComboBox::currentIndexChanged, this, &HeatmapWindow::render);
+
+    setWindowTitle("Mapa zanieczyszczeń");
+    resize(900, 900);
+}
+
+void HeatmapWindow::fetchGrid() {
+    const QStringList parts = bboxInput->text().split(',', Qt::SkipEmptyParts);
+    bool ok = parts.size() == 4;
+    double values[4] = {};
+    for (int i = 0; i < 4 && ok; ++i) values[i] = parts[i].trimmed().toDouble(&ok);
+    if (!ok || values[0] >= values[2] || values[1] >= values[3]) {
+        QMessageBox::warning(this, "Błąd", "Podaj obszar jako 'szer. min, dł. min, szer. max, dł. max'");
+        return;
+    }
+    latMin = values[0];
+    lonMin = values[1];
+    latMax = values[2];
+    lonMax = values[3];
+
+    // Wysokość rastra dobrana tak, by piksel miał te same wymiary w obu kierunkach
+    const double midLat = (latMin + latMax) / 2.0 * 3.14159265358979323846 / 180.0;
+    const double aspect = (latMax - latMin) / ((lonMax - lonMin) * std::cos(midLat));
+    rasterHeight = std::clamp(static_cast<int>(RasterWidth * aspect), 50, 4 * RasterWidth);
+
+    const int n = gridSize->value();
+    gridPoints.clear();
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            gridPoints.push_back({latMin + (latMax - latMin) * i / (n - 1), lonMin + (lonMax - lonMin) * j / (n - 1)});
+    gridFrames.assign(gridPoints.size(), AirQualityFrame());
+    imageCache.clear();
+    cacheOrder.clear();
+    hourSlider->setEnabled(false);
+
+    // Odpowiedzi poprzedniego pobrania (inny obszar lub siatka) są odrzucane po numerze pobrania
+    ++fetchSerial;
+    pendingRequests = 0;
+    for (size_t offset = 0; offset < gridPoints.size(); offset += PointsPerRequest) {
+        const size_t end = std::min(gridPoints.size(), offset + PointsPerRequest);
+        std::vector<GeoPoint> batch(gridPoints.begin() + offset, gridPoints.begin() + end);
+        QNetworkReply *reply = network->get(QNetworkRequest(airQualityRequestUrl(batch)));
+        reply->setProperty("gridOffset", static_cast<qulonglong>(offset));
+        reply->setProperty("fetchSerial", fetchSerial);
+        ++pendingRequests;
+    }
+}
+
+void HeatmapWindow::handleReply(QNetworkReply *reply) {
+    reply->deleteLater();
+    if (reply->property("fetchSerial").toInt() != fetchSerial) return;
+    --pendingRequests;
+    if (reply->error() != QNetworkReply::NoError) {
+        QMessageBox::critical(this, "Błąd sieci", reply->errorString());
+        return;
+    }
+
+    try {
+        const QByteArray data = reply->readAll();
+        size_t index = reply->property("gridOffset").toULongLong();
+        for (AirQualityFrame &frame : framesFromJsonText(data.constData(), data.size()))
+            if (index < gridFrames.size()) gridFrames[index++] = std::move(frame);
+    } catch (const std::exception &e) {
+        QMessageBox::critical(this, "Błąd", QString("Błąd przetwarzania danych: %1").arg(e.what()));
+        return;
+    }
+
+    if (pendingRequests > 0 || gridFrames.empty() || gridFrames.front().time.empty()) return;
+    hourSlider->setRange(0, static_cast<int>(gridFrames.front().time.size()) - 1);
+    hourSlider->setEnabled(true);
+    render();
+}
+
+void HeatmapWindow::render() {
+    if (!hourSlider->isEnabled() || gridFrames.empty()) return;
+
+    const size_t timeIndex = static_cast<size_t>(hourSlider->value());
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+    if (timeIndex < gridFrames.front().time.size())
+        hourLabel->setText(QDateTime::fromSecsSinceEpoch(gridFrames.front().time[timeIndex], QTimeZone::utc())
+                               .toString("dd.MM hh:mm 'UTC'"));
+
+    const QString key = QString("%1:%2").arg(QString::fromStdString(parameter)).arg(timeIndex);
+    auto cached = imageCache.constFind(key);
+    QImage image;
+    if (cached != imageCache.constEnd()) {
+        image = cached.value();
+        cacheOrder.removeOne(key);
+    } else {
+        image = renderImage(parameter, timeIndex);
+        imageCache.insert(key, image);
+        if (cacheOrder.size() >= MaxCachedImages) imageCache.remove(cacheOrder.takeFirst());
+    }
+    cacheOrder.append(key);
+
+    QList<QPointF> points;
+    for (const GeoPoint &point : gridPoints)
+        points.append(QPointF((point.longitude - lonMin) / (lonMax - lonMin), (latMax - point.latitude) / (latMax - latMin)));
+    view->setImage(image, points);
+}
+
+QImage HeatmapWindow::renderImage(const std::string &parameter, size_t timeIndex) {
+    IdwSamples samples;
+    for (size_t i = 0; i < gridFrames.size(); ++i) {
+        auto column = gridFrames[i].columns.find(parameter);
+        if (column == gridFrames[i].columns.end() || timeIndex >= column->second.size()) continue;
+        const double value = column->second[timeIndex];
+        if (std::isnan(value)) continue;
+        samples.x.push_back(static_cast<float>((gridPoints[i].longitude - lonMin) / (lonMax - lonMin) * RasterWidth));
+        samples.y.push_back(static_cast<float>((latMax - gridPoints[i].latitude) / (latMax - latMin) * rasterHeight));
+        samples.value.push_back(static_cast<float>(value));
+    }
+
+    QImage image(RasterWidth, rasterHeight, QImage::Format_ARGB32);
+    if (samples.value.empty()) {
+        image.fill(Qt::transparent);
+        return image;
+    }
+
+    // Pasy wierszy liczone równolegle; każde zadanie zapisuje tylko swój fragment rastra i obrazu
+    std::vector<float> raster(static_cast<size_t>(RasterWidth) * rasterHeight);
+    QList<int> bands;
+    for (int row = 0; row < rasterHeight; row += RowsPerTask) bands.append(row);
+
+    // Wskaźnik do pikseli pobierany raz w wątku głównym: scanLine() w wątkach roboczych wywołuje detach()
+    uchar *bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+    const float scale = scaleFor(parameter);
+    QtConcurrent::blockingMap(bands, [&](int rowBegin) {
+        const int rowEnd = std::min(rowBegin + RowsPerTask, rasterHeight);
+        interpolateIdwRows(samples, RasterWidth, rowBegin, rowEnd, raster.data());
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            QRgb *line = reinterpret_cast<QRgb *>(bits + row * bytesPerLine);
+            const float *values = raster.data() + static_cast<size_t>(row) * RasterWidth;
+            for (int x = 0; x < RasterWidth; ++x)
+                line[x] = std::isnan(values[x]) ? qRgba(0, 0, 0, 0) : colorFor(values[x] / scale);
+        }
+    });
+    return image;
+}
@@ -0,0 +1,93 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <QHash>
+#include <QImage>
+#include <QWidget>
+
+#include <vector>
+
+#include "airqualityframe.h"
+#include "spatialindex.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QSlider;
+class QSpinBox;
+
+// Punkty pomiarowe w układzie pikseli rastra, przechowywane kolumnowo
+struct IdwSamples {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> value;
+};
+
+// Interpolacja odwrotnymi odległościami (wykładnik 2) dla wierszy [rowBegin, rowEnd) rastra
+void interpolateIdwRows(const IdwSamples &samples, int width, int rowBegin, int rowEnd, float *raster);
+
+/*!
+ * \brief Widżet wyświetlający gotowy obraz mapy cieplnej wraz z punktami siatki
+ */
+class HeatmapView : public QWidget {
+public:
+    explicit HeatmapView(QWidget *parent = nullptr) : QWidget(parent) { setMinimumSize(400, 400); }
+
+    // Punkty w układzie znormalizowanym (0..1) względem obrazu
+    void setImage(const QImage &image, const QList<QPointF> &points);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QImage image;
+    QList<QPointF> points;
+};
+
+/*!
+ * \brief Okno mapy cieplnej zanieczyszczeń dla obszaru
+ * \details Dla prostokąta współrzędnych pobierana jest siatka punktów (wiele punktów w jednym
+ * zapytaniu do API), a wartości wybranej godziny interpolowane są metodą IDW na raster.
+ * Raster liczony jest równolegle pasami wierszy, a gotowe obrazy dla ostatnio oglądanych
+ * godzin przechowywane są w pamięci podręcznej, więc przesuwanie suwaka czasu nie wymaga
+ * ponownej interpolacji.
+ */
+class HeatmapWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit HeatmapWindow(QWidget *parent = nullptr);
+
+private slots:
+    void fetchGrid();
+    void handleReply(QNetworkReply *reply);
+    void render();
+
+private:
+    QImage renderImage(const std::string &parameter, size_t timeIndex);
+
+    static const int RasterWidth = 1000;
+    static const int PointsPerRequest = 100;
+    static const int MaxCachedImages = 16;
+
+    QLineEdit *bboxInput;
+    QSpinBox *gridSize;
+    QComboBox *parameterSelector;
+    QSlider *hourSlider;
+    QLabel *hourLabel;
+    HeatmapView *view;
+    QNetworkAccessManager *network;
+
+    std::vector<GeoPoint> gridPoints;
+    std::vector<AirQualityFrame> gridFrames;
+    int pendingRequests = 0;
+    int fetchSerial = 0;
+    double latMin = 0, latMax = 0, lonMin = 0, lonMax = 0;
+    int rasterHeight = RasterWidth;
+    QHash<QString, QImage> imageCache;
+    QStringList cacheOrder;
+};
+
+#endif // HEATMAP_H
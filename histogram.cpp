@@ -0,0 +1,153 @@
+#include "histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "pollutants.h"
+
+namespace {
+
+const size_t BlockValues = 256;
+const int LinearBins = 40;
+const double LogLow = 0.01;
+const int LogDecades = 7;
+const int BinsPerDecade = 10;
+
+// Blok czasu zawierający znacznik (dzielenie z zaokrągleniem w dół także dla czasów sprzed 1970)
+std::int64_t blockStart(std::int64_t time) {
+    const std::int64_t size = HistogramArchive::BlockSeconds;
+    return (time >= 0 ? time : time - size + 1) / size * size;
+}
+
+} // namespace
+
+Histogram::Histogram(HistogramScale scale, double low, double high, int bins)
+    : kind(scale), low(low), high(high), binCount(bins), counts(static_cast<size_t>(bins) + 3, 0) {
+    factor = scale == HistogramScale::Log ? bins / std::log(high / low) : bins / (high - low);
+}
+
+void Histogram::add(double value) {
+    addBlock(&value, 1);
+}
+
+void Histogram::addBlock(const double *values, size_t count) {
+    if (binCount == 0) return;
+    const double lastSlot = binCount + 1;
+    const std::int32_t skipped = binCount + 2;
+    std::int32_t index[BlockValues];
+
+    for (size_t begin = 0; begin < count; begin += BlockValues) {
+        const size_t n = std::min(BlockValues, count - begin);
+        const double *block = values + begin;
+
+        // Indeks 0 - niedomiar, binCount + 1 - nadmiar, binCount + 2 - NaN
+        if (kind == HistogramScale::Log) {
+            for (size_t i = 0; i < n; ++i) {
+                const double position = block[i] >= low ? std::log(block[i] / low) * factor + 1.0 : 0.0;
+                const std::int32_t bin = static_cast<std::int32_t>(std::min(position, lastSlot));
+                index[i] = block[i] == block[i] ? bin : skipped;
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                const double position = block[i] >= low ? (block[i] - low) * factor + 1.0 : 0.0;
+                const std::int32_t bin = static_cast<std::int32_t>(std::min(position, lastSlot));
+                index[i] = block[i] == block[i] ? bin : skipped;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) ++counts[static_cast<size_t>(index[i])];
+    }
+}
+
+bool Histogram::sameBins(const Histogram &other) const {
+    return kind == other.kind && binCount == other.binCount && low == other.low && high == other.high;
+}
+
+bool Histogram::merge(const Histogram &other) {
+    if (!sameBins(other)) return false;
+    for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+    return true;
+}
+
+std::uint64_t Histogram::total() const {
+    return counts.empty() ? 0 : std::accumulate(counts.begin(), counts.end() - 1, std::uint64_t{0});
+}
+
+double Histogram::lowerEdge(int bin) const {
+    if (kind == HistogramScale::Log) return low * std::exp(bin / factor);
+    return low + bin / factor;
+}
+
+double Histogram::quantile(double q) const {
+    const std::uint64_t samples = total();
+    if (samples == 0) return std::numeric_limits<double>::quiet_NaN();
+    const double target = std::clamp(q, 0.0, 1.0) * static_cast<double>(samples);
+    double seen = static_cast<double>(underflow());
+    if (target <= seen) return low;
+    for (int bin = 0; bin < binCount; ++bin) {
+        const double inBin = static_cast<double>(count(bin));
+        if (inBin > 0 && target <= seen + inBin) {
+            const double fraction = (target - seen) / inBin;
+            const double a = lowerEdge(bin), b = upperEdge(bin);
+            return kind == HistogramScale::Log ? a * std::pow(b / a, fraction) : a + (b - a) * fraction;
+        }
+        seen += inBin;
+    }
+    return high;
+}
+
+Histogram parameterHistogram(std::string_view apiName, HistogramScale scale) {
+    const Pollutant *pollutant = findPollutant(apiName);
+    if (!pollutant) return Histogram();
+    if (scale == HistogramScale::Log)
+        return Histogram(HistogramScale::Log, LogLow, LogLow * std::pow(10.0, LogDecades), LogDecades * BinsPerDecade);
+    return Histogram(HistogramScale::Linear, 0.0, 2.0 * pollutant->scaleMax, LinearBins);
+}
+
+HistogramArchive::HistogramArchive(std::string_view apiName)
+    : parameter(apiName),
+      emptyLinear(parameterHistogram(apiName, HistogramScale::Linear)),
+      emptyLog(parameterHistogram(apiName, HistogramScale::Log)) {}
+
+void HistogramArchive::update(const AirQualityFrame &frame) {
+    static const std::vector<double> empty;
+    auto column = frame.columns.find(parameter);
+    const std::vector<double> &values = column != frame.columns.end() ? column->second : empty;
+    const std::vector<std::int64_t> &time = frame.time;
+
+    // Przeliczane są bloki od bloku zawierającego najwcześniejszy zmieniony znacznik
+    const std::optional<std::int64_t> changed = frame.changedSince(scannedRevision);
+    scannedRevision = frame.revision;
+    if (!changed) return;
+    if (*changed == AirQualityFrame::ChangedAll) {
+        stored.clear();
+        buildFrom(0, time, values);
+        return;
+    }
+    const std::int64_t reopened = blockStart(*changed);
+    while (!stored.empty() && stored.back().start >= reopened) stored.pop_back();
+    buildFrom(std::lower_bound(time.begin(), time.end(), reopened) - time.begin(), time, values);
+}
+
+void HistogramArchive::buildFrom(size_t row, const std::vector<std::int64_t> &time, const std::vector<double> &values) {
+    const size_t rows = std::min(time.size(), values.size());
+    while (row < rows) {
+        const std::int64_t start = blockStart(time[row]);
+        const size_t end = std::lower_bound(time.begin() + row, time.begin() + rows, start + BlockSeconds) - time.begin();
+        Block block{start, emptyLinear, emptyLog};
+        block.linear.addBlock(values.data() + row, end - row);
+        block.log.addBlock(values.data() + row, end - row);
+        stored.push_back(std::move(block));
+        row = end;
+    }
+}
+
+Histogram HistogramArchive::histogram(HistogramScale scale, std::int64_t from, std::int64_t to) const {
+    Histogram result = scale == HistogramScale::Log ? emptyLog : emptyLinear;
+    auto first = std::lower_bound(stored.begin(), stored.end(), blockStart(from),
+                                  [](const Block &block, std::int64_t start) { return block.start < start; });
+    for (auto it = first; it != stored.end() && it->start < to; ++it)
+        result.merge(scale == HistogramScale::Log ? it->log : it->linear);
+    return result;
+}
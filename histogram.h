@@ -0,0 +1,99 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "airqualityframe.h"
+
+enum class HistogramScale { Linear, Log };
+
+/*!
+ * \brief Histogram o stałych przedziałach: równych albo logarytmicznych (równych w skali log)
+ * \details Poza przedziałami [low, high) liczone są osobno wartości mniejsze (niedomiar, dla skali
+ * logarytmicznej także zera i wartości ujemne) i nie mniejsze od high (nadmiar). Histogramy
+ * o tych samych przedziałach można scalać, więc wyniki liczone osobno dla bloków danych
+ * i lokalizacji składają się w histogram całości.
+ * addBlock() wyznacza najpierw indeksy przedziałów całego bloku (pętla bez rozgałęzień,
+ * wektoryzowana przez kompilator), a dopiero potem zlicza; wartości NaN są pomijane.
+ */
+class Histogram {
+public:
+    Histogram() = default;
+    Histogram(HistogramScale scale, double low, double high, int bins);
+
+    void add(double value);
+    void addBlock(const double *values, size_t count);
+
+    // Dodanie zliczeń histogramu o tych samych przedziałach; false (bez zmian), gdy przedziały są inne
+    bool merge(const Histogram &other);
+    bool sameBins(const Histogram &other) const;
+
+    HistogramScale scale() const { return kind; }
+    int bins() const { return binCount; }
+    double lowerEdge(int bin) const;
+    double upperEdge(int bin) const { return lowerEdge(bin + 1); }
+    std::uint64_t count(int bin) const { return counts[static_cast<size_t>(bin) + 1]; }
+    std::uint64_t underflow() const { return binCount ? counts.front() : 0; }
+    std::uint64_t overflow() const { return binCount ? counts[static_cast<size_t>(binCount) + 1] : 0; }
+    std::uint64_t total() const;
+
+    // Kwantyl z interpolacją wewnątrz przedziału (geometryczną dla skali logarytmicznej);
+    // niedomiar i nadmiar przyjmują wartości granic low i high, NaN dla pustego histogramu
+    double quantile(double q) const;
+
+private:
+    HistogramScale kind = HistogramScale::Linear;
+    double low = 0.0;
+    double high = 0.0;
+    int binCount = 0;
+    double factor = 0.0;    // przedziały na jednostkę (dla skali logarytmicznej - na jednostkę ln)
+    std::vector<std::uint64_t> counts;  // [niedomiar, przedziały..., nadmiar, pominięte NaN]
+};
+
+// Histogram o przedziałach wspólnych dla wszystkich lokalizacji parametru z tabeli pollutants
+// (warunek scalania); pusty (bins() == 0) dla pozostałych parametrów
+Histogram parameterHistogram(std::string_view apiName, HistogramScale scale);
+
+/*!
+ * \brief Archiwum histogramów serii w blokach czasu o stałej długości
+ * \details Histogram dowolnego okresu wieloletniego archiwum składany jest z zapisanych histogramów
+ * bloków, bez ponownego przeglądania pomiarów. update() przelicza tylko bloki od najwcześniejszego
+ * znacznika zmienionego od poprzedniego wywołania (dziennik rewizji serii z LocationStore) - po
+ * dopisaniu danych ostatni i nowe bloki, po poprawkach także bloki poprawionych wierszy.
+ */
+class HistogramArchive {
+public:
+    static const std::int64_t BlockSeconds = 30 * 24 * 3600;
+
+    HistogramArchive() = default;
+    explicit HistogramArchive(std::string_view apiName);
+
+    // Aktualizacja dla kolumny parametru archiwum w serii
+    void update(const AirQualityFrame &frame);
+
+    // Scalony histogram bloków zaczynających się w [from, to) - granice okresu zaokrąglane są do bloków
+    Histogram histogram(HistogramScale scale, std::int64_t from, std::int64_t to) const;
+
+    size_t blocks() const { return stored.size(); }
+
+private:
+    struct Block {
+        std::int64_t start;
+        Histogram linear;
+        Histogram log;
+    };
+
+    void buildFrom(size_t row, const std::vector<std::int64_t> &time, const std::vector<double> &values);
+
+    std::string parameter;
+    Histogram emptyLinear;
+    Histogram emptyLog;
+    std::vector<Block> stored;
+    std::uint64_t scannedRevision = 0;
+};
+
+#endif // HISTOGRAM_H
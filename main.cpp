@@ -26,7 +26,17 @@ public:
         chartView(new QChartView(this)) {
 
         setupUI();
+        geocodeCache.load(geocodeCacheFile);
+        addressCompleter = new AddressCompleter(addressInput, geocodeCache, this);
         connect(networkManager, &QNetworkAccessManager::finished, this, &WeatherApp::handleNetworkReply);
+        connect(&statsWatcher, &QFutureWatcher<std::vector<StatsRow>>::finished, this, &WeatherApp::statsComputed);
+        setupAlerts();
+    }
+
+    ~WeatherApp() {
+        // Obliczenia w tle zapisują do śledzenia przekroczeń - muszą się zakończyć przed jego usunięciem
+        statsWatcher.cancel();
+        statsWatcher.waitForFinished();
     }
 
 private slots:
@@ -38,12 +48,50 @@ private slots:
             return;
         }
 
-        QString geocodeUrl = QString("https://geocoding-api.open-meteo.com/v1/search?name=%1&count=1").arg(address);
-        networkManager->get(QNetworkRequest(QUrl(geocodeUrl)));
+        addressCompleter->addLocation(address);
+
+        // Adres znaleziony wcześniej (także wybrana podpowiedź) nie wymaga ponownego geokodowania
+        const QString key = normalizeAddress(address);
+        if (const GeocodeEntry *entry = addressCompleter->find(address)) {
+            currentLocation = entry->name;
+            currentCountry = entry->country;
+            requestAirQuality(entry->latitude, entry->longitude);
+            return;
+        }
+
+        QNetworkReply *reply = networkManager->get(QNetworkRequest(geocodeRequestUrl(address, 1)));
+        reply->setProperty("geocodeKey", key);
+    }
+
+    // Funkcja tworząca zapytanie o jakość powietrza dla podanych współrzędnych
+    void requestAirQuality(double lat, double lon) {
+        // Dane pogodowe pobierane są równolegle i dołączane do serii jakości powietrza
+        ++requestSerial;
+        pendingAirQuality.reset();
+        pendingWeather.reset();
+        const auto resolution = static_cast<Resolution>(resolutionSelector->currentData().toInt());
+        for (const QUrl &url : {airQualityRequestUrl(lat, lon), weatherRequestUrl(lat, lon, resolution)}) {
+            QNetworkReply *reply = networkManager->get(QNetworkRequest(url));
+            reply->setProperty("requestSerial", requestSerial);
+        }
     }
 
     // Funkcja pobierająca dane
     void handleNetworkReply(QNetworkReply *reply) {
+        const bool weatherReply = reply->url().host() == "api.open-meteo.com";
+        if (reply->property("requestSerial").isValid() && reply->property("requestSerial").toInt() != requestSerial) {
+            reply->deleteLater();
+            return;
+        }
+
+        // Brak danych pogodowych nie blokuje wyświetlenia jakości powietrza
+        if (weatherReply && reply->error() != QNetworkReply::NoError) {
+            reply->deleteLater();
+            pendingWeather = AirQualityFrame();
+            displayJoinedData();
+            return;
+        }
+
         if (reply->error() != QNetworkReply::NoError) {
             QMessageBox::critical(this, "Błąd sieci", reply->errorString());
             reply->deleteLater();
@@ -54,29 +102,37 @@ private slots:
         reply->deleteLater();
 
         try {
-            json response = json::parse(data.toStdString());
             // Dane w formacie JSON
             if (reply->url().toString().contains("geocoding-api")) {
+                json response = json::parse(data.toStdString());
                 if (response.contains("results") && !response["results"].empty()) {
                     double lat = response["results"][0]["latitude"];
                     double lon = response["results"][0]["longitude"];
                     currentLocation = QString::fromStdString(response["results"][0]["name"]);
                     currentCountry = QString::fromStdString(response["results"][0]["country"]);
 
-                    QString airQualityUrl = QString(
-                                                "https://air-quality-api.open-meteo.com/v1/air-quality?"
-                                                "latitude=%1&longitude=%2&"
-                                                "hourly=pm10,pm2_5,nitrogen_dioxide&"
-                                                "past_days=2&"
-                                                "forecast_days=3"
-                                                ).arg(lat).arg(lon);
+                    GeocodeEntry entry;
+                    entry.name = currentLocation;
+                    entry.country = currentCountry;
+                    entry.latitude = lat;
+                    entry.longitude = lon;
+                    geocodeCache.insert(reply->property("geocodeKey").toString(), entry);
+                    geocodeCache.save(geocodeCacheFile);
+                    locationIndexDirty = true;
 
-                    networkManager->get(QNetworkRequest(QUrl(airQualityUrl)));
+                    requestAirQuality(lat, lon);
                 }
             }
             else if (reply->url().toString().contains("air-quality")) {
-                displayAirQualityData(response);
-                saveToJsonFile(response, "air_quality_data.json");
+                std::vector<AirQualityFrame> frames = framesFromJsonText(data.constData(), data.size());
+                pendingAirQuality = frames.empty() ? AirQualityFrame() : std::move(frames.front());
+                pendingAirQualityReply = data;
+                displayJoinedData();
+            }
+            else if (weatherReply) {
+                std::vector<AirQualityFrame> frames = framesFromJsonText(data.constData(), data.size());
+                pendingWeather = frames.empty() ? AirQualityFrame() : std::move(frames.front());
+                displayJoinedData();
             }
         } catch (const std::exception &e) {
             QMessageBox::critical(this, "Błąd", QString("Błąd przetwarzania danych: %1").arg(e.what()));
@@ -85,9 +141,14 @@ private slots:
 
     // Funkcja pobierająca dane zapisane w pliku JSON (dane historyczne z poprzedniego pobrania)
     void loadFromFile() {
-        QString fileName = QFileDialog::getOpenFileName(this, "Otwórz plik JSON", "", "JSON Files (*.json)");
-        if (fileName.isEmpty()) return;
+        QStringList fileNames = QFileDialog::getOpenFileNames(this, "Otwórz pliki JSON", "", "JSON Files (*.json)");
+        if (fileNames.isEmpty()) return;
+        if (fileNames.size() > 1) {
+            loadSnapshots(fileNames);
+            return;
+        }
 
+        const QString fileName = fileNames.first();
         try {
             std::ifstream file(fileName.toStdString());
             json data = json::parse(file);
@@ -106,63 +167,299 @@ private slots:
 
     // Funkcja wyświetlająca dane i wykresy
     void displayAirQualityData(const json &data) {
+        storeAndDisplay(frameFromJson(data));
+    }
+
+    // Funkcja łącząca odpowiedzi jakości powietrza i pogody (po nadejściu obu) na osi czasu jakości powietrza
+    void displayJoinedData() {
+        if (!pendingAirQuality || !pendingWeather) return;
+
+        // Dane 15-minutowe rozszerzają oś czasu; jakość powietrza (godzinowa) ma wtedy luki między pełnymi godzinami
+        const std::int64_t weatherStep = smallestStep(*pendingWeather);
+        const JoinRange range = weatherStep > 0 && weatherStep < 3600 ? JoinRange::Union : JoinRange::First;
+        AirQualityFrame joined = joinFrames({{&*pendingAirQuality, ""}, {&*pendingWeather, ""}}, range);
+        pendingAirQuality.reset();
+        pendingWeather.reset();
+        storeAndDisplay(std::move(joined));
+
+        // Plik zawiera statystyki tej odpowiedzi, więc zapis czeka na ich przeliczenie w tle
+        const bool statsQueued = statsPending.contains(currentLocation)
+                                 || (statsWatcher.isRunning() && statsLocations.contains(currentLocation));
+        if (statsQueued) saveAfterStats = true;
+        else saveToJsonFile(pendingAirQualityReply, "air_quality_data.json");
+    }
+
+    // Funkcja dołączająca serię bieżącej lokalizacji do lokalnego magazynu i wyświetlająca scaloną serię,
+    // więc statystyki i prognoza obejmują także pomiary z tej odpowiedzi; wykresy odświeżane są ponownie
+    // z epizodami przekroczeń po przeliczeniu statystyk w tle
+    void storeAndDisplay(AirQualityFrame frame) {
+        frame.location = currentLocation.toStdString();
+        frame.station = currentCountry.toStdString();
+        applyDerivedSeries(frame);
+        if (frame.time.empty()) {
+            displayFrame(frame);
+            return;
+        }
+
+        const std::string location = frame.location;
+        store.merge(std::move(frame));
+        refreshLocationSelector();
+        displayFrame(*store.find(location));
+        updateStatsTable({location});
+    }
+
+    // Funkcja wczytująca wszystkie zapisane pliki JSON z wybranego katalogu
+    void loadFromDirectory() {
+        QString directory = QFileDialog::getExistingDirectory(this, "Wybierz katalog z plikami JSON");
+        if (directory.isEmpty()) return;
+
+        QStringList fileNames = SnapshotLoader::snapshotFiles(directory);
+        if (fileNames.isEmpty()) {
+            QMessageBox::warning(this, "Błąd", "Brak plików JSON w wybranym katalogu");
+            return;
+        }
+        loadSnapshots(fileNames);
+    }
+
+    // Funkcja wczytująca i scalająca wiele plików JSON do lokalnego magazynu
+    void loadSnapshots(const QStringList &fileNames) {
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        SnapshotLoader::Result result = SnapshotLoader::loadFiles(fileNames);
+        for (AirQualityFrame &frame : result.frames)
+            store.merge(std::move(frame));
+        updateStatsTable();
+        QApplication::restoreOverrideCursor();
+
+        refreshLocationSelector();
+        if (!result.frames.empty())
+            showStoredLocation(QString::fromStdString(store.frames().begin()->first));
+
+        QString summary = QString("Wczytano %1 z %2 plików (%3 lokalizacji).")
+                              .arg(result.loadedFiles)
+                              .arg(fileNames.size())
+                              .arg(result.frames.size());
+        if (!result.failedFiles.isEmpty())
+            summary += "\nPominięte pliki:\n" + result.failedFiles.mid(0, 10).join("\n");
+        QMessageBox::information(this, "Wczytywanie plików", summary);
+    }
+
+    // Funkcja wyświetlająca serię kolumnową (z API, pliku JSON lub importu CSV)
+    void displayFrame(const AirQualityFrame &frame) {
         weatherDisplay->clear();
         clearCharts();
-        statsDisplay->clear();
+        if (statsCurrentOnly->isChecked()) statsFilter->setLocation(currentLocation);
 
-        if (data.contains("hourly")) {
-            auto hourly = data["hourly"];
-            std::vector<std::string> timeData = hourly["time"].get<std::vector<std::string>>();
+        if (!frame.time.empty()) {
+            // Długie serie o kroku krótszym niż godzina wykreślane są jako średnie godzinowe; świeżo pobrana
+            // seria 15-minutowa (HistoryDays dni wstecz i prognoza) mieści się w limicie wierszy wykresu
+            AirQualityFrame hourly;
+            const bool rollup = needsHourlyRollup(frame);
+            if (rollup) hourly = rollupFrame(frame, 3600);
+
+            // Luki na wykresach mogą być uzupełnione; statystyki korzystają z mapy oryginalnych pomiarów
+            AirQualityFrame filled;
+            size_t filledRows = 0;
+            const auto gapFill = static_cast<GapFill>(gapFillSelector->currentData().toInt());
+            if (gapFill != GapFill::None) {
+                DenseFrame grid = denseFrame(rollup ? hourly : frame);
+                filledRows = fillGaps(grid, gapFill, maxFilledGap);
+                filled = sparseFrame(grid, rollup ? hourly : frame);
+            }
+            const AirQualityFrame &chartFrame = gapFill != GapFill::None ? filled : rollup ? hourly : frame;
+            const DenseFrame dense = denseFrame(frame);
 
             // Pobierz dane i oblicz statystyki
-            processParameter(hourly, "pm10", "PM10 [µg/m³]", Qt::red);
-            processParameter(hourly, "pm2_5", "PM2.5 [µg/m³]", Qt::blue);
-            processParameter(hourly, "nitrogen_dioxide", "NO₂ [µg/m³]", Qt::darkGreen);
+            for (const DisplayedParameter &parameter : displayedParameters())
+                processParameter(frame, dense, chartFrame, parameter);
 
             // Wyświetlanie informacji o stacji
             weatherDisplay->append("Lokalizacja: "+ currentLocation);
             weatherDisplay->append("Stacja pomiarowa: " + currentCountry);
+            if (rollup) weatherDisplay->append("Wykresy: średnie godzinowe z danych 15-minutowych");
+            if (filledRows > 0)
+                weatherDisplay->append(QString("Wykresy: uzupełniono %1 brakujących punktów (%2)")
+                                           .arg(filledRows).arg(gapFillSelector->currentText()));
         }
     }
 
-    // Funkcja obliczająca, zapisująca i wyświetlająca statystyki (minimum, maksimum, średnia)
-    void processParameter(const json& hourly, const std::string& param, const QString& title, const QColor& color) {
-        if (!hourly.contains(param) || hourly[param].is_null()) return;
+    // Funkcja zwracająca parametry wyświetlane w statystykach i na wykresach: tabela zanieczyszczeń,
+    // parametry pogodowe i serie pochodne
+    std::vector<DisplayedParameter> displayedParameters() const {
+        std::vector<DisplayedParameter> parameters;
+        for (const Pollutant &pollutant : pollutants) {
+            QString title = QString::fromUtf8(pollutant.displayName);
+            if (*pollutant.unit) title += QString(" [%1]").arg(QString::fromUtf8(pollutant.unit));
+            parameters.push_back({std::string(pollutant.apiName), title, QColor::fromRgb(pollutant.color),
+                                  pollutant.limit, pollutant.whoGuideline, pollutant.guidelineWindow});
+        }
+        parameters.push_back({"temperature_2m", "Temperatura [°C]", Qt::darkRed});
+        parameters.push_back({"wind_speed_10m", "Prędkość wiatru [km/h]", Qt::darkCyan});
+        parameters.push_back({"boundary_layer_height", "Wysokość warstwy granicznej [m]", Qt::darkMagenta});
+        for (const DerivedSeries &series : derivedSeries)
+            parameters.push_back({series.name.toStdString(), series.name + " = " + series.expression, Qt::black});
+        return parameters;
+    }
 
-        std::vector<double> values = hourly[param].get<std::vector<double>>();
-        std::vector<std::string> timeData = hourly["time"].get<std::vector<std::string>>();
+    // Funkcja zlecająca przeliczenie w tle wierszy tabeli statystyk podanych lokalizacji magazynu (pusta
+    // lista - wszystkich); żądania zgłoszone w trakcie obliczeń są łączone i wykonywane po ich zakończeniu
+    void updateStatsTable(const std::vector<std::string> &locations = {}) {
+        if (locations.empty()) statsPendingAll = true;
+        for (const std::string &location : locations) statsPending.insert(QString::fromStdString(location));
+        if (!statsWatcher.isRunning()) startStatsComputation();
+    }
 
-        auto [min_it, max_it] = std::minmax_element(values.begin(), values.end());
-        double min_val = *min_it;
-        double max_val = *max_it;
-        double avg_val = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    // Funkcja uruchamiająca obliczenie statystyk oczekujących lokalizacji na kopiach ich serii (magazyn może
+    // być w tym czasie scalany); wiersze są jedynym źródłem statystyk tabeli, wykresów i zapisu do JSON
+    void startStatsComputation() {
+        std::vector<const AirQualityFrame *> frames;
+        if (statsPendingAll) {
+            for (const auto &item : store.frames()) frames.push_back(&item.second);
+        } else {
+            for (const QString &location : std::as_const(statsPending))
+                if (const AirQualityFrame *frame = store.find(location.toStdString())) frames.push_back(frame);
+        }
+        statsPendingAll = false;
+        statsPending.clear();
+        if (frames.empty()) return;
 
-        parameterStats[QString::fromStdString(param)] = {min_val, max_val, avg_val};
+        // Epizody przekroczeń wytycznej WHO śledzone przyrostowo między przeliczeniami: przy zmianie serii
+        // skanowane są tylko wiersze od pierwszej zmiany
+        const std::vector<DisplayedParameter> parameters = displayedParameters();
+        for (const AirQualityFrame *frame : frames) {
+            const std::int64_t step = std::max<std::int64_t>(3600, smallestStep(*frame));
+            for (const DisplayedParameter &parameter : parameters) {
+                if (std::isnan(parameter.guideline)) continue;
+                const QString key = QString::fromStdString(frame->location + "/" + parameter.name);
+                auto found = exceedanceTrackers.constFind(key);
+                if (found == exceedanceTrackers.constEnd() || found->threshold() != parameter.guideline
+                    || found->averagingWindow() != parameter.guidelineWindow)
+                    exceedanceTrackers.insert(key, ExceedanceTracker(parameter.guideline, step, parameter.guidelineWindow));
+            }
+        }
 
-        statsDisplay->append(QString("%1\n  Min: %2\n  Max: %3\n  Średnia: %4\n")
-                                 .arg(title)
-                                 .arg(min_val, 0, 'f', 1)
-                                 .arg(max_val, 0, 'f', 1)
-                                 .arg(avg_val, 0, 'f', 1));
+        struct StatsTask {
+            AirQualityFrame frame;
+            std::vector<ExceedanceTracker *> trackers;      // na parametr; nullptr bez wytycznej
+        };
+        std::vector<StatsTask> tasks;
+        statsLocations.clear();
+        // Wskaźniki pobierane dopiero po dodaniu wszystkich wpisów, więc pozostają ważne w czasie obliczeń
+        for (const AirQualityFrame *frame : frames) {
+            StatsTask task{*frame, {}};
+            for (const DisplayedParameter &parameter : parameters)
+                task.trackers.push_back(std::isnan(parameter.guideline)
+                                            ? nullptr
+                                            : &exceedanceTrackers[QString::fromStdString(frame->location + "/" + parameter.name)]);
+            statsLocations.insert(QString::fromStdString(frame->location));
+            tasks.push_back(std::move(task));
+        }
 
-        createChart(timeData, values, title, color);
+        statsWatcher.setFuture(QtConcurrent::mapped(std::move(tasks), [parameters](const StatsTask &task) {
+            std::vector<StatsRow> rows;
+            const DenseFrame dense = denseFrame(task.frame);
+            for (size_t i = 0; i < parameters.size(); ++i) {
+                const DisplayedParameter &parameter = parameters[i];
+                StatsRow row;
+                row.location = QString::fromStdString(task.frame.location);
+                row.parameter = QString::fromStdString(parameter.name);
+                row.title = parameter.title;
+                row.limit = parameter.limit;
+                row.guideline = parameter.guideline;
+                row.guidelineWindow = parameter.guidelineWindow;
+                if (computeStatsRow(task.frame, dense, parameter.name, row, nullptr, task.trackers[i]))
+                    rows.push_back(std::move(row));
+            }
+            return rows;
+        }));
+    }
+
+    // Funkcja przekazująca obliczone statystyki do modelu jedną aktualizacją i odświeżająca wykresy
+    // bieżącej lokalizacji (epizody przekroczeń)
+    void statsComputed() {
+        std::vector<StatsRow> rows;
+        if (!statsWatcher.isCanceled())
+            for (std::vector<StatsRow> &taskRows : statsWatcher.future().results())
+                std::move(taskRows.begin(), taskRows.end(), std::back_inserter(rows));
+        statsModel->upsert(std::move(rows));
+
+        if (statsLocations.contains(currentLocation)) {
+            showStoredLocation(currentLocation);
+            if (saveAfterStats) {
+                saveAfterStats = false;
+                saveToJsonFile(pendingAirQualityReply, "air_quality_data.json");
+            }
+        }
+        if (statsPendingAll || !statsPending.isEmpty()) startStatsComputation();
+    }
+
+    // Funkcja tworząca wykresy parametru: histogram z pełnej serii (dense - ta sama seria na regularnej
+    // siatce z mapą pomiarów), wykres - z chartFrame (np. po agregacji godzinowej lub uzupełnieniu luk);
+    // epizody przekroczeń pochodzą z wiersza tabeli statystyk
+    void processParameter(const AirQualityFrame &frame, const DenseFrame &dense, const AirQualityFrame &chartFrame,
+                          const DisplayedParameter &parameter) {
+        const std::string &param = parameter.name;
+        const QString &title = parameter.title;
+        const QColor &color = parameter.color;
+
+        auto denseColumn = dense.columns.find(param);
+        if (denseColumn == dense.columns.end()) return;
+        Histogram histogram = parameterHistogram(param, static_cast<HistogramScale>(histogramScaleSelector->currentData().toInt()));
+        std::vector<Histogram *> histograms;
+        if (histogram.bins()) histograms.push_back(&histogram);
+        if (maskedSummary(denseColumn->second, histograms).count == 0) return;
+
+        // Epizody, w których średnia krocząca z okresu wytycznej WHO (24 h, dla O3 8 h) jest powyżej wytycznej
+        const StatsRow *stats = statsModel->find(QString::fromStdString(frame.location), QString::fromStdString(param));
+        const std::vector<ExceedanceEpisode> episodes = stats ? stats->episodes : std::vector<ExceedanceEpisode>();
+
+        // Prognoza z własnych pomiarów (do bieżącej chwili) dla parametrów z tabeli zanieczyszczeń; model
+        // dopasowywany jest do surowej serii z magazynu, nie do serii wykresu (uzupełnionej lub uśrednionej)
+        auto chartColumn = chartFrame.columns.find(param);
+        std::vector<ForecastPoint> forecast;
+        const AirQualityFrame *stored = store.find(frame.location);
+        const AirQualityFrame &history = stored ? *stored : frame;
+        if (findPollutant(param) && history.columns.count(param)) {
+            if (HoltWintersForecaster *forecaster = refreshForecaster(history, param, QDateTime::currentSecsSinceEpoch()))
+                forecast = forecaster->forecast(forecastHours);
+        }
+
+        if (chartColumn == chartFrame.columns.end()) return;
+        QChartView *seriesView = createChart(chartFrame.time, chartColumn->second, title, color, episodes, forecast);
+
+        // Histogram obok wykresu serii
+        QWidget *row = new QWidget();
+        QHBoxLayout *rowLayout = new QHBoxLayout(row);
+        rowLayout->setContentsMargins(0, 0, 0, 0);
+        rowLayout->addWidget(seriesView, 3);
+        if (histogram.total() > 0) {
+            QChartView *histogramView = new QChartView(createHistogramChart(histogram, title + " - rozkład", color));
+            histogramView->setRenderHint(QPainter::Antialiasing);
+            rowLayout->addWidget(histogramView, 1);
+        }
+        chartsLayout->addWidget(row);
+        charts.append(row);
     }
 
-    // Funkcja tworząca wykresy
-    void createChart(const std::vector<std::string>& timeData, const std::vector<double>& values, const QString& title, const QColor& color) {
+    // Funkcja tworząca wykres serii
+    QChartView *createChart(const std::vector<std::int64_t>& timeData, const std::vector<double>& values, const QString& title, const QColor& color,
+                     const std::vector<ExceedanceEpisode> &episodes = {}, const std::vector<ForecastPoint> &forecast = {}) {
         QLineSeries *series = new QLineSeries();
         series->setName(title);
 
-        for (size_t i = 0; i < values.size(); ++i) {
-            QDateTime dt = QDateTime::fromString(QString::fromStdString(timeData[i]), Qt::ISODate);
-            series->append(dt.toMSecsSinceEpoch(), values[i]);
-        }
+        QList<QPointF> points;
+        points.reserve(static_cast<qsizetype>(values.size()));
+        for (size_t i = 0; i < values.size(); ++i)
+            if (!std::isnan(values[i])) points.append(QPointF(timeData[i] * 1000.0, values[i]));
+        series->replace(points);
+
+        // Animacja gęstych serii (np. 15-minutowych) kosztuje więcej niż samo rysowanie
+        const bool dense = points.size() > 1000;
 
         QChart *chart = new QChart();
         chart->addSeries(series);
         chart->setTitle(title + " - " + currentLocation);
         chart->legend()->setVisible(true);
-        chart->setAnimationOptions(QChart::SeriesAnimations);
+        chart->setAnimationOptions(dense ? QChart::NoAnimation : QChart::SeriesAnimations);
 
         QDateTimeAxis *axisX = new QDateTimeAxis();
         axisX->setFormat("dd MM hh:mm");
@@ -179,10 +476,55 @@ private slots:
         pen.setWidth(2);
         series->setPen(pen);
 
+        // Epizody przekroczeń zaznaczone jako zacieniowane przedziały o wysokości wykresu
+        if (!episodes.empty() && !points.isEmpty()) {
+            const double top = std::max_element(points.begin(), points.end(),
+                                                [](const QPointF &a, const QPointF &b) { return a.y() < b.y(); })->y();
+            QLineSeries *upper = new QLineSeries();
+            QList<QPointF> outline;
+            for (const ExceedanceEpisode &episode : episodes) {
+                const double start = (episode.start - 1800) * 1000.0, end = (episode.end + 1800) * 1000.0;
+                outline << QPointF(start, 0) << QPointF(start, top) << QPointF(end, top) << QPointF(end, 0);
+            }
+            upper->replace(outline);
+
+            QAreaSeries *shading = new QAreaSeries(upper);
+            shading->setName("Epizody powyżej wytycznej WHO (średnia krocząca)");
+            shading->setColor(QColor(255, 0, 0, 40));
+            shading->setBorderColor(Qt::transparent);
+            chart->addSeries(shading);
+            shading->attachAxis(axisX);
+            shading->attachAxis(axisY);
+        }
+
+        // Prognoza lokalna: pasmo 95% i linia przerywana od ostatniego pomiaru
+        if (!forecast.empty()) {
+            QLineSeries *lower = new QLineSeries();
+            QLineSeries *upper = new QLineSeries();
+            QLineSeries *mean = new QLineSeries();
+            for (const ForecastPoint &point : forecast) {
+                lower->append(point.time * 1000.0, std::max(0.0, point.lower));
+                upper->append(point.time * 1000.0, point.upper);
+                mean->append(point.time * 1000.0, point.mean);
+            }
+            QAreaSeries *band = new QAreaSeries(upper, lower);
+            band->setName("Prognoza lokalna (95%)");
+            QColor bandColor = color;
+            bandColor.setAlpha(50);
+            band->setColor(bandColor);
+            band->setBorderColor(Qt::transparent);
+            mean->setName("Prognoza lokalna (Holt-Winters)");
+            mean->setPen(QPen(color.darker(130), 2, Qt::DashLine));
+            for (QAbstractSeries *overlay : std::initializer_list<QAbstractSeries *>{band, mean}) {
+                chart->addSeries(overlay);
+                overlay->attachAxis(axisX);
+                overlay->attachAxis(axisY);
+            }
+        }
+
         QChartView *chartView = new QChartView(chart);
         chartView->setRenderHint(QPainter::Antialiasing);
-        chartsLayout->addWidget(chartView);
-        charts.append(chartView);
+        return chartView;
     }
 
     // Funkcja do czyszczenia okien wykresów
@@ -194,26 +536,574 @@ private slots:
         charts.clear();
     }
 
+    // Funkcja importująca historyczne pomiary z pliku CSV do lokalnego magazynu
+    void importCsvFile() {
+        QString fileName = QFileDialog::getOpenFileName(this, "Importuj plik CSV", "", "CSV Files (*.csv *.txt)");
+        if (fileName.isEmpty()) return;
+
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        QElapsedTimer timer;
+        timer.start();
+        CsvImporter::Result result = CsvImporter::importFile(fileName);
+        const double seconds = std::max(timer.elapsed(), qint64(1)) / 1000.0;
+        for (AirQualityFrame &frame : result.frames)
+            store.merge(std::move(frame));
+        updateStatsTable();
+        QApplication::restoreOverrideCursor();
+
+        if (!result.error.isEmpty()) {
+            QMessageBox::warning(this, "Błąd", "Nie można zaimportować pliku: " + result.error);
+            return;
+        }
+
+        refreshLocationSelector();
+        QMessageBox::information(this, "Import CSV",
+                                 QString("Zaimportowano %1 wierszy (%2 lokalizacji), odrzucono %3.\n"
+                                         "Czas: %4 s (%5 MB/s)")
+                                     .arg(result.rows)
+                                     .arg(result.frames.size())
+                                     .arg(result.rejectedRows)
+                                     .arg(seconds, 0, 'f', 2)
+                                     .arg(result.bytes / 1048576.0 / seconds, 0, 'f', 1));
+    }
+
+    // Funkcja wyświetlająca dane lokalizacji wybranej z lokalnego magazynu
+    void showStoredLocation(const QString &location) {
+        const AirQualityFrame *frame = store.find(location.toStdString());
+        if (!frame) return;
+
+        currentLocation = QString::fromStdString(frame->location);
+        currentCountry = QString::fromStdString(frame->station);
+        displayFrame(*frame);
+    }
+
+    // Funkcja dodająca serię pochodną (np. "ratio = pm2_5 / pm10") do wszystkich lokalizacji w magazynie
+    void addDerivedSeries() {
+        bool ok = false;
+        const QString definition = QInputDialog::getText(this, "Seria pochodna",
+                                                         "Definicja (nazwa = wyrażenie), np. no2_ppb = nitrogen_dioxide * 0.5319:",
+                                                         QLineEdit::Normal, QString(), &ok);
+        if (!ok || definition.trimmed().isEmpty()) return;
+
+        const QRegularExpressionMatch match = QRegularExpression("^\\s*([A-Za-z_]\\w*)\\s*=(?!=)(.+)$").match(definition);
+        if (!match.hasMatch()) {
+            QMessageBox::warning(this, "Błąd", "Podaj definicję w postaci 'nazwa = wyrażenie'");
+            return;
+        }
+
+        DerivedSeries series;
+        series.name = match.captured(1);
+        series.expression = match.captured(2).trimmed();
+        try {
+            series.plan = ExpressionPlan::compile(series.expression.toStdString());
+        } catch (const std::exception &e) {
+            QMessageBox::warning(this, "Błąd", e.what());
+            return;
+        }
+        derivedSeries.removeIf([&](const DerivedSeries &other) { return other.name == series.name; });
+        derivedSeries.append(series);
+
+        // Serie lokalizacji są niezależne, więc wyrażenie liczone jest dla nich równolegle
+        QList<AirQualityFrame *> frames;
+        for (const auto &item : store.frames())
+            frames.append(store.find(item.first));
+        QElapsedTimer timer;
+        timer.start();
+        QtConcurrent::blockingMap(frames, [&series](AirQualityFrame *frame) {
+            frame->columns[series.name.toStdString()] = series.plan.evaluate(*frame);
+        });
+        for (const AirQualityFrame *frame : std::as_const(frames)) store.markModified(frame->location);
+        updateStatsTable();
+        statusBar()->showMessage(QString("Seria %1 obliczona dla %2 lokalizacji w %3 ms")
+                                     .arg(series.name).arg(frames.size()).arg(timer.elapsed()), 5000);
+
+        showStoredLocation(currentLocation);
+    }
+
+    // Funkcja dopasowująca lub aktualizująca (tylko nowe godziny) prognozy lokalne wszystkich lokalizacji naraz
+    void updateForecasts() {
+        if (store.empty()) {
+            QMessageBox::warning(this, "Błąd", "Brak danych w lokalnym magazynie");
+            return;
+        }
+
+        struct ForecastTask {
+            QString key;
+            const AirQualityFrame *frame;
+            const std::vector<double> *values;
+            HoltWintersForecaster *forecaster;
+        };
+        std::vector<ForecastTask> tasks;
+        for (const auto &[location, frame] : store.frames())
+            for (const Pollutant &pollutant : pollutants) {
+                auto column = frame.columns.find(std::string(pollutant.apiName));
+                if (column == frame.columns.end()) continue;
+                const QString key = QString::fromStdString(location + "/" + column->first);
+                if (!forecasters.contains(key)) forecasters.insert(key, HoltWintersForecaster());
+                tasks.push_back({key, &frame, &column->second, nullptr});
+            }
+        // Wskaźniki pobierane dopiero po dodaniu wszystkich wpisów, więc pozostają ważne w czasie obliczeń
+        for (ForecastTask &task : tasks) task.forecaster = &forecasters[task.key];
+
+        const std::int64_t now = QDateTime::currentSecsSinceEpoch();
+        QElapsedTimer timer;
+        timer.start();
+        QtConcurrent::blockingMap(tasks, [now](ForecastTask &task) {
+            if (task.forecaster->ready()) task.forecaster->update(task.frame->time, *task.values, now);
+            else task.forecaster->fit(task.frame->time, *task.values, now);
+        });
+        const int ready = static_cast<int>(std::count_if(tasks.begin(), tasks.end(),
+                                                         [](const ForecastTask &task) { return task.forecaster->ready(); }));
+        statusBar()->showMessage(QString("Prognozy lokalne: %1 z %2 serii w %3 ms")
+                                     .arg(ready).arg(tasks.size()).arg(timer.elapsed()), 5000);
+        showStoredLocation(currentLocation);
+    }
+
+    // Funkcja licząca trendy wszystkich parametrów z tabeli dla każdej lokalizacji magazynu i zapisująca je do CSV
+    void exportTrends() {
+        if (store.empty()) {
+            QMessageBox::warning(this, "Błąd", "Brak danych w lokalnym magazynie");
+            return;
+        }
+        QString fileName = QFileDialog::getSaveFileName(this, "Zapisz trendy", "trends.csv", "CSV (*.csv)");
+        if (fileName.isEmpty()) return;
+
+        struct TrendTask {
+            const AirQualityFrame *frame;
+            const Pollutant *pollutant;
+            TrendResult result;
+        };
+        std::vector<TrendTask> tasks;
+        for (const auto &[location, frame] : store.frames())
+            for (const Pollutant &pollutant : pollutants)
+                if (frame.columns.count(std::string(pollutant.apiName))) tasks.push_back({&frame, &pollutant, {}});
+
+        // Lokalizacje i parametry są niezależne - jeden równoległy przebieg po wszystkich parach
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        QElapsedTimer timer;
+        timer.start();
+        QtConcurrent::blockingMap(tasks, [](TrendTask &task) {
+            task.result = estimateTrend(task.frame->time, task.frame->columns.at(std::string(task.pollutant->apiName)));
+        });
+        const qint64 elapsed = timer.elapsed();
+        QApplication::restoreOverrideCursor();
+
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QMessageBox::warning(this, "Błąd", "Nie można zapisać pliku.");
+            return;
+        }
+        QTextStream out(&file);
+        out << "location;parameter;days;slope_per_year;ci_lower;ci_upper;kendall_z;p_value\n";
+        int significant = 0;
+        for (const TrendTask &task : tasks) {
+            if (!task.result.valid()) continue;
+            significant += task.result.significant();
+            out << QString::fromStdString(task.frame->location) << ';'
+                << QString::fromLatin1(task.pollutant->apiName.data(), static_cast<qsizetype>(task.pollutant->apiName.size())) << ';'
+                << task.result.days << ';' << task.result.slopePerYear << ';' << task.result.lowerPerYear << ';'
+                << task.result.upperPerYear << ';' << task.result.kendallZ << ';' << task.result.pValue << '\n';
+        }
+        statusBar()->showMessage(QString("Trendy: %1 serii w %2 ms, istotnych (p < 0,05): %3")
+                                     .arg(tasks.size()).arg(elapsed).arg(significant), 5000);
+    }
+
+    // Funkcja eksportująca cały lokalny magazyn do pliku CSV lub Arrow IPC / Feather
+    void exportStore() {
+        if (store.empty()) {
+            QMessageBox::warning(this, "Błąd", "Brak danych do eksportu");
+            return;
+        }
+        QString fileName = QFileDialog::getSaveFileName(this, "Eksportuj dane", "air_quality_data.csv",
+                                                        "CSV Files (*.csv);;Arrow IPC / Feather (*.arrow *.feather)");
+        if (fileName.isEmpty()) return;
+
+        std::string error;
+        QApplication::setOverrideCursor(Qt::WaitCursor);
+        const std::string path = fileName.toStdString();
+        bool ok = ColumnarExporter::exportStore(store, path, ColumnarExporter::formatForFile(path), error);
+        QApplication::restoreOverrideCursor();
+
+        if (ok)
+            QMessageBox::information(this, "Sukces", "Dane wyeksportowane do " + fileName);
+        else
+            QMessageBox::warning(this, "Błąd", QString::fromStdString(error));
+    }
+
+    // Funkcja geokodująca listę adresów z pliku (jeden adres w wierszu lub pierwsza kolumna CSV)
+    void geocodeAddressList() {
+        QString fileName = QFileDialog::getOpenFileName(this, "Lista adresów", "", "Address lists (*.csv *.txt)");
+        if (fileName.isEmpty()) return;
+
+        QStringList addresses = readAddressList(fileName);
+        if (addresses.isEmpty()) {
+            QMessageBox::warning(this, "Błąd", "Plik nie zawiera adresów");
+            return;
+        }
+
+        if (!bulkGeocoder) {
+            bulkGeocoder = new BulkGeocoder(geocodeCache, this);
+            connect(bulkGeocoder, &BulkGeocoder::finished, this, &WeatherApp::bulkGeocodingFinished);
+        }
+
+        QProgressDialog *progressDialog = new QProgressDialog("Geokodowanie adresów...", "Anuluj", 0, 0, this);
+        progressDialog->setAttribute(Qt::WA_DeleteOnClose);
+        progressDialog->setWindowModality(Qt::WindowModal);
+        connect(bulkGeocoder, &BulkGeocoder::progress, progressDialog, [progressDialog](int done, int total) {
+            progressDialog->setMaximum(total);
+            progressDialog->setValue(done);
+        });
+        connect(progressDialog, &QProgressDialog::canceled, bulkGeocoder, &BulkGeocoder::cancel);
+        connect(bulkGeocoder, &BulkGeocoder::finished, progressDialog, &QProgressDialog::close);
+        progressDialog->show();
+
+        QFileInfo info(fileName);
+        geocodeReportFile = info.dir().filePath(info.completeBaseName() + "_geocoded.csv");
+        bulkGeocoder->start(addresses);
+    }
+
+    // Funkcja zapisująca wyniki zbiorczego geokodowania i raport niejednoznacznych adresów
+    void bulkGeocodingFinished() {
+        addressCompleter->rebuild();
+        geocodeCache.save(geocodeCacheFile);
+        locationIndexDirty = true;
+
+        int found = 0;
+        QStringList ambiguous, failed;
+        QFile report(geocodeReportFile);
+        const bool reportOpen = report.open(QIODevice::WriteOnly | QIODevice::Text);
+        QTextStream out(&report);
+        out << "address;name;region;country;latitude;longitude;status\n";
+        for (const BulkGeocoder::Result &result : bulkGeocoder->results()) {
+            QString status = result.error;
+            if (result.found) {
+                ++found;
+                status = result.entry.ambiguous ? "niejednoznaczny" : (result.fromCache ? "pamięć podręczna" : "ok");
+                if (result.entry.ambiguous) ambiguous.append(result.address);
+            } else {
+                failed.append(result.address);
+            }
+            out << result.address << ';' << result.entry.name << ';' << result.entry.region << ';'
+                << result.entry.country << ';' << QString::number(result.entry.latitude, 'f', 5) << ';'
+                << QString::number(result.entry.longitude, 'f', 5) << ';' << status << '\n';
+        }
+
+        QString summary = QString("Znaleziono %1 z %2 adresów.").arg(found).arg(bulkGeocoder->results().size());
+        if (!ambiguous.isEmpty())
+            summary += QString("\nNiejednoznaczne (%1): %2").arg(ambiguous.size()).arg(ambiguous.mid(0, 10).join("; "));
+        if (!failed.isEmpty())
+            summary += QString("\nNie znaleziono (%1): %2").arg(failed.size()).arg(failed.mid(0, 10).join("; "));
+        if (reportOpen)
+            summary += "\nRaport zapisany do " + geocodeReportFile;
+        QMessageBox::information(this, "Geokodowanie", summary);
+    }
+
+    // Funkcja wyszukująca najbliższe zapisane lokalizacje: dla współrzędnych wpisanych jako
+    // "szerokość, długość" albo dla bieżącej pozycji z QGeoPositionInfoSource
+    void findNearestLocations() {
+        static const QRegularExpression coordinates("^\\s*(-?\\d+(?:\\.\\d+)?)\\s*[,; ]\\s*(-?\\d+(?:\\.\\d+)?)\\s*$");
+        QRegularExpressionMatch match = coordinates.match(addressInput->text());
+        if (match.hasMatch()) {
+            showNearestLocations(QGeoCoordinate(match.captured(1).toDouble(), match.captured(2).toDouble()));
+            return;
+        }
+
+        if (!positionSource) {
+            positionSource = QGeoPositionInfoSource::createDefaultSource(this);
+            if (!positionSource) {
+                QMessageBox::warning(this, "Błąd", "Brak źródła pozycji - wpisz współrzędne (np. '50.06, 19.94')");
+                return;
+            }
+            connect(positionSource, &QGeoPositionInfoSource::positionUpdated, this, [this](const QGeoPositionInfo &info) {
+                showNearestLocations(info.coordinate());
+            });
+            connect(positionSource, &QGeoPositionInfoSource::errorOccurred, this, [this](QGeoPositionInfoSource::Error) {
+                QMessageBox::warning(this, "Błąd", "Nie można ustalić pozycji - wpisz współrzędne (np. '50.06, 19.94')");
+            });
+        }
+        positionSource->requestUpdate(5000);
+    }
+
+    // Funkcja wyświetlająca lokalizacje najbliższe podanej pozycji
+    void showNearestLocations(const QGeoCoordinate &position) {
+        if (!position.isValid()) return;
+        rebuildLocationIndex();
+
+        const GeoPoint query{position.latitude(), position.longitude()};
+        const auto nearest = locationIndex.nearest(query, 10);
+        const auto nearby = locationIndex.withinRadius(query, 25.0);
+
+        weatherDisplay->clear();
+        weatherDisplay->append(QString("Najbliższe lokalizacje dla %1, %2 (w promieniu 25 km: %3):")
+                                   .arg(query.latitude, 0, 'f', 4)
+                                   .arg(query.longitude, 0, 'f', 4)
+                                   .arg(nearby.size()));
+        for (const auto &[index, km] : nearest)
+            weatherDisplay->append(QString("  %1 - %2 km").arg(indexedLabels[index]).arg(km, 0, 'f', 1));
+        if (nearest.empty())
+            weatherDisplay->append("  brak lokalizacji ze znanymi współrzędnymi");
+    }
+
+    // Funkcja włączająca/wyłączająca tryb podróży: pozycja z pliku NMEA i pobieranie danych dla otoczenia
+    void toggleTravelMode() {
+        if (prefetcher && prefetcher->isActive()) {
+            prefetcher->stop();
+            statusBar()->showMessage("Tryb podróży wyłączony", 3000);
+            return;
+        }
+
+        QString fileName = QFileDialog::getOpenFileName(this, "Plik NMEA", "", "NMEA logs (*.nmea *.log *.txt)");
+        if (fileName.isEmpty()) return;
+
+        // Budżet przepustowości pobierania w tle (zapamiętywany do kolejnego włączenia)
+        bool ok = false;
+        const int budget = QInputDialog::getInt(this, "Tryb podróży", "Budżet pobierania [KB/min]:",
+                                                prefetchBudgetKb, 64, 100 * 1024, 64, &ok);
+        if (!ok) return;
+        prefetchBudgetKb = budget;
+
+        if (!prefetcher) {
+            prefetcher = new PositionPrefetcher(this);
+            connect(prefetcher, &PositionPrefetcher::currentCellData, this, [this](const AirQualityFrame &frame) {
+                currentLocation = QString::fromStdString(frame.location);
+                currentCountry = "dane pobrane z wyprzedzeniem";
+                displayFrame(frame);
+            });
+            connect(prefetcher, &PositionPrefetcher::statusChanged, this, [this](const QString &status) {
+                statusBar()->showMessage(status);
+            });
+        }
+        prefetcher->setBudget(qint64(prefetchBudgetKb) * 1024, prefetchCells);
+        if (!prefetcher->startFromNmeaFile(fileName))
+            QMessageBox::warning(this, "Błąd", "Nie można otworzyć pliku NMEA");
+    }
+
+    // Funkcja otwierająca okno mapy cieplnej zanieczyszczeń dla obszaru
+    void showHeatmap() {
+        if (!heatmapWindow) heatmapWindow = new HeatmapWindow(this);
+        heatmapWindow->show();
+        heatmapWindow->raise();
+    }
+
+    // Funkcja otwierająca okno profili dobowych i tygodniowych dla lokalizacji z magazynu
+    void showProfiles() {
+        if (store.empty()) {
+            QMessageBox::warning(this, "Błąd", "Brak danych w lokalnym magazynie");
+            return;
+        }
+        if (!profileWindow) profileWindow = new ProfileWindow(store, this);
+        profileWindow->recompute(currentLocation);
+        profileWindow->show();
+        profileWindow->raise();
+    }
+
+    // Funkcja otwierająca okno macierzy korelacji serii z magazynu
+    void showCorrelations() {
+        if (!correlationWindow) correlationWindow = new CorrelationWindow(store, this);
+        correlationWindow->refreshLocations(currentLocation);
+        correlationWindow->show();
+        correlationWindow->raise();
+    }
+
+    // Funkcja otwierająca ranking najgorszych obserwowanych lokalizacji; ranking aktualizowany jest
+    // przy każdej odpowiedzi odpytywania, tu tylko uzupełniany o lokalizacje jeszcze w nim nieobecne
+    void showRanking() {
+        if (!rankingWindow) {
+            rankingWindow = new RankingWindow(ranking, this);
+            connect(rankingWindow, &RankingWindow::locationActivated, this, [this](const QString &location) {
+                showStoredLocation(location);
+                raise();
+                activateWindow();
+            });
+            const std::int64_t now = QDateTime::currentSecsSinceEpoch();
+            for (const AlertMonitor::WatchedLocation &location : alertMonitor->watched())
+                if (const AirQualityFrame *frame = store.find(location.label.toStdString()))
+                    ranking.update(frame->location, *frame, now);
+        }
+        rankingWindow->refresh();
+        rankingWindow->show();
+        rankingWindow->raise();
+    }
+
+    // Funkcja otwierająca panel miniatur obserwowanych lokalizacji (bez obserwowanych - wszystkich z magazynu)
+    void showDashboard() {
+        if (!dashboardWindow) {
+            dashboardWindow = new DashboardWindow(store, this);
+            connect(dashboardWindow, &DashboardWindow::locationActivated, this, [this](const QString &location) {
+                showStoredLocation(location);
+                raise();
+                activateWindow();
+            });
+        }
+        dashboardWindow->setLocations(dashboardLocations());
+        dashboardWindow->refresh();
+        dashboardWindow->show();
+        dashboardWindow->raise();
+    }
+
+    // Funkcja zwracająca lokalizacje panelu miniatur
+    QStringList dashboardLocations() const {
+        QStringList locations;
+        for (const AlertMonitor::WatchedLocation &location : alertMonitor->watched()) locations.append(location.label);
+        if (locations.isEmpty())
+            for (const auto &item : store.frames()) locations.append(QString::fromStdString(item.first));
+        return locations;
+    }
+
+    // Funkcja otwierająca kalendarz roczny średnich dobowych; przy ponownym otwarciu rysowane są tylko lata ze zmienionymi dniami
+    void showCalendar() {
+        if (!calendarWindow) calendarWindow = new CalendarWindow(store, this);
+        calendarWindow->refreshLocations(currentLocation);
+        calendarWindow->show();
+        calendarWindow->raise();
+    }
+
+    // Funkcja otwierająca okno rozkładów wartości (histogramy archiwum jednej lub wszystkich lokalizacji)
+    void showDistributions() {
+        if (!distributionWindow) distributionWindow = new DistributionWindow(store, this);
+        distributionWindow->refreshLocations(currentLocation);
+        distributionWindow->show();
+        distributionWindow->raise();
+    }
+
+    // Funkcja otwierająca mapę lokalizacji z magazynu i pamięci podręcznej geokodowania, kolorowaną klasą indeksu jakości powietrza
+    void showStationMap() {
+        QList<StationMarker> stations;
+        QSet<QString> seen;
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (const auto &[location, frame] : store.frames()) {
+            if (std::isnan(frame.latitude) || std::isnan(frame.longitude) || frame.time.empty()) continue;
+            StationMarker station;
+            station.label = QString::fromStdString(location);
+            station.position = {frame.latitude, frame.longitude};
+            station.level = europeanAqiLevel(frame, std::min<std::int64_t>(now, frame.time.back()));
+            seen.insert(station.label);
+            stations.append(station);
+        }
+        for (const GeocodeEntry &entry : geocodeCache.entries()) {
+            StationMarker station;
+            station.label = AddressCompleter::labelFor(entry);
+            if (seen.contains(station.label)) continue;
+            seen.insert(station.label);
+            station.position = {entry.latitude, entry.longitude};
+            stations.append(station);
+        }
+
+        if (!stationMapWindow)
+            stationMapWindow = new StationMapWindow(tileServer, QCoreApplication::applicationDirPath() + "/tiles", this);
+        stationMapWindow->setStations(stations);
+        stationMapWindow->show();
+        stationMapWindow->raise();
+    }
+
+    // Funkcja dodająca bieżącą lokalizację do obserwowanych (lub usuwająca ją z nich)
+    void toggleWatchedLocation() {
+        if (currentLocation.isEmpty()) {
+            QMessageBox::warning(this, "Błąd", "Najpierw pobierz lub wybierz lokalizację");
+            return;
+        }
+        if (alertMonitor->isWatched(currentLocation)) {
+            alertMonitor->unwatch(currentLocation);
+            ranking.remove(currentLocation.toStdString());
+            statusBar()->showMessage("Lokalizacja " + currentLocation + " nie jest już obserwowana", 3000);
+        } else {
+            const AirQualityFrame *frame = store.find(currentLocation.toStdString());
+            if (!frame || std::isnan(frame->latitude) || std::isnan(frame->longitude)) {
+                QMessageBox::warning(this, "Błąd", "Brak współrzędnych lokalizacji " + currentLocation);
+                return;
+            }
+            alertMonitor->watch(currentLocation, {frame->latitude, frame->longitude});
+            ranking.update(frame->location, *frame, QDateTime::currentSecsSinceEpoch());
+            statusBar()->showMessage(QString("Obserwowane lokalizacje: %1").arg(alertMonitor->watched().size()), 3000);
+        }
+        alertMonitor->save(alertConfigFile);
+        updateAlertPolling();
+        if (dashboardWindow && dashboardWindow->isVisible()) {
+            dashboardWindow->setLocations(dashboardLocations());
+            dashboardWindow->refresh();
+        }
+    }
+
+    // Funkcja edytująca reguły powiadomień (jedna reguła w linii)
+    void editAlertRules() {
+        QString text = alertMonitor->ruleLines().join('\n');
+        for (;;) {
+            bool ok = false;
+            text = QInputDialog::getMultiLineText(this, "Reguły alarmów",
+                                                  "Reguły (np. pm2_5 mean 24h > 25 for 3h clear 20 at Kraków):",
+                                                  text, &ok);
+            if (!ok) return;
+
+            QString error;
+            if (alertMonitor->setRules(text.split('\n'), error)) break;
+            QMessageBox::warning(this, "Błąd reguły", error);
+        }
+        alertMonitor->save(alertConfigFile);
+        updateAlertPolling();
+    }
+
     // Funkcja obsługująca zapis danych do pliku JSON
-    void saveToJsonFile(const json &data, const std::string &filename) {
+    void saveToJsonFile(const QByteArray &data, const std::string &filename) {
         json output;
         output["location"] = currentLocation.toStdString();
         output["station"] = currentCountry.toStdString();
-        output["air_quality_data"] = data;
 
-        // Dodaj statystyki do pliku JSON
+        // Dodaj statystyki do pliku JSON (wiersze tabeli statystyk bieżącej lokalizacji)
         json stats;
-        for (const auto& item : parameterStats.toStdMap()) {
-            const auto& param = item.first;
-            const auto& statsData = item.second;
+        for (const DisplayedParameter &parameter : displayedParameters()) {
+            const StatsRow *row = statsModel->find(currentLocation, QString::fromStdString(parameter.name));
+            if (!row) continue;
+            const QString param = row->parameter;
+            const StatsRow &statsData = *row;
             stats[param.toStdString()] = {
                 {"min", statsData.min},
                 {"max", statsData.max},
-                {"avg", statsData.avg}
+                {"avg", statsData.mean}
+            };
+            if (statsData.gaps.gaps > 0) {
+                stats[param.toStdString()]["gaps"] = {
+                    {"missing", statsData.gaps.missing()},
+                    {"rows", statsData.gaps.rows},
+                    {"count", statsData.gaps.gaps},
+                    {"longest_rows", statsData.gaps.longestGap}
+                };
+            }
+            if (statsData.trend.valid()) {
+                stats[param.toStdString()]["trend"] = {
+                    {"slope_per_year", statsData.trend.slopePerYear},
+                    {"ci_lower", statsData.trend.lowerPerYear},
+                    {"ci_upper", statsData.trend.upperPerYear},
+                    {"kendall_z", statsData.trend.kendallZ},
+                    {"p_value", statsData.trend.pValue},
+                    {"days", statsData.trend.days}
+                };
+            }
+            if (std::isnan(statsData.guideline)) continue;
+
+            // Epizody przekroczeń wytycznej WHO zapisywane razem ze statystykami
+            json episodes = json::array();
+            char start[24], end[24];
+            for (const ExceedanceEpisode &episode : statsData.episodes) {
+                start[formatIsoTimestamp(episode.start, start)] = '\0';
+                end[formatIsoTimestamp(episode.end, end)] = '\0';
+                episodes.push_back({{"start", start}, {"end", end}, {"peak", episode.peak}, {"mean", episode.mean},
+                                    {"samples", episode.samples}});
+            }
+            stats[param.toStdString()]["exceedances"] = {
+                {"threshold", statsData.guideline},
+                {"averaging_hours", statsData.guidelineWindow / 3600},
+                {"samples", statsData.exceedingSamples},
+                {"episodes", episodes}
             };
         }
         output["statistics"] = stats;
 
+        output["air_quality_data"] = json::parse(data.constBegin(), data.constEnd(), nullptr, false);
+        if (output["air_quality_data"].is_discarded()) {
+            QMessageBox::warning(this, "Błąd", "Nieprawidłowa odpowiedź API - dane nie zostały zapisane.");
+            return;
+        }
+
         std::ofstream file(filename);
         if (file.is_open()) {
             file << output.dump(2);
@@ -224,22 +1114,207 @@ private slots:
     }
 
 private:
-    struct ParameterStats {
-        double min;
-        double max;
-        double avg;
+    // Parametr wyświetlany w statystykach i na wykresach
+    struct DisplayedParameter {
+        std::string name;
+        QString title;
+        QColor color;
+        double limit = NoLimit;
+        double guideline = NoLimit;
+        std::int64_t guidelineWindow = 0;
     };
 
+    QHash<QString, ExceedanceTracker> exceedanceTrackers;
+    QHash<QString, HoltWintersForecaster> forecasters;
+    const int forecastHours = 24;
+
     QNetworkAccessManager *networkManager;
     QLineEdit *addressInput;
     QTextEdit *weatherDisplay;
-    QTextEdit *statsDisplay;
+    StatsTableModel *statsModel;
+    QFutureWatcher<std::vector<StatsRow>> statsWatcher;
+    QSet<QString> statsPending;         // lokalizacje czekające na przeliczenie statystyk
+    bool statsPendingAll = false;
+    QSet<QString> statsLocations;       // lokalizacje liczone w bieżącym przebiegu
+    bool saveAfterStats = false;        // zapis odpowiedzi API po przeliczeniu statystyk bieżącej lokalizacji
+    StatsFilterModel *statsFilter;
+    QCheckBox *statsCurrentOnly;
+    QSet<QString> updatedLocations;     // lokalizacje odświeżone w bieżącym cyklu odpytywania
     QVBoxLayout *chartsLayout;
-    QList<QChartView*> charts;
+    QList<QWidget*> charts;
     QChartView *chartView;
     QString currentLocation;
     QString currentCountry;
-    QMap<QString, ParameterStats> parameterStats;
+    QComboBox *locationSelector;
+    LocationStore store;
+    GeocodeCache geocodeCache;
+    BulkGeocoder *bulkGeocoder = nullptr;
+    AddressCompleter *addressCompleter = nullptr;
+    QString geocodeReportFile;
+    const QString geocodeCacheFile = "geocode_cache.json";
+    KdTree locationIndex;
+    QStringList indexedLabels;
+    bool locationIndexDirty = true;
+    QGeoPositionInfoSource *positionSource = nullptr;
+    PositionPrefetcher *prefetcher = nullptr;
+    int prefetchBudgetKb = 2048;
+    const int prefetchCells = 64;
+    HeatmapWindow *heatmapWindow = nullptr;
+    StationMapWindow *stationMapWindow = nullptr;
+    ProfileWindow *profileWindow = nullptr;
+    CorrelationWindow *correlationWindow = nullptr;
+    DistributionWindow *distributionWindow = nullptr;
+    RankingWindow *rankingWindow = nullptr;
+    DashboardWindow *dashboardWindow = nullptr;
+    CalendarWindow *calendarWindow = nullptr;
+    LocationRanking ranking;
+    const QString tileServer = "http://localhost:8080/tile/";
+    int requestSerial = 0;
+    std::optional<AirQualityFrame> pendingAirQuality;
+    std::optional<AirQualityFrame> pendingWeather;
+    QByteArray pendingAirQualityReply;
+    QComboBox *resolutionSelector;
+    QComboBox *gapFillSelector;
+    QComboBox *histogramScaleSelector;
+    const std::int64_t maxFilledGap = 6 * 3600;
+    AlertMonitor *alertMonitor = nullptr;
+    AlertNotifier *alertNotifier = nullptr;
+    QSystemTrayIcon *trayIcon = nullptr;
+    const QString alertConfigFile = "alerts.json";
+    const int alertPollSeconds = 15 * 60;
+
+    struct DerivedSeries {
+        QString name;
+        QString expression;
+        ExpressionPlan plan;
+    };
+    QList<DerivedSeries> derivedSeries;
+
+    // Funkcja zwracająca prognozę lokalną serii: przy pierwszym użyciu dopasowaną do historii, później
+    // uzupełnioną tylko o nowe godziny; nullptr, gdy historia jest zbyt krótka (poniżej trzech dób -
+    // zapytania pobierają HistoryDays dni wstecz, a pasmo prognozy pojawia się po zebraniu tej historii)
+    HoltWintersForecaster *refreshForecaster(const AirQualityFrame &frame, const std::string &param, std::int64_t until) {
+        const std::vector<double> &values = frame.columns.at(param);
+        HoltWintersForecaster &forecaster = forecasters[QString::fromStdString(frame.location + "/" + param)];
+        if (forecaster.ready()) forecaster.update(frame.time, values, until);
+        else forecaster.fit(frame.time, values, until);
+        return forecaster.ready() ? &forecaster : nullptr;
+    }
+
+    // Funkcja dopisująca do serii kolumny wszystkich zdefiniowanych serii pochodnych
+    void applyDerivedSeries(AirQualityFrame &frame) const {
+        for (const DerivedSeries &series : derivedSeries)
+            frame.columns[series.name.toStdString()] = series.plan.evaluate(frame);
+    }
+
+    // Funkcja konfigurująca odpytywanie obserwowanych lokalizacji i kanały powiadomień
+    void setupAlerts() {
+        alertMonitor = new AlertMonitor(this);
+        alertMonitor->load(alertConfigFile);
+
+        alertNotifier = new AlertNotifier(this);
+        alertNotifier->setLogFile("alerts.log");
+        alertNotifier->setSocketName("air-pollution-alerts");
+        if (QSystemTrayIcon::isSystemTrayAvailable()) {
+            trayIcon = new QSystemTrayIcon(windowIcon(), this);
+            trayIcon->show();
+            alertNotifier->setTrayIcon(trayIcon);
+        }
+
+        // Kolejkowane połączenie: dostarczenie powiadomienia nie wstrzymuje obsługi odpowiedzi
+        connect(alertMonitor, &AlertMonitor::alertChanged, alertNotifier, &AlertNotifier::deliver, Qt::QueuedConnection);
+        connect(alertMonitor, &AlertMonitor::locationUpdated, this, [this](const AirQualityFrame &update) {
+            AirQualityFrame frame = update;
+            const std::string location = frame.location;
+            applyDerivedSeries(frame);
+            store.merge(std::move(frame));
+            if (const AirQualityFrame *stored = store.find(location))
+                ranking.update(location, *stored, QDateTime::currentSecsSinceEpoch());
+            updatedLocations.insert(QString::fromStdString(location));
+        });
+        connect(alertMonitor, &AlertMonitor::cycleFinished, this, [this](int locations, int events) {
+            refreshLocationSelector();
+            std::vector<std::string> updated;
+            for (const QString &location : std::as_const(updatedLocations)) updated.push_back(location.toStdString());
+            updatedLocations.clear();
+            if (!updated.empty()) updateStatsTable(updated);
+            if (rankingWindow && rankingWindow->isVisible()) rankingWindow->refresh();
+            if (dashboardWindow && dashboardWindow->isVisible()) {
+                dashboardWindow->setLocations(dashboardLocations());
+                dashboardWindow->refresh();
+            }
+            if (calendarWindow && calendarWindow->isVisible()) calendarWindow->refreshLocations(calendarWindow->currentLocation());
+            statusBar()->showMessage(QString("Alarmy: odpytano %1 lokalizacji, zmian stanu: %2, aktywnych alarmów: %3")
+                                         .arg(locations).arg(events).arg(alertMonitor->activeAlerts()));
+        });
+        updateAlertPolling();
+    }
+
+    // Funkcja włączająca odpytywanie, gdy są reguły i obserwowane lokalizacje
+    void updateAlertPolling() {
+        const bool needed = !alertMonitor->ruleLines().isEmpty() && !alertMonitor->watched().isEmpty();
+        if (needed && !alertMonitor->isActive()) alertMonitor->start(alertPollSeconds);
+        else if (!needed && alertMonitor->isActive()) alertMonitor->stop();
+    }
+
+    // Funkcja budująca indeks przestrzenny lokalizacji z magazynu i pamięci podręcznej geokodowania
+    void rebuildLocationIndex() {
+        if (!locationIndexDirty) return;
+
+        std::vector<GeoPoint> points;
+        QSet<QString> seen;
+        indexedLabels.clear();
+        for (const auto &[location, frame] : store.frames()) {
+            if (std::isnan(frame.latitude) || std::isnan(frame.longitude)) continue;
+            const QString label = QString::fromStdString(location);
+            seen.insert(label);
+            indexedLabels.append(label);
+            points.push_back({frame.latitude, frame.longitude});
+        }
+        for (const GeocodeEntry &entry : geocodeCache.entries()) {
+            const QString label = AddressCompleter::labelFor(entry);
+            if (seen.contains(label)) continue;
+            seen.insert(label);
+            indexedLabels.append(label);
+            points.push_back({entry.latitude, entry.longitude});
+        }
+        locationIndex.build(points);
+        locationIndexDirty = false;
+    }
+
+    // Funkcja odczytująca adresy z pliku; przy średniku lub tabulatorze brana jest pierwsza kolumna
+    static QStringList readAddressList(const QString &fileName) {
+        QStringList addresses;
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return addresses;
+
+        QTextStream in(&file);
+        while (!in.atEnd()) {
+            QString line = in.readLine();
+            const qsizetype separator = line.indexOf(QRegularExpression("[;\\t]"));
+            if (separator >= 0) line.truncate(separator);
+            line = line.trimmed();
+            if (line.size() >= 2 && line.startsWith('"') && line.endsWith('"')) line = line.mid(1, line.size() - 2);
+            if (line.isEmpty() || line.compare("address", Qt::CaseInsensitive) == 0
+                || line.compare("adres", Qt::CaseInsensitive) == 0)
+                continue;
+            addresses.append(line);
+        }
+        return addresses;
+    }
+
+    // Funkcja odświeżająca listę lokalizacji zapisanych w lokalnym magazynie
+    void refreshLocationSelector() {
+        locationIndexDirty = true;
+        const QString selected = locationSelector->currentText();
+        QSignalBlocker blocker(locationSelector);
+        locationSelector->clear();
+        for (const auto &item : store.frames()) {
+            locationSelector->addItem(QString::fromStdString(item.first));
+            if (addressCompleter) addressCompleter->addLocation(QString::fromStdString(item.first), 0);
+        }
+        locationSelector->setCurrentIndex(locationSelector->findText(selected));
+    }
 
     // Funkcja tworząca główne okno aplikacji
     void setupUI() {
@@ -252,6 +1327,29 @@ private:
         addressInput = new QLineEdit();
         addressInput->setPlaceholderText("np. 'Kraków, PL'");
         inputLayout->addWidget(addressInput);
+        inputLayout->addWidget(new QLabel("Zapisane lokalizacje:"));
+        locationSelector = new QComboBox();
+        locationSelector->setMinimumContentsLength(20);
+        connect(locationSelector, &QComboBox::textActivated, this, &WeatherApp::showStoredLocation);
+        inputLayout->addWidget(locationSelector);
+        inputLayout->addWidget(new QLabel("Rozdzielczość pogody:"));
+        resolutionSelector = new QComboBox();
+        resolutionSelector->addItem("1 h", static_cast<int>(Resolution::Hourly));
+        resolutionSelector->addItem("15 min", static_cast<int>(Resolution::Minutely15));
+        inputLayout->addWidget(resolutionSelector);
+        inputLayout->addWidget(new QLabel("Luki na wykresach:"));
+        gapFillSelector = new QComboBox();
+        gapFillSelector->addItem("bez uzupełniania", static_cast<int>(GapFill::None));
+        gapFillSelector->addItem("interpolacja liniowa", static_cast<int>(GapFill::Linear));
+        gapFillSelector->addItem("interpolacja sezonowa", static_cast<int>(GapFill::Seasonal));
+        connect(gapFillSelector, &QComboBox::currentIndexChanged, this, [this]() { showStoredLocation(currentLocation); });
+        inputLayout->addWidget(gapFillSelector);
+        inputLayout->addWidget(new QLabel("Histogram:"));
+        histogramScaleSelector = new QComboBox();
+        histogramScaleSelector->addItem("liniowy", static_cast<int>(HistogramScale::Linear));
+        histogramScaleSelector->addItem("logarytmiczny", static_cast<int>(HistogramScale::Log));
+        connect(histogramScaleSelector, &QComboBox::currentIndexChanged, this, [this]() { showStoredLocation(currentLocation); });
+        inputLayout->addWidget(histogramScaleSelector);
         mainLayout->addLayout(inputLayout);
 
         // Przyciski
@@ -263,6 +1361,82 @@ private:
         QPushButton *loadButton = new QPushButton("Wczytaj z pliku");
         connect(loadButton, &QPushButton::clicked, this, &WeatherApp::loadFromFile);
         buttonLayout->addWidget(loadButton);
+
+        QPushButton *loadDirectoryButton = new QPushButton("Wczytaj katalog");
+        connect(loadDirectoryButton, &QPushButton::clicked, this, &WeatherApp::loadFromDirectory);
+        buttonLayout->addWidget(loadDirectoryButton);
+
+        QPushButton *importButton = new QPushButton("Importuj CSV");
+        connect(importButton, &QPushButton::clicked, this, &WeatherApp::importCsvFile);
+        buttonLayout->addWidget(importButton);
+
+        QPushButton *nearestButton = new QPushButton("Najbliższe lokalizacje");
+        connect(nearestButton, &QPushButton::clicked, this, &WeatherApp::findNearestLocations);
+        buttonLayout->addWidget(nearestButton);
+
+        QPushButton *travelButton = new QPushButton("Tryb podróży (NMEA)");
+        connect(travelButton, &QPushButton::clicked, this, &WeatherApp::toggleTravelMode);
+        buttonLayout->addWidget(travelButton);
+
+        QPushButton *heatmapButton = new QPushButton("Mapa zanieczyszczeń");
+        connect(heatmapButton, &QPushButton::clicked, this, &WeatherApp::showHeatmap);
+        buttonLayout->addWidget(heatmapButton);
+
+        QPushButton *mapButton = new QPushButton("Mapa lokalizacji");
+        connect(mapButton, &QPushButton::clicked, this, &WeatherApp::showStationMap);
+        buttonLayout->addWidget(mapButton);
+
+        QPushButton *profileButton = new QPushButton("Profile dobowe");
+        connect(profileButton, &QPushButton::clicked, this, &WeatherApp::showProfiles);
+        buttonLayout->addWidget(profileButton);
+
+        QPushButton *correlationButton = new QPushButton("Korelacje");
+        connect(correlationButton, &QPushButton::clicked, this, &WeatherApp::showCorrelations);
+        buttonLayout->addWidget(correlationButton);
+
+        QPushButton *rankingButton = new QPushButton("Ranking");
+        connect(rankingButton, &QPushButton::clicked, this, &WeatherApp::showRanking);
+        buttonLayout->addWidget(rankingButton);
+
+        QPushButton *dashboardButton = new QPushButton("Panel");
+        connect(dashboardButton, &QPushButton::clicked, this, &WeatherApp::showDashboard);
+        buttonLayout->addWidget(dashboardButton);
+
+        QPushButton *distributionButton = new QPushButton("Rozkłady");
+        connect(distributionButton, &QPushButton::clicked, this, &WeatherApp::showDistributions);
+        buttonLayout->addWidget(distributionButton);
+
+        QPushButton *calendarButton = new QPushButton("Kalendarz");
+        connect(calendarButton, &QPushButton::clicked, this, &WeatherApp::showCalendar);
+        buttonLayout->addWidget(calendarButton);
+
+        QPushButton *geocodeButton = new QPushButton("Geokoduj listę");
+        connect(geocodeButton, &QPushButton::clicked, this, &WeatherApp::geocodeAddressList);
+        buttonLayout->addWidget(geocodeButton);
+
+        QPushButton *derivedButton = new QPushButton("Seria pochodna");
+        connect(derivedButton, &QPushButton::clicked, this, &WeatherApp::addDerivedSeries);
+        buttonLayout->addWidget(derivedButton);
+
+        QPushButton *watchButton = new QPushButton("Obserwuj lokalizację");
+        connect(watchButton, &QPushButton::clicked, this, &WeatherApp::toggleWatchedLocation);
+        buttonLayout->addWidget(watchButton);
+
+        QPushButton *alertsButton = new QPushButton("Reguły alarmów");
+        connect(alertsButton, &QPushButton::clicked, this, &WeatherApp::editAlertRules);
+        buttonLayout->addWidget(alertsButton);
+
+        QPushButton *forecastButton = new QPushButton("Prognoza lokalna");
+        connect(forecastButton, &QPushButton::clicked, this, &WeatherApp::updateForecasts);
+        buttonLayout->addWidget(forecastButton);
+
+        QPushButton *trendButton = new QPushButton("Trendy");
+        connect(trendButton, &QPushButton::clicked, this, &WeatherApp::exportTrends);
+        buttonLayout->addWidget(trendButton);
+
+        QPushButton *exportButton = new QPushButton("Eksportuj");
+        connect(exportButton, &QPushButton::clicked, this, &WeatherApp::exportStore);
+        buttonLayout->addWidget(exportButton);
         mainLayout->addLayout(buttonLayout);
 
         // Wyświetlanie danych
@@ -271,11 +1445,39 @@ private:
         weatherDisplay->setMaximumHeight(100);
         mainLayout->addWidget(weatherDisplay);
 
-        // Statystyki
-        statsDisplay = new QTextEdit();
-        statsDisplay->setReadOnly(true);
-        statsDisplay->setMaximumHeight(150);
-        mainLayout->addWidget(statsDisplay);
+        // Statystyki wszystkich lokalizacji: sortowanie po kliknięciu nagłówka, filtr tekstowy
+        statsModel = new StatsTableModel(this);
+        statsFilter = new StatsFilterModel(this);
+        statsFilter->setSourceModel(statsModel);
+        statsFilter->setSortRole(Qt::UserRole);
+        statsFilter->setFilterCaseSensitivity(Qt::CaseInsensitive);
+        statsFilter->setFilterKeyColumn(-1);
+
+        QHBoxLayout *statsFilterLayout = new QHBoxLayout();
+        statsFilterLayout->addWidget(new QLabel("Filtr statystyk:"));
+        QLineEdit *statsFilterInput = new QLineEdit();
+        statsFilterInput->setPlaceholderText("lokalizacja lub parametr");
+        connect(statsFilterInput, &QLineEdit::textChanged, statsFilter, &StatsFilterModel::setFilterFixedString);
+        statsFilterLayout->addWidget(statsFilterInput, 1);
+        statsCurrentOnly = new QCheckBox("Tylko bieżąca lokalizacja");
+        statsCurrentOnly->setChecked(true);
+        connect(statsCurrentOnly, &QCheckBox::toggled, this, [this](bool checked) {
+            statsFilter->setLocation(checked ? currentLocation : QString());
+        });
+        statsFilterLayout->addWidget(statsCurrentOnly);
+        mainLayout->addLayout(statsFilterLayout);
+
+        QTableView *statsView = new QTableView();
+        statsView->setModel(statsFilter);
+        statsView->setSortingEnabled(true);
+        statsView->sortByColumn(StatsTableModel::Location, Qt::AscendingOrder);
+        statsView->setSelectionBehavior(QAbstractItemView::SelectRows);
+        statsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        statsView->verticalHeader()->setVisible(false);
+        statsView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        statsView->horizontalHeader()->setSectionResizeMode(StatsTableModel::Parameter, QHeaderView::Stretch);
+        statsView->setMaximumHeight(220);
+        mainLayout->addWidget(statsView);
 
         // Wykresy
         QScrollArea *scrollArea = new QScrollArea();
@@ -291,9 +1493,51 @@ private:
     }
 };
 
+// Tryb wsadowy: import plików CSV / JSON i eksport magazynu bez otwierania okna
+static int runBatch(const QStringList &csvFiles, const QStringList &jsonPaths, const QString &exportFile) {
+    LocationStore store;
+    for (const QString &fileName : csvFiles) {
+        CsvImporter::Result result = CsvImporter::importFile(fileName);
+        if (!result.error.isEmpty()) {
+            qCritical().noquote() << fileName << ":" << result.error;
+            return 1;
+        }
+        for (AirQualityFrame &frame : result.frames)
+            store.merge(std::move(frame));
+    }
+
+    QStringList snapshots;
+    for (const QString &path : jsonPaths)
+        snapshots += QFileInfo(path).isDir() ? SnapshotLoader::snapshotFiles(path) : QStringList{path};
+    if (!snapshots.isEmpty()) {
+        SnapshotLoader::Result result = SnapshotLoader::loadFiles(snapshots);
+        for (AirQualityFrame &frame : result.frames)
+            store.merge(std::move(frame));
+    }
+
+    std::string error;
+    const std::string path = exportFile.toStdString();
+    if (!ColumnarExporter::exportStore(store, path, ColumnarExporter::formatForFile(path), error)) {
+        qCritical().noquote() << exportFile << ":" << QString::fromStdString(error);
+        return 1;
+    }
+    return 0;
+}
+
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption importOption("import-csv", "Importuj plik CSV (można podać wielokrotnie)", "plik");
+    QCommandLineOption loadOption("load", "Wczytaj plik JSON lub katalog z plikami JSON", "ścieżka");
+    QCommandLineOption exportOption("export", "Eksportuj dane do pliku CSV lub Arrow (.arrow, .feather) i zakończ", "plik");
+    parser.addOptions({importOption, loadOption, exportOption});
+    parser.process(app);
+
+    if (parser.isSet(exportOption))
+        return runBatch(parser.values(importOption), parser.values(loadOption), parser.value(exportOption));
+
     WeatherApp window;
     window.show();
     return app.exec();
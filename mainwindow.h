@@ -6,6 +6,9 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QTextEdit>
+#include <QComboBox>
+#include <QInputDialog>
+#include <QtConcurrent/QtConcurrent>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QNetworkAccessManager>
@@ -14,11 +17,55 @@
 #include <QtCharts/QChartView>
 #include <QtCharts/QLineSeries>
 #include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QAreaSeries>
 #include <QtCharts/QValueAxis>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QCommandLineParser>
+#include <QFileInfo>
+#include <QDebug>
+#include <QDir>
+#include <QProgressDialog>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QSet>
+#include <QGeoCoordinate>
+#include <QGeoPositionInfoSource>
+#include <QStatusBar>
+#include <QSystemTrayIcon>
+#include <QCheckBox>
+#include <QTableView>
+#include <QHeaderView>
 
 #include<nlohmann/json.hpp>
 #include <fstream>
 #include<windows.h>
 
+#include "airqualityframe.h"
+#include "pollutants.h"
+#include "csvimporter.h"
+#include "snapshotloader.h"
+#include "columnarexporter.h"
+#include "geocoder.h"
+#include "addresscompleter.h"
+#include "spatialindex.h"
+#include "openmeteo.h"
+#include "positionprefetcher.h"
+#include "heatmap.h"
+#include "stationmap.h"
+#include "framejoin.h"
+#include "expression.h"
+#include "exceedance.h"
+#include "alertmonitor.h"
+#include "profilewindow.h"
+#include "trend.h"
+#include "correlationwindow.h"
+#include "forecast.h"
+#include "gaps.h"
+#include "distributionwindow.h"
+#include "rankingwindow.h"
+#include "statstable.h"
+#include "dashboardwindow.h"
+#include "calendarwindow.h"
+
 using json = nlohmann::json;
@@ -0,0 +1,132 @@
+#include "markercluster.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double Pi = 3.14159265358979323846;
+const double MaxLatitude = 85.05112878;
+const size_t LeafCapacity = 8;
+const int MaxDepth = 24;
+
+double mercatorX(double longitude) {
+    return std::clamp((longitude + 180.0) / 360.0, 0.0, 1.0);
+}
+
+double mercatorY(double latitude) {
+    const double phi = std::clamp(latitude, -MaxLatitude, MaxLatitude) * Pi / 180.0;
+    return (1.0 - std::log(std::tan(phi) + 1.0 / std::cos(phi)) / Pi) / 2.0;
+}
+
+double latitudeFromMercator(double y) {
+    return std::atan(std::sinh(Pi * (1.0 - 2.0 * y))) * 180.0 / Pi;
+}
+
+} // namespace
+
+void MarkerQuadtree::build(const std::vector<GeoPoint> &newPoints, const std::vector<int> &levels) {
+    points = newPoints;
+    pointLevels = levels;
+    pointLevels.resize(points.size(), -1);
+    xs.resize(points.size());
+    ys.resize(points.size());
+    order.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        xs[i] = mercatorX(points[i].longitude);
+        ys[i] = mercatorY(points[i].latitude);
+        order[i] = i;
+    }
+
+    nodes.clear();
+    nodes.reserve(points.size() / 2 + 1);
+    Node root;
+    root.x = 0.0;
+    root.y = 0.0;
+    root.size = 1.0;
+    root.end = points.size();
+    nodes.push_back(root);
+    buildNode(0, 0);
+}
+
+void MarkerQuadtree::buildNode(int index, int depth) {
+    {
+        Node &node = nodes[index];
+        node.count = node.end - node.begin;
+        for (size_t i = node.begin; i < node.end; ++i) {
+            node.sumX += xs[order[i]];
+            node.sumY += ys[order[i]];
+            node.level = std::max(node.level, pointLevels[order[i]]);
+        }
+        if (node.count <= LeafCapacity || depth >= MaxDepth) return;
+    }
+
+    // Podział zakresu na ćwiartki w miejscu: najpierw według y, potem każdej połowy według x
+    const Node parent = nodes[index];
+    const double half = parent.size / 2.0, midX = parent.x + half, midY = parent.y + half;
+    auto first = order.begin() + parent.begin, last = order.begin() + parent.end;
+    auto middle = std::partition(first, last, [&](size_t i) { return ys[i] < midY; });
+    auto topSplit = std::partition(first, middle, [&](size_t i) { return xs[i] < midX; });
+    auto bottomSplit = std::partition(middle, last, [&](size_t i) { return xs[i] < midX; });
+    const size_t bounds[5] = {parent.begin, static_cast<size_t>(topSplit - order.begin()),
+                              static_cast<size_t>(middle - order.begin()),
+                              static_cast<size_t>(bottomSplit - order.begin()), parent.end};
+
+    const int firstChild = static_cast<int>(nodes.size());
+    nodes[index].firstChild = firstChild;
+    for (int k = 0; k < 4; ++k) {
+        Node child;
+        child.x = parent.x + (k % 2) * half;
+        child.y = parent.y + (k / 2) * half;
+        child.size = half;
+        child.begin = bounds[k];
+        child.end = bounds[k + 1];
+        nodes.push_back(child);
+    }
+    for (int k = 0; k < 4; ++k) buildNode(firstChild + k, depth + 1);
+}
+
+std::vector<MarkerCluster> MarkerQuadtree::clusters(double zoom, double north, double west, double south,
+                                                    double east, double clusterPixels) const {
+    std::vector<MarkerCluster> out;
+    if (nodes.empty() || points.empty()) return out;
+
+    const double cellSize = clusterPixels / (256.0 * std::pow(2.0, zoom));
+    const double y0 = mercatorY(north), y1 = mercatorY(south);
+    if (west <= east) {
+        collect(0, cellSize, mercatorX(west), y0, mercatorX(east), y1, out);
+    } else {
+        collect(0, cellSize, mercatorX(west), y0, 1.0, y1, out);
+        collect(0, cellSize, 0.0, y0, mercatorX(east), y1, out);
+    }
+    return out;
+}
+
+void MarkerQuadtree::collect(int index, double cellSize, double x0, double y0, double x1, double y1,
+                             std::vector<MarkerCluster> &out) const {
+    const Node &node = nodes[index];
+    if (node.count == 0 || node.x > x1 || node.x + node.size < x0 || node.y > y1 || node.y + node.size < y0)
+        return;
+
+    if (node.count == 1) {
+        const size_t point = order[node.begin];
+        out.push_back({points[point].latitude, points[point].longitude, 1, node.level, point});
+        return;
+    }
+    if (node.size <= cellSize) {
+        const double x = node.sumX / node.count, y = node.sumY / node.count;
+        out.push_back({latitudeFromMercator(y), x * 360.0 - 180.0, node.count, node.level, order[node.begin]});
+        return;
+    }
+
+    if (node.firstChild < 0) {
+        for (size_t i = node.begin; i < node.end; ++i) {
+            const size_t point = order[i];
+            if (xs[point] < x0 || xs[point] > x1 || ys[point] < y0 || ys[point] > y1) continue;
+            out.push_back({points[point].latitude, points[point].longitude, 1, pointLevels[point], point});
+        }
+        return;
+    }
+
+    for (int k = 0; k < 4; ++k) collect(node.firstChild + k, cellSize, x0, y0, x1, y1, out);
+}
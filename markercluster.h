@@ -0,0 +1,58 @@
+#ifndef MARKERCLUSTER_H
+#define MARKERCLUSTER_H
+
+#include <cstddef>
+#include <vector>
+
+#include "spatialindex.h"
+
+struct MarkerCluster {
+    double latitude;
+    double longitude;
+    size_t count;
+    int level;      // najwyższa klasa w klastrze, -1 gdy żaden znacznik nie ma danych
+    size_t index;   // indeks znacznika (znaczący tylko dla count == 1)
+};
+
+/*!
+ * \brief Drzewo czwórkowe znaczników mapy do grupowania zależnego od przybliżenia
+ * \details Punkty przechowywane są we współrzędnych Web Mercator znormalizowanych do [0, 1],
+ * tych samych, w których rysowane są kafelki mapy. Każdy węzeł przechowuje liczbę punktów,
+ * sumę współrzędnych (środek ciężkości) i najwyższą klasę, więc zapytanie dla danego
+ * przybliżenia schodzi tylko do węzłów mniejszych niż promień grupowania w pikselach
+ * i odcina węzły poza widokiem - koszt zależy od liczby widocznych klastrów, a nie znaczników.
+ */
+class MarkerQuadtree {
+public:
+    // levels[i] to klasa punktu points[i]; indeksy w klastrach odpowiadają kolejności punktów
+    void build(const std::vector<GeoPoint> &points, const std::vector<int> &levels);
+
+    // Klastry dla poziomu przybliżenia (kafelki 256 px) w prostokącie widoku; west > east oznacza
+    // widok przechodzący przez południk 180°
+    std::vector<MarkerCluster> clusters(double zoom, double north, double west, double south, double east,
+                                        double clusterPixels = 60.0) const;
+
+    size_t size() const { return points.size(); }
+
+private:
+    struct Node {
+        double x, y, size;
+        double sumX = 0.0, sumY = 0.0;
+        size_t count = 0;
+        int level = -1;
+        int firstChild = -1;
+        size_t begin = 0, end = 0;
+    };
+
+    void buildNode(int node, int depth);
+    void collect(int node, double cellSize, double x0, double y0, double x1, double y1,
+                 std::vector<MarkerCluster> &out) const;
+
+    std::vector<Node> nodes;
+    std::vector<size_t> order;
+    std::vector<double> xs, ys;
+    std::vector<int> pointLevels;
+    std::vector<GeoPoint> points;
+};
+
+#endif // MARKERCLUSTER_H
@@ -0,0 +1,48 @@
+#include "openmeteo.h"
+
+#include <QString>
+#include <QStringList>
+
+#include "pollutants.h"
+
+QUrl airQualityRequestUrl(double latitude, double longitude) {
+    return airQualityRequestUrl(std::vector<GeoPoint>{{latitude, longitude}}, HistoryDays);
+}
+
+QUrl airQualityRequestUrl(const std::vector<GeoPoint> &points, int pastDays) {
+    QStringList latitudes, longitudes;
+    for (const GeoPoint &point : points) {
+        latitudes.append(QString::number(point.latitude));
+        longitudes.append(QString::number(point.longitude));
+    }
+
+    QStringList parameters;
+    for (const Pollutant &pollutant : pollutants)
+        parameters.append(QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+
+    return QUrl(QString(
+                    "https://air-quality-api.open-meteo.com/v1/air-quality?"
+                    "latitude=%1&longitude=%2&"
+                    "hourly=%3&"
+                    "timezone=auto&timeformat=unixtime&"
+                    "past_days=%4&"
+                    "forecast_days=%5"
+                    ).arg(latitudes.join(','), longitudes.join(','), parameters.join(','), QString::number(pastDays),
+                         QString::number(ForecastDays)));
+}
+
+QUrl weatherRequestUrl(double latitude, double longitude, Resolution resolution) {
+    const QString surface = "temperature_2m,relative_humidity_2m,wind_speed_10m,wind_direction_10m";
+    const QString series = resolution == Resolution::Minutely15
+                               ? QString("minutely_15=%1&hourly=boundary_layer_height").arg(surface)
+                               : QString("hourly=%1,boundary_layer_height").arg(surface);
+
+    return QUrl(QString(
+                    "https://api.open-meteo.com/v1/forecast?"
+                    "latitude=%1&longitude=%2&"
+                    "%3&"
+                    "timezone=auto&timeformat=unixtime&"
+                    "past_days=%4&"
+                    "forecast_days=%5"
+                    ).arg(latitude).arg(longitude).arg(series).arg(HistoryDays).arg(ForecastDays));
+}
@@ -0,0 +1,34 @@
+#ifndef OPENMETEO_H
+#define OPENMETEO_H
+
+#include <QUrl>
+
+#include <vector>
+
+#include "spatialindex.h"
+
+// Dni historii pobieranej dla pojedynczej lokalizacji: prognoza lokalna (HoltWintersForecaster) wymaga
+// co najmniej trzech pełnych dób pomiarów przed bieżącą chwilą
+inline constexpr int HistoryDays = 7;
+
+// Dni prognozy w każdym zapytaniu
+inline constexpr int ForecastDays = 3;
+
+// Adres zapytania do Open-Meteo Air Quality API dla podanych współrzędnych (HistoryDays dni historii).
+// Znaczniki czasu zwracane są w sekundach UTC (timeformat=unixtime), a odpowiedź zawiera strefę czasową
+// lokalizacji (timezone=auto)
+QUrl airQualityRequestUrl(double latitude, double longitude);
+
+// Jedno zapytanie dla wielu punktów naraz z pastDays dniami historii; odpowiedzią jest tablica obiektów
+// w kolejności punktów
+QUrl airQualityRequestUrl(const std::vector<GeoPoint> &points, int pastDays = 2);
+
+enum class Resolution { Hourly, Minutely15 };
+
+// Adres zapytania do Open-Meteo Forecast API o zmienne pogodowe (temperatura, wiatr, warstwa graniczna)
+// w tym samym zakresie czasu co dane o jakości powietrza. Przy Minutely15 zmienne dostępne w kroku
+// 15-minutowym pobierane są jako "minutely_15" (poza obszarami z modelem 15-minutowym API interpoluje),
+// a wysokość warstwy granicznej - godzinowo
+QUrl weatherRequestUrl(double latitude, double longitude, Resolution resolution = Resolution::Hourly);
+
+#endif // OPENMETEO_H
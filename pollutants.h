@@ -0,0 +1,56 @@
+#ifndef POLLUTANTS_H
+#define POLLUTANTS_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+// Typ, w jakim kolumna parametru zapisywana jest w eksporcie kolumnowym
+enum class ColumnStorage { Float32, Float64 };
+
+/*!
+ * \brief Opis parametru jakości powietrza udostępnianego przez Open-Meteo Air Quality API
+ * \details Tabela pollutants jest jedynym miejscem, w którym wymienione są parametry: na jej
+ * podstawie budowane jest zapytanie do API, wyświetlane są statystyki i wykresy, liczony jest
+ * indeks jakości powietrza i dobierany typ kolumn w eksporcie. Dodanie parametru sprowadza się
+ * do dopisania wiersza - parser odpowiedzi dekoduje wszystkie serie w jednym przebiegu.
+ */
+struct Pollutant {
+    std::string_view apiName;
+    const char *displayName;
+    const char *unit;
+    std::uint32_t color;                // 0xRRGGBB
+    double limit;                       // wartość dopuszczalna lub docelowa (UE), NaN gdy brak
+    double whoGuideline;                // poziom wytycznych WHO 2021 (średnia dobowa, dla O3 8-godzinna), NaN gdy brak
+    std::int64_t guidelineWindow;       // okres uśredniania wytycznej WHO [s], 0 gdy brak
+    double scaleMax;                    // górna granica skali kolorów map
+    std::array<double, 5> aqiBounds;    // górne granice klas 0-4 indeksu EAQI; zera - poza indeksem
+    ColumnStorage storage;
+
+    constexpr bool inAqi() const { return aqiBounds[0] > 0.0; }
+};
+
+inline constexpr double NoLimit = std::numeric_limits<double>::quiet_NaN();
+
+inline constexpr Pollutant pollutants[] = {
+    {"pm10", "PM10", "µg/m³", 0xff0000, 50.0, 45.0, 86400, 100.0, {20, 40, 50, 100, 150}, ColumnStorage::Float32},
+    {"pm2_5", "PM2.5", "µg/m³", 0x0000ff, 25.0, 15.0, 86400, 50.0, {10, 20, 25, 50, 75}, ColumnStorage::Float32},
+    {"nitrogen_dioxide", "NO₂", "µg/m³", 0x008000, 200.0, 25.0, 86400, 100.0, {40, 90, 120, 230, 340}, ColumnStorage::Float32},
+    {"ozone", "O₃", "µg/m³", 0xff8c00, 120.0, 100.0, 28800, 180.0, {50, 100, 130, 240, 380}, ColumnStorage::Float32},
+    {"sulphur_dioxide", "SO₂", "µg/m³", 0x8b4513, 350.0, 40.0, 86400, 100.0, {100, 200, 350, 500, 750}, ColumnStorage::Float32},
+    {"carbon_monoxide", "CO", "µg/m³", 0x696969, 10000.0, 4000.0, 86400, 1000.0, {}, ColumnStorage::Float32},
+    {"dust", "Pył saharyjski", "µg/m³", 0xdaa520, NoLimit, NoLimit, 0, 100.0, {}, ColumnStorage::Float32},
+    {"aerosol_optical_depth", "Grubość optyczna aerozolu", "", 0x9400d3, NoLimit, NoLimit, 0, 1.0, {}, ColumnStorage::Float32},
+};
+
+// Opis parametru o podanej nazwie z API; nullptr dla parametrów spoza tabeli (np. pogodowych)
+constexpr const Pollutant *findPollutant(std::string_view apiName) {
+    for (const Pollutant &pollutant : pollutants)
+        if (pollutant.apiName == apiName) return &pollutant;
+    return nullptr;
+}
+
+static_assert(findPollutant("pm10") && !findPollutant("temperature_2m"), "Niespójna tabela parametrów");
+
+#endif // POLLUTANTS_H
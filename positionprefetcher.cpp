@@ -0,0 +1,181 @@
+#include "positionprefetcher.h"
+
+#include "openmeteo.h"
+
+#include <QFile>
+#include <QGeoPositionInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QNmeaPositionInfoSource>
+#include <QTimer>
+
+#include <algorithm>
+#include <cmath>
+
+PositionPrefetcher::PositionPrefetcher(QObject *parent) : QObject(parent),
+    network(new QNetworkAccessManager(this)),
+    ticker(new QTimer(this)) {
+
+    ticker->setInterval(1000);
+    // Budżet przepustowości uzupełniany co sekundę (kubełek z żetonami)
+    connect(ticker, &QTimer::timeout, this, [this]() {
+        tokens = std::min(bytesPerMinute, tokens + bytesPerMinute / 60);
+        dispatch();
+    });
+    connect(network, &QNetworkAccessManager::finished, this, &PositionPrefetcher::handleReply);
+}
+
+bool PositionPrefetcher::startFromNmeaFile(const QString &fileName) {
+    stop();
+
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return false;
+    }
+
+    QNmeaPositionInfoSource *nmea = new QNmeaPositionInfoSource(QNmeaPositionInfoSource::SimulationMode, this);
+    file->setParent(nmea);
+    nmea->setDevice(file);
+    source = nmea;
+    connect(source, &QGeoPositionInfoSource::positionUpdated, this, &PositionPrefetcher::positionUpdated);
+    source->startUpdates();
+    ticker->start();
+    return true;
+}
+
+void PositionPrefetcher::stop() {
+    ticker->stop();
+    queue.clear();
+    if (inFlight) {
+        QNetworkReply *reply = inFlight;
+        inFlight = nullptr;
+        reply->abort();
+    }
+    hasCurrentCell = false;
+    if (source) {
+        source->stopUpdates();
+        source->deleteLater();
+        source = nullptr;
+    }
+}
+
+void PositionPrefetcher::setBudget(qint64 bytes, int cellsLimit) {
+    bytesPerMinute = std::max<qint64>(bytes, 1);
+    tokens = std::min(tokens, bytesPerMinute);
+    maxCells = std::max(cellsLimit, (2 * ringRadius + 1) * (2 * ringRadius + 1));
+    evict();
+}
+
+quint64 PositionPrefetcher::cellKey(qint64 row, qint64 column) {
+    return (static_cast<quint64>(row & 0xFFFFFFFF) << 32) | static_cast<quint64>(column & 0xFFFFFFFF);
+}
+
+quint64 PositionPrefetcher::keyAt(const QGeoCoordinate &coordinate) const {
+    return cellKey(static_cast<qint64>(std::floor(coordinate.latitude() / cellSize)),
+                   static_cast<qint64>(std::floor(coordinate.longitude() / cellSize)));
+}
+
+const AirQualityFrame *PositionPrefetcher::frameAt(const QGeoCoordinate &coordinate) const {
+    auto it = cells.constFind(keyAt(coordinate));
+    return it != cells.constEnd() ? &it->frame : nullptr;
+}
+
+void PositionPrefetcher::positionUpdated(const QGeoPositionInfo &info) {
+    const QGeoCoordinate coordinate = info.coordinate();
+    if (!coordinate.isValid()) return;
+
+    const quint64 key = keyAt(coordinate);
+    if (hasCurrentCell && key == currentCell) return;
+    hasCurrentCell = true;
+    currentCell = key;
+
+    auto it = cells.find(key);
+    if (it != cells.end()) {
+        it->lastUsed = ++useCounter;
+        emit currentCellData(it->frame);
+    }
+    scheduleNeighbourhood(coordinate);
+}
+
+// Kolejka komórek wokół pozycji, od najbliższej; komórki już pobrane są pomijane
+void PositionPrefetcher::scheduleNeighbourhood(const QGeoCoordinate &coordinate) {
+    const qint64 row = static_cast<qint64>(std::floor(coordinate.latitude() / cellSize));
+    const qint64 column = static_cast<qint64>(std::floor(coordinate.longitude() / cellSize));
+
+    QList<QPair<int, quint64>> candidates;
+    for (int dr = -ringRadius; dr <= ringRadius; ++dr)
+        for (int dc = -ringRadius; dc <= ringRadius; ++dc) {
+            const quint64 key = cellKey(row + dr, column + dc);
+            if (cells.contains(key)) cells[key].lastUsed = ++useCounter;
+            else candidates.append({dr * dr + dc * dc, key});
+        }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    queue.clear();
+    for (const auto &candidate : candidates) queue.append(candidate.second);
+    dispatch();
+}
+
+void PositionPrefetcher::dispatch() {
+    if (inFlight || queue.isEmpty() || tokens <= 0) {
+        reportStatus();
+        return;
+    }
+
+    const quint64 key = queue.takeFirst();
+    const double latitude = (static_cast<qint32>(key >> 32) + 0.5) * cellSize;
+    const double longitude = (static_cast<qint32>(key & 0xFFFFFFFF) + 0.5) * cellSize;
+    inFlight = network->get(QNetworkRequest(airQualityRequestUrl(latitude, longitude)));
+    inFlight->setProperty("cellKey", key);
+    reportStatus();
+}
+
+void PositionPrefetcher::handleReply(QNetworkReply *reply) {
+    reply->deleteLater();
+    if (reply != inFlight) return;
+    inFlight = nullptr;
+    if (reply->error() != QNetworkReply::NoError) return;
+
+    const QByteArray data = reply->readAll();
+    tokens -= data.size();
+    downloadedBytes += data.size();
+
+    try {
+        const quint64 key = reply->property("cellKey").toULongLong();
+        Cell cell;
+        std::vector<AirQualityFrame> frames = framesFromJsonText(data.constData(), data.size());
+        if (frames.empty()) return;
+        cell.frame = std::move(frames.front());
+        cell.frame.location = QString("Komórka %1, %2")
+                                  .arg(cell.frame.latitude, 0, 'f', 2)
+                                  .arg(cell.frame.longitude, 0, 'f', 2)
+                                  .toStdString();
+        cell.lastUsed = ++useCounter;
+        cells.insert(key, std::move(cell));
+        evict();
+        if (hasCurrentCell && key == currentCell) emit currentCellData(cells[key].frame);
+    } catch (const std::exception &) {
+        // Uszkodzona odpowiedź - komórka zostanie pobrana przy kolejnym wejściu w jej otoczenie
+    }
+    dispatch();
+}
+
+void PositionPrefetcher::evict() {
+    while (cells.size() > maxCells) {
+        auto oldest = cells.end();
+        for (auto it = cells.begin(); it != cells.end(); ++it)
+            if ((!hasCurrentCell || it.key() != currentCell) && (oldest == cells.end() || it->lastUsed < oldest->lastUsed)) oldest = it;
+        if (oldest == cells.end()) break;
+        cells.erase(oldest);
+    }
+}
+
+void PositionPrefetcher::reportStatus() {
+    emit statusChanged(QString("Podróż: %1 komórek w pamięci, %2 w kolejce, pobrano %3 kB")
+                           .arg(cells.size())
+                           .arg(queue.size())
+                           .arg(downloadedBytes / 1024));
+}
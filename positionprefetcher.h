@@ -0,0 +1,77 @@
+#ifndef POSITIONPREFETCHER_H
+#define POSITIONPREFETCHER_H
+
+#include <QGeoCoordinate>
+#include <QHash>
+#include <QList>
+#include <QObject>
+
+#include "airqualityframe.h"
+
+class QGeoPositionInfo;
+class QGeoPositionInfoSource;
+class QNetworkAccessManager;
+class QNetworkReply;
+class QTimer;
+
+/*!
+ * \brief Wstępne pobieranie danych dla otoczenia bieżącej pozycji
+ * \details Pozycja pochodzi z QGeoPositionInfoSource (np. odtwarzany plik NMEA). Świat podzielony
+ * jest na komórki siatki; po wejściu do nowej komórki w tle pobierane są dane dla niej i dla
+ * sąsiednich komórek, więc po przejściu dalej dane są dostępne od razu. Pobieranie ograniczone
+ * jest budżetem przepustowości (bajty na minutę, jedno zapytanie naraz), a pamięć podręczna -
+ * liczbą komórek (usuwane są najdawniej używane).
+ */
+class PositionPrefetcher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PositionPrefetcher(QObject *parent = nullptr);
+
+    bool startFromNmeaFile(const QString &fileName);
+    void stop();
+    bool isActive() const { return source != nullptr; }
+
+    void setBudget(qint64 bytesPerMinute, int maxCells);
+    const AirQualityFrame *frameAt(const QGeoCoordinate &coordinate) const;
+
+signals:
+    // Dane komórki, w której znajduje się użytkownik (po wejściu do niej lub po ich pobraniu)
+    void currentCellData(const AirQualityFrame &frame);
+    void statusChanged(const QString &status);
+
+private slots:
+    void positionUpdated(const QGeoPositionInfo &info);
+    void dispatch();
+    void handleReply(QNetworkReply *reply);
+
+private:
+    struct Cell {
+        AirQualityFrame frame;
+        quint64 lastUsed = 0;
+    };
+
+    static quint64 cellKey(qint64 row, qint64 column);
+    quint64 keyAt(const QGeoCoordinate &coordinate) const;
+    void scheduleNeighbourhood(const QGeoCoordinate &coordinate);
+    void evict();
+    void reportStatus();
+
+    const double cellSize = 0.25;
+    const int ringRadius = 1;
+    QGeoPositionInfoSource *source = nullptr;
+    QNetworkAccessManager *network;
+    QTimer *ticker;
+    QHash<quint64, Cell> cells;
+    QList<quint64> queue;
+    quint64 currentCell = 0;
+    bool hasCurrentCell = false;
+    quint64 useCounter = 0;
+    QNetworkReply *inFlight = nullptr;
+    qint64 bytesPerMinute = 2 * 1024 * 1024;
+    qint64 tokens = 2 * 1024 * 1024;
+    qint64 downloadedBytes = 0;
+    int maxCells = 64;
+};
+
+#endif // POSITIONPREFETCHER_H
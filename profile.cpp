@@ -0,0 +1,125 @@
+#include "profile.h"
+
+#include <QDateTime>
+#include <QTimeZone>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Percentyl (0..1) posortowanego zakresu z interpolacją liniową między sąsiednimi wartościami
+double percentile(const double *sorted, size_t count, double fraction) {
+    const double position = fraction * (count - 1);
+    const size_t lower = static_cast<size_t>(position);
+    const size_t upper = std::min(lower + 1, count - 1);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * (position - lower);
+}
+
+} // namespace
+
+std::int32_t UtcOffsetTable::offsetAt(std::int64_t time) const {
+    return offsets[std::upper_bound(transitions.begin(), transitions.end(), time) - transitions.begin()];
+}
+
+UtcOffsetTable utcOffsetTable(const std::string &timezone, std::int64_t from, std::int64_t to) {
+    QTimeZone zone = timezone.empty() ? QTimeZone::systemTimeZone() : QTimeZone(QByteArray::fromStdString(timezone));
+    if (!zone.isValid()) zone = QTimeZone::systemTimeZone();
+
+    UtcOffsetTable table;
+    table.offsets = {zone.offsetFromUtc(QDateTime::fromSecsSinceEpoch(from, Qt::UTC))};
+    if (!zone.hasTransitions()) return table;
+    for (const QTimeZone::OffsetData &transition :
+         zone.transitions(QDateTime::fromSecsSinceEpoch(from, Qt::UTC), QDateTime::fromSecsSinceEpoch(to, Qt::UTC))) {
+        table.transitions.push_back(transition.atUtc.toSecsSinceEpoch());
+        table.offsets.push_back(transition.offsetFromUtc);
+    }
+    return table;
+}
+
+std::map<std::string, UtcOffsetTable> utcOffsetTables(const LocationStore &store, const std::string &parameter) {
+    std::map<std::string, std::pair<std::int64_t, std::int64_t>> ranges;
+    for (const auto &[name, frame] : store.frames()) {
+        if (frame.time.empty() || !frame.columns.count(parameter)) continue;
+        auto [it, inserted] = ranges.try_emplace(frame.timezone, frame.time.front(), frame.time.back());
+        it->second.first = std::min(it->second.first, frame.time.front());
+        it->second.second = std::max(it->second.second, frame.time.back());
+    }
+    std::map<std::string, UtcOffsetTable> zones;
+    for (const auto &[timezone, range] : ranges)
+        zones[timezone] = utcOffsetTable(timezone, range.first, range.second);
+    return zones;
+}
+
+std::vector<std::int64_t> localTimes(const std::vector<std::int64_t> &time, size_t rows, const UtcOffsetTable &zone) {
+    rows = std::min(rows, time.size());
+    std::vector<std::int64_t> local(rows);
+    size_t segment = std::upper_bound(zone.transitions.begin(), zone.transitions.end(),
+                                      rows ? time.front() : 0) - zone.transitions.begin();
+    for (size_t begin = 0; begin < rows;) {
+        size_t end = rows;
+        if (segment < zone.transitions.size())
+            end = std::lower_bound(time.begin() + begin, time.begin() + rows, zone.transitions[segment]) - time.begin();
+        const std::int64_t offset = zone.offsets[std::min(segment, zone.offsets.size() - 1)];
+        for (size_t i = begin; i < end; ++i) local[i] = time[i] + offset;
+        begin = end;
+        ++segment;
+    }
+    return local;
+}
+
+int profileBuckets(ProfileKind kind) {
+    return kind == ProfileKind::HourOfDay ? 24 : 7;
+}
+
+std::vector<ProfileBucket> computeProfile(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                          const UtcOffsetTable &zone, ProfileKind kind) {
+    const size_t rows = std::min(time.size(), values.size());
+    const int buckets = profileBuckets(kind);
+
+    // Indeks przedziału dla każdego wiersza
+    const std::vector<std::int64_t> local = localTimes(time, rows, zone);
+    std::vector<std::uint8_t> bucket(rows);
+    if (kind == ProfileKind::HourOfDay) {
+        for (size_t i = 0; i < rows; ++i) {
+            const std::int64_t seconds = (local[i] % 86400 + 86400) % 86400;
+            bucket[i] = static_cast<std::uint8_t>(seconds / 3600);
+        }
+    } else {
+        // 1970-01-01 był czwartkiem: (dni + 3) mod 7 daje 0 dla poniedziałku
+        for (size_t i = 0; i < rows; ++i) {
+            const std::int64_t days = (local[i] >= 0 ? local[i] : local[i] - 86399) / 86400;
+            bucket[i] = static_cast<std::uint8_t>(((days + 3) % 7 + 7) % 7);
+        }
+    }
+
+    // Sortowanie przez zliczanie: wartości każdego przedziału w ciągłym fragmencie jednej tablicy
+    std::vector<size_t> start(buckets + 1, 0);
+    for (size_t i = 0; i < rows; ++i)
+        if (!std::isnan(values[i])) ++start[bucket[i] + 1];
+    for (int b = 0; b < buckets; ++b) start[b + 1] += start[b];
+
+    std::vector<double> grouped(start[buckets]);
+    std::vector<size_t> cursor(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < rows; ++i)
+        if (!std::isnan(values[i])) grouped[cursor[bucket[i]]++] = values[i];
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<ProfileBucket> profile(buckets);
+    for (int b = 0; b < buckets; ++b) {
+        double *first = grouped.data() + start[b];
+        const size_t count = start[b + 1] - start[b];
+        if (count == 0) {
+            profile[b] = {nan, nan, nan, nan, nan, nan, 0};
+            continue;
+        }
+        std::sort(first, first + count);
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) sum += first[i];
+        profile[b] = {sum / count, percentile(first, count, 0.10), percentile(first, count, 0.25),
+                      percentile(first, count, 0.50), percentile(first, count, 0.75),
+                      percentile(first, count, 0.90), count};
+    }
+    return profile;
+}
@@ -0,0 +1,60 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Tabela przejść przesunięcia UTC strefy czasowej (zmiany czasu letniego i zimowego)
+ * \details offsets[0] obowiązuje przed transitions[0], a offsets[i + 1] od chwili transitions[i]
+ * (sekundy UTC). Pusta tabela przejść oznacza stałe przesunięcie offsets[0].
+ */
+struct UtcOffsetTable {
+    std::vector<std::int64_t> transitions;
+    std::vector<std::int32_t> offsets{0};
+
+    std::int32_t offsetAt(std::int64_t time) const;
+};
+
+// Tabela przejść strefy IANA (pusta nazwa lub nieznana strefa - strefa systemowa) dla zakresu [from, to]
+UtcOffsetTable utcOffsetTable(const std::string &timezone, std::int64_t from, std::int64_t to);
+
+// Tabele przejść stref wszystkich lokalizacji magazynu z kolumną parameter, po jednej na strefę,
+// dla łącznego zakresu czasu tych lokalizacji (klucz - nazwa strefy serii)
+std::map<std::string, UtcOffsetTable> utcOffsetTables(const LocationStore &store, const std::string &parameter);
+
+// Czas lokalny pierwszych rows wierszy posortowanej osi UTC; przesunięcie wyznaczane jest odcinkami
+// między przejściami tabeli, więc w obrębie odcinka przeliczenie to prosta pętla bez wyszukiwania
+std::vector<std::int64_t> localTimes(const std::vector<std::int64_t> &time, size_t rows, const UtcOffsetTable &zone);
+
+enum class ProfileKind { HourOfDay, DayOfWeek };
+
+// Statystyki jednego przedziału profilu (godziny doby lub dnia tygodnia, poniedziałek = 0)
+struct ProfileBucket {
+    double mean;
+    double p10;
+    double p25;
+    double median;
+    double p75;
+    double p90;
+    size_t samples;
+};
+
+/*!
+ * \brief Profil cykliczny serii: średnia i percentyle dla każdej godziny doby lub dnia tygodnia
+ * \details Znaczniki UTC zamieniane są na czas lokalny (localTimes), a wartości rozdzielane są
+ * do przedziałów sortowaniem przez zliczanie w jedną tablicę. Percentyle liczone są z interpolacją
+ * liniową; brak pomiaru (NaN) jest pomijany, a pusty przedział ma wartości NaN.
+ */
+std::vector<ProfileBucket> computeProfile(const std::vector<std::int64_t> &time, const std::vector<double> &values,
+                                          const UtcOffsetTable &zone, ProfileKind kind);
+
+// Liczba przedziałów profilu danego rodzaju (24 lub 7)
+int profileBuckets(ProfileKind kind);
+
+#endif // PROFILE_H
@@ -0,0 +1,193 @@
+#include "profilewindow.h"
+
+#include <QComboBox>
+#include <QElapsedTimer>
+#include <QFormLayout>
+#include <QLabel>
+#include <QSignalBlocker>
+#include <QVBoxLayout>
+#include <QtCharts/QAreaSeries>
+#include <QtCharts/QCategoryAxis>
+#include <QtCharts/QChartView>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QValueAxis>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include "pollutants.h"
+
+namespace {
+
+// Pasmo między dwoma percentylami (puste przedziały pomijane)
+QAreaSeries *percentileBand(const std::vector<ProfileBucket> &profile, double ProfileBucket::*lower,
+                            double ProfileBucket::*upper, const QColor &color) {
+    QLineSeries *low = new QLineSeries();
+    QLineSeries *high = new QLineSeries();
+    for (size_t b = 0; b < profile.size(); ++b) {
+        if (profile[b].samples == 0) continue;
+        low->append(b, profile[b].*lower);
+        high->append(b, profile[b].*upper);
+    }
+    QAreaSeries *band = new QAreaSeries(high, low);
+    band->setColor(color);
+    band->setBorderColor(Qt::transparent);
+    return band;
+}
+
+// Wykres profilu: pasma percentyli 10-90 i 25-75, mediana (linia przerywana) i średnia
+QChart *createProfileChart(const std::vector<ProfileBucket> &profile, ProfileKind kind, const QString &title,
+                           const QColor &color) {
+    QChart *chart = new QChart();
+    chart->setTitle(title);
+
+    QColor outer = color, inner = color;
+    outer.setAlpha(50);
+    inner.setAlpha(110);
+    QAreaSeries *wide = percentileBand(profile, &ProfileBucket::p10, &ProfileBucket::p90, outer);
+    wide->setName("percentyle 10-90");
+    QAreaSeries *narrow = percentileBand(profile, &ProfileBucket::p25, &ProfileBucket::p75, inner);
+    narrow->setName("percentyle 25-75");
+
+    QLineSeries *median = new QLineSeries();
+    median->setName("mediana");
+    median->setPen(QPen(color, 2, Qt::DashLine));
+    QLineSeries *mean = new QLineSeries();
+    mean->setName("średnia");
+    mean->setPen(QPen(color.darker(150), 2));
+    double top = 0.0;
+    for (size_t b = 0; b < profile.size(); ++b) {
+        if (profile[b].samples == 0) continue;
+        median->append(b, profile[b].median);
+        mean->append(b, profile[b].mean);
+        top = std::max({top, profile[b].p90, profile[b].mean});
+    }
+
+    for (QAbstractSeries *series : std::initializer_list<QAbstractSeries *>{wide, narrow, median, mean})
+        chart->addSeries(series);
+
+    QCategoryAxis *axisX = new QCategoryAxis();
+    axisX->setLabelsPosition(QCategoryAxis::AxisLabelsPositionOnValue);
+    const int buckets = profileBuckets(kind);
+    static const char *const weekdays[] = {"Pn", "Wt", "Śr", "Cz", "Pt", "So", "Nd"};
+    for (int b = 0; b < buckets; ++b)
+        axisX->append(kind == ProfileKind::HourOfDay ? QString("%1:00").arg(b) : QString::fromUtf8(weekdays[b]), b);
+    axisX->setRange(-0.5, buckets - 0.5);
+    axisX->setTitleText(kind == ProfileKind::HourOfDay ? "Godzina (czas lokalny)" : "Dzień tygodnia");
+    chart->addAxis(axisX, Qt::AlignBottom);
+
+    QValueAxis *axisY = new QValueAxis();
+    axisY->setRange(0, top > 0 ? top * 1.1 : 1.0);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    for (QAbstractSeries *series : chart->series()) {
+        series->attachAxis(axisX);
+        series->attachAxis(axisY);
+    }
+    return chart;
+}
+
+} // namespace
+
+ProfileWindow::ProfileWindow(const LocationStore &store, QWidget *parent) : QWidget(parent, Qt::Window),
+    store(store) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    parameterSelector->setCurrentIndex(parameterSelector->findData("nitrogen_dioxide"));
+    form->addRow("Parametr:", parameterSelector);
+    locationSelector = new QComboBox();
+    locationSelector->setMinimumContentsLength(30);
+    form->addRow("Lokalizacja:", locationSelector);
+    layout->addLayout(form);
+
+    summary = new QLabel();
+    layout->addWidget(summary);
+    hourlyView = new QChartView();
+    hourlyView->setRenderHint(QPainter::Antialiasing);
+    hourlyView->setMinimumHeight(300);
+    layout->addWidget(hourlyView, 1);
+    weeklyView = new QChartView();
+    weeklyView->setRenderHint(QPainter::Antialiasing);
+    weeklyView->setMinimumHeight(300);
+    layout->addWidget(weeklyView, 1);
+
+    connect(parameterSelector, &QComboBox::currentIndexChanged, this, [this]() { recompute(locationSelector->currentText()); });
+    connect(locationSelector, &QComboBox::currentIndexChanged, this, &ProfileWindow::showSelected);
+
+    setWindowTitle("Profile dobowe i tygodniowe");
+    resize(900, 800);
+}
+
+void ProfileWindow::recompute(const QString &location) {
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+
+    struct Task {
+        const AirQualityFrame *frame;
+        const UtcOffsetTable *zone;
+        LocationProfiles result;
+    };
+
+    // Tabele przejść budowane w wątku głównym, po jednej na strefę
+    std::map<std::string, UtcOffsetTable> zones = utcOffsetTables(store, parameter);
+
+    std::vector<Task> tasks;
+    for (const auto &[name, frame] : store.frames())
+        if (!frame.time.empty() && frame.columns.count(parameter))
+            tasks.push_back({&frame, &zones[frame.timezone], {}});
+
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(tasks, [&parameter](Task &task) {
+        const std::vector<double> &values = task.frame->columns.at(parameter);
+        task.result.hourly = computeProfile(task.frame->time, values, *task.zone, ProfileKind::HourOfDay);
+        task.result.weekly = computeProfile(task.frame->time, values, *task.zone, ProfileKind::DayOfWeek);
+    });
+
+    profiles.clear();
+    for (Task &task : tasks)
+        profiles.insert(QString::fromStdString(task.frame->location), std::move(task.result));
+    summary->setText(QString("Profile obliczone dla %1 lokalizacji w %2 ms").arg(tasks.size()).arg(timer.elapsed()));
+
+    QStringList names = profiles.keys();
+    names.sort();
+    {
+        QSignalBlocker blocker(locationSelector);
+        locationSelector->clear();
+        locationSelector->addItems(names);
+        const int index = locationSelector->findText(location);
+        locationSelector->setCurrentIndex(index >= 0 ? index : 0);
+    }
+    showSelected();
+}
+
+void ProfileWindow::showSelected() {
+    QChart *hourly = nullptr;
+    QChart *weekly = nullptr;
+    auto it = profiles.constFind(locationSelector->currentText());
+    if (it == profiles.constEnd()) {
+        hourly = new QChart();
+        weekly = new QChart();
+    } else {
+        const Pollutant *pollutant = findPollutant(parameterSelector->currentData().toString().toStdString());
+        const QColor color = pollutant ? QColor::fromRgb(pollutant->color) : QColor(Qt::darkBlue);
+        QString title = parameterSelector->currentText();
+        if (pollutant && *pollutant->unit) title += QString(" [%1]").arg(QString::fromUtf8(pollutant->unit));
+        hourly = createProfileChart(it->hourly, ProfileKind::HourOfDay, title + " - profil dobowy", color);
+        weekly = createProfileChart(it->weekly, ProfileKind::DayOfWeek, title + " - profil tygodniowy", color);
+    }
+
+    // setChart nie usuwa poprzedniego wykresu (także pustego)
+    QChart *previousHourly = hourlyView->chart();
+    QChart *previousWeekly = weeklyView->chart();
+    hourlyView->setChart(hourly);
+    weeklyView->setChart(weekly);
+    delete previousHourly;
+    delete previousWeekly;
+}
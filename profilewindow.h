@@ -0,0 +1,51 @@
+#ifndef PROFILEWINDOW_H
+#define PROFILEWINDOW_H
+
+#include <QHash>
+#include <QWidget>
+
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+#include "profile.h"
+
+class QChartView;
+class QComboBox;
+class QLabel;
+
+/*!
+ * \brief Okno profili dobowych i tygodniowych wybranego parametru
+ * \details Profile liczone są w czasie lokalnym lokalizacji (z uwzględnieniem zmian czasu) dla
+ * wszystkich lokalizacji magazynu naraz, równolegle; tabele przejść stref czasowych budowane są
+ * wcześniej, po jednej na strefę. Wykres profilu pokazuje średnią, medianę oraz pasma percentyli
+ * 25-75 i 10-90 dla każdej godziny doby lub dnia tygodnia.
+ */
+class ProfileWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ProfileWindow(const LocationStore &store, QWidget *parent = nullptr);
+
+    // Ponowne obliczenie profili po zmianie magazynu; location - lokalizacja wybrana na starcie
+    void recompute(const QString &location = QString());
+
+private slots:
+    void showSelected();
+
+private:
+    struct LocationProfiles {
+        std::vector<ProfileBucket> hourly;
+        std::vector<ProfileBucket> weekly;
+    };
+
+    const LocationStore &store;
+    QComboBox *parameterSelector;
+    QComboBox *locationSelector;
+    QLabel *summary;
+    QChartView *hourlyView;
+    QChartView *weeklyView;
+    QHash<QString, LocationProfiles> profiles;
+};
+
+#endif // PROFILEWINDOW_H
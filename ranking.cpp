@@ -0,0 +1,156 @@
+#include "ranking.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <queue>
+
+#include "pollutants.h"
+
+namespace {
+
+const std::int64_t MeanWindow = 24 * 3600;
+const size_t Metrics = 2;
+
+} // namespace
+
+void IndexedHeap::set(size_t id, double score) {
+    if (std::isnan(score)) {
+        erase(id);
+        return;
+    }
+    if (id >= position.size()) {
+        position.resize(id + 1, Absent);
+        scores.resize(id + 1, 0.0);
+    }
+    if (position[id] == Absent) {
+        position[id] = heap.size();
+        heap.push_back(id);
+        scores[id] = score;
+        siftUp(position[id]);
+        return;
+    }
+    const double previous = scores[id];
+    scores[id] = score;
+    if (score > previous) siftUp(position[id]);
+    else if (score < previous) siftDown(position[id]);
+}
+
+void IndexedHeap::erase(size_t id) {
+    if (!contains(id)) return;
+    const size_t node = position[id];
+    swapNodes(node, heap.size() - 1);
+    heap.pop_back();
+    position[id] = Absent;
+    if (node < heap.size()) {
+        siftUp(node);
+        siftDown(node);
+    }
+}
+
+std::vector<std::pair<size_t, double>> IndexedHeap::top(size_t k) const {
+    std::vector<std::pair<size_t, double>> result;
+    if (heap.empty()) return result;
+
+    // Kandydaci to dzieci już wybranych węzłów; kolejka nie przekracza k + 1 elementów
+    auto lower = [this](size_t a, size_t b) { return scores[heap[a]] < scores[heap[b]]; };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(lower)> candidates(lower);
+    candidates.push(0);
+    while (!candidates.empty() && result.size() < k) {
+        const size_t node = candidates.top();
+        candidates.pop();
+        result.emplace_back(heap[node], scores[heap[node]]);
+        for (size_t child = 2 * node + 1; child <= 2 * node + 2 && child < heap.size(); ++child)
+            candidates.push(child);
+    }
+    return result;
+}
+
+void IndexedHeap::swapNodes(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    position[heap[a]] = a;
+    position[heap[b]] = b;
+}
+
+void IndexedHeap::siftUp(size_t node) {
+    while (node > 0) {
+        const size_t parent = (node - 1) / 2;
+        if (scores[heap[parent]] >= scores[heap[node]]) break;
+        swapNodes(node, parent);
+        node = parent;
+    }
+}
+
+void IndexedHeap::siftDown(size_t node) {
+    for (;;) {
+        size_t largest = node;
+        for (size_t child = 2 * node + 1; child <= 2 * node + 2 && child < heap.size(); ++child)
+            if (scores[heap[child]] > scores[heap[largest]]) largest = child;
+        if (largest == node) break;
+        swapNodes(node, largest);
+        node = largest;
+    }
+}
+
+LocationRanking::LocationRanking() : heaps(std::size(pollutants) * Metrics) {}
+
+void LocationRanking::update(const std::string &location, const AirQualityFrame &frame, std::int64_t now) {
+    auto [it, inserted] = ids.try_emplace(location, 0);
+    if (inserted) {
+        if (freeIds.empty()) {
+            it->second = names.size();
+            names.push_back(location);
+        } else {
+            it->second = freeIds.back();
+            freeIds.pop_back();
+            names[it->second] = location;
+        }
+    }
+    const size_t id = it->second;
+
+    // Wiersze od początku okna 24 h do chwili now; ostatni pomiar nie starszy niż okno
+    const size_t end = std::upper_bound(frame.time.begin(), frame.time.end(), now) - frame.time.begin();
+    const size_t begin = std::upper_bound(frame.time.begin(), frame.time.begin() + end, now - MeanWindow) - frame.time.begin();
+    for (size_t p = 0; p < std::size(pollutants); ++p) {
+        double latest = std::numeric_limits<double>::quiet_NaN();
+        double mean = std::numeric_limits<double>::quiet_NaN();
+        auto column = frame.columns.find(std::string(pollutants[p].apiName));
+        if (column != frame.columns.end()) {
+            const std::vector<double> &values = column->second;
+            double sum = 0.0;
+            size_t count = 0;
+            for (size_t i = begin; i < end && i < values.size(); ++i) {
+                if (std::isnan(values[i])) continue;
+                latest = values[i];
+                sum += values[i];
+                ++count;
+            }
+            if (count) mean = sum / count;
+        }
+        heaps[p * Metrics + static_cast<size_t>(RankingMetric::Latest)].set(id, latest);
+        heaps[p * Metrics + static_cast<size_t>(RankingMetric::Mean24h)].set(id, mean);
+    }
+}
+
+void LocationRanking::remove(const std::string &location) {
+    auto it = ids.find(location);
+    if (it == ids.end()) return;
+    for (IndexedHeap &heap : heaps) heap.erase(it->second);
+    freeIds.push_back(it->second);
+    ids.erase(it);
+}
+
+const IndexedHeap *LocationRanking::heapFor(const std::string &parameter, RankingMetric metric) const {
+    for (size_t p = 0; p < std::size(pollutants); ++p)
+        if (pollutants[p].apiName == parameter) return &heaps[p * Metrics + static_cast<size_t>(metric)];
+    return nullptr;
+}
+
+std::vector<RankingEntry> LocationRanking::top(const std::string &parameter, RankingMetric metric, size_t count) const {
+    std::vector<RankingEntry> entries;
+    const IndexedHeap *heap = heapFor(parameter, metric);
+    if (!heap) return entries;
+    for (const auto &[id, value] : heap->top(count)) entries.push_back({names[id], value});
+    return entries;
+}
@@ -0,0 +1,78 @@
+#ifndef RANKING_H
+#define RANKING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Kopiec maksymalny z indeksem pozycji elementów
+ * \details Elementy identyfikowane są liczbami 0..n-1; tablica pozycji pozwala zmienić wynik
+ * lub usunąć dowolny element w O(log n) bez przebudowy kopca. top(k) przegląda kopiec od
+ * korzenia pomocniczą kolejką kandydatów, więc kosztuje O(k log k) niezależnie od rozmiaru kopca.
+ */
+class IndexedHeap {
+public:
+    // Wstawienie lub zmiana wyniku; NaN usuwa element
+    void set(size_t id, double score);
+    void erase(size_t id);
+
+    bool contains(size_t id) const { return id < position.size() && position[id] != Absent; }
+    double score(size_t id) const { return scores[id]; }
+    size_t size() const { return heap.size(); }
+
+    // k elementów o najwyższym wyniku, malejąco: pary (identyfikator, wynik)
+    std::vector<std::pair<size_t, double>> top(size_t k) const;
+
+private:
+    static constexpr size_t Absent = static_cast<size_t>(-1);
+
+    void swapNodes(size_t a, size_t b);
+    void siftUp(size_t node);
+    void siftDown(size_t node);
+
+    std::vector<size_t> heap;       // identyfikatory w porządku kopca
+    std::vector<size_t> position;   // pozycja identyfikatora w heap lub Absent
+    std::vector<double> scores;
+};
+
+enum class RankingMetric { Latest, Mean24h };
+
+// Pozycja rankingu
+struct RankingEntry {
+    std::string location;
+    double value;
+};
+
+/*!
+ * \brief Ranking lokalizacji według bieżącej wartości i średniej z ostatnich 24 godzin
+ * \details Dla każdego parametru z tabeli pollutants i każdej miary utrzymywany jest osobny kopiec
+ * indeksowany; aktualizacja jednej lokalizacji zmienia tylko jej pozycje w kopcach (O(log n)),
+ * bez ponownego sortowania pozostałych.
+ */
+class LocationRanking {
+public:
+    LocationRanking();
+
+    // Przeliczenie wartości lokalizacji z serii dla chwili now (pomiary późniejsze, np. prognoza, są pomijane)
+    void update(const std::string &location, const AirQualityFrame &frame, std::int64_t now);
+    void remove(const std::string &location);
+
+    std::vector<RankingEntry> top(const std::string &parameter, RankingMetric metric, size_t count) const;
+    size_t locations() const { return ids.size(); }
+
+private:
+    const IndexedHeap *heapFor(const std::string &parameter, RankingMetric metric) const;
+
+    std::unordered_map<std::string, size_t> ids;
+    std::vector<std::string> names;
+    std::vector<size_t> freeIds;
+    std::vector<IndexedHeap> heaps;     // [parametr * 2 + miara]
+};
+
+#endif // RANKING_H
@@ -0,0 +1,71 @@
+#include "rankingwindow.h"
+
+#include <QComboBox>
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QTableWidget>
+#include <QVBoxLayout>
+
+#include <cmath>
+
+#include "pollutants.h"
+
+RankingWindow::RankingWindow(const LocationRanking &ranking, QWidget *parent) : QWidget(parent, Qt::Window),
+    ranking(ranking) {
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    QFormLayout *form = new QFormLayout();
+    parameterSelector = new QComboBox();
+    for (const Pollutant &pollutant : pollutants)
+        parameterSelector->addItem(QString::fromUtf8(pollutant.displayName),
+                                   QString::fromLatin1(pollutant.apiName.data(), static_cast<qsizetype>(pollutant.apiName.size())));
+    parameterSelector->setCurrentIndex(parameterSelector->findData("pm2_5"));
+    form->addRow("Parametr:", parameterSelector);
+    metricSelector = new QComboBox();
+    metricSelector->addItem("Ostatni pomiar", static_cast<int>(RankingMetric::Latest));
+    metricSelector->addItem("Średnia z 24 h", static_cast<int>(RankingMetric::Mean24h));
+    form->addRow("Miara:", metricSelector);
+    layout->addLayout(form);
+
+    summary = new QLabel();
+    layout->addWidget(summary);
+    table = new QTableWidget(0, 3);
+    table->setHorizontalHeaderLabels({"#", "Lokalizacja", "Wartość"});
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    layout->addWidget(table, 1);
+
+    connect(parameterSelector, &QComboBox::currentIndexChanged, this, &RankingWindow::refresh);
+    connect(metricSelector, &QComboBox::currentIndexChanged, this, &RankingWindow::refresh);
+    connect(table, &QTableWidget::cellActivated, this, [this](int row) {
+        if (QTableWidgetItem *item = table->item(row, 1)) emit locationActivated(item->text());
+    });
+
+    setWindowTitle("Najgorsze lokalizacje");
+    resize(500, 600);
+}
+
+void RankingWindow::refresh() {
+    const std::string parameter = parameterSelector->currentData().toString().toStdString();
+    const auto metric = static_cast<RankingMetric>(metricSelector->currentData().toInt());
+    const std::vector<RankingEntry> entries = ranking.top(parameter, metric, static_cast<size_t>(topCount));
+
+    const Pollutant *pollutant = findPollutant(parameter);
+    const QString unit = pollutant && *pollutant->unit ? " " + QString::fromUtf8(pollutant->unit) : QString();
+    table->setRowCount(static_cast<int>(entries.size()));
+    for (int row = 0; row < static_cast<int>(entries.size()); ++row) {
+        const RankingEntry &entry = entries[static_cast<size_t>(row)];
+        table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
+        table->setItem(row, 1, new QTableWidgetItem(QString::fromStdString(entry.location)));
+        QTableWidgetItem *value = new QTableWidgetItem(QString::number(entry.value, 'f', 1) + unit);
+        value->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        if (pollutant && !std::isnan(pollutant->whoGuideline) && entry.value > pollutant->whoGuideline)
+            value->setForeground(Qt::red);
+        table->setItem(row, 2, value);
+    }
+    table->resizeColumnToContents(0);
+    summary->setText(QString("Lokalizacje w rankingu: %1 (dwuklik otwiera wykresy)").arg(ranking.locations()));
+}
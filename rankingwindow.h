@@ -0,0 +1,39 @@
+#ifndef RANKINGWINDOW_H
+#define RANKINGWINDOW_H
+
+#include <QWidget>
+
+#include "ranking.h"
+
+class QComboBox;
+class QLabel;
+class QTableWidget;
+
+/*!
+ * \brief Okno najgorszych lokalizacji: pierwsze pozycje rankingu wybranego parametru
+ * \details Lista pobierana jest z kopców rankingu (bez sortowania wszystkich lokalizacji) przy każdej
+ * zmianie wyboru i po każdym cyklu odpytywania. Aktywacja wiersza (dwuklik, Enter) zgłasza lokalizację
+ * sygnałem locationActivated - wykresy otwierane są z lokalnego magazynu.
+ */
+class RankingWindow : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit RankingWindow(const LocationRanking &ranking, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+signals:
+    void locationActivated(const QString &location);
+
+private:
+    const LocationRanking &ranking;
+    QComboBox *parameterSelector;
+    QComboBox *metricSelector;
+    QLabel *summary;
+    QTableWidget *table;
+    const int topCount = 20;
+};
+
+#endif // RANKINGWINDOW_H
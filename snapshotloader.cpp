@@ -0,0 +1,90 @@
+#include "snapshotloader.h"
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrent>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+struct DecodedSnapshot {
+    QString fileName;
+    bool ok = false;
+    AirQualityFrame frame;
+};
+
+struct LocationParts {
+    std::vector<const AirQualityFrame *> parts;
+    AirQualityFrame merged;
+};
+
+DecodedSnapshot decodeSnapshot(const QString &fileName) {
+    DecodedSnapshot snapshot;
+    snapshot.fileName = fileName;
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) return snapshot;
+
+    try {
+        const QByteArray content = file.readAll();
+        std::vector<AirQualityFrame> frames = framesFromJsonText(content.constData(), content.size());
+        if (frames.size() != 1 || frames.front().location.empty()) return snapshot;
+
+        snapshot.frame = std::move(frames.front());
+        snapshot.ok = true;
+    } catch (const std::exception &) {
+        snapshot.ok = false;
+    }
+    return snapshot;
+}
+
+} // namespace
+
+SnapshotLoader::Result SnapshotLoader::loadFiles(const QStringList &fileNames) {
+    Result result;
+
+    // Starsze zapisy najpierw, by przy scalaniu nowsze dane nadpisywały starsze
+    QList<QPair<QDateTime, QString>> ordered;
+    for (const QString &fileName : fileNames)
+        ordered.append({QFileInfo(fileName).lastModified(), fileName});
+    std::stable_sort(ordered.begin(), ordered.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    QStringList sortedNames;
+    for (const auto &item : ordered) sortedNames.append(item.second);
+
+    const QList<DecodedSnapshot> snapshots = QtConcurrent::blockingMapped<QList<DecodedSnapshot>>(sortedNames, decodeSnapshot);
+
+    std::vector<LocationParts> locations;
+    std::unordered_map<std::string, size_t> locationIndex;
+    for (const DecodedSnapshot &snapshot : snapshots) {
+        if (!snapshot.ok) {
+            result.failedFiles.append(snapshot.fileName);
+            continue;
+        }
+        ++result.loadedFiles;
+        auto [it, inserted] = locationIndex.emplace(snapshot.frame.location, locations.size());
+        if (inserted) locations.emplace_back();
+        locations[it->second].parts.push_back(&snapshot.frame);
+    }
+
+    QtConcurrent::blockingMap(locations, [](LocationParts &location) {
+        location.merged = mergeSortedFrames(location.parts);
+    });
+
+    result.frames.reserve(locations.size());
+    for (LocationParts &location : locations)
+        result.frames.push_back(std::move(location.merged));
+    return result;
+}
+
+QStringList SnapshotLoader::snapshotFiles(const QString &directory) {
+    QStringList files;
+    QDirIterator it(directory, {"*.json"}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        files.append(it.next());
+    return files;
+}
@@ -0,0 +1,32 @@
+#ifndef SNAPSHOTLOADER_H
+#define SNAPSHOTLOADER_H
+
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Zbiorcze wczytywanie zapisanych plików air_quality_data.json
+ * \details Pliki dekodowane są równolegle (QtConcurrent::mapped), a serie tej samej lokalizacji
+ * scalane k-drożnie z usunięciem powtórzonych godzin. Pliki porządkowane są według daty
+ * modyfikacji, więc przy nakładających się zakresach pierwszeństwo mają dane z nowszego
+ * zapisu (np. pomiar zamiast wcześniejszej prognozy).
+ */
+class SnapshotLoader {
+public:
+    struct Result {
+        std::vector<AirQualityFrame> frames;
+        int loadedFiles = 0;
+        QStringList failedFiles;
+    };
+
+    static Result loadFiles(const QStringList &fileNames);
+
+    // Wszystkie pliki *.json w katalogu i jego podkatalogach
+    static QStringList snapshotFiles(const QString &directory);
+};
+
+#endif // SNAPSHOTLOADER_H
@@ -0,0 +1,77 @@
+#include "sparkline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Zakres wierszy serii w oknie [from, to]
+std::pair<size_t, size_t> windowRows(const AirQualityFrame &frame, std::int64_t from, std::int64_t to) {
+    const auto begin = std::lower_bound(frame.time.begin(), frame.time.end(), from);
+    const auto end = std::upper_bound(begin, frame.time.end(), to);
+    return {static_cast<size_t>(begin - frame.time.begin()), static_cast<size_t>(end - frame.time.begin())};
+}
+
+const std::uint64_t FnvOffset = 14695981039346656037ull;
+const std::uint64_t FnvPrime = 1099511628211ull;
+
+std::uint64_t fnv(std::uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * FnvPrime;
+    return hash;
+}
+
+} // namespace
+
+SparklineSeries decimateSparkline(const AirQualityFrame &frame, const std::string &param,
+                                  std::int64_t from, std::int64_t to, int columns) {
+    SparklineSeries series;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    series.low.assign(static_cast<size_t>(std::max(columns, 0)), nan);
+    series.high.assign(series.low.size(), nan);
+    series.last = std::numeric_limits<double>::quiet_NaN();
+    auto column = frame.columns.find(param);
+    if (column == frame.columns.end() || columns <= 0 || to <= from) return series;
+
+    const std::vector<double> &values = column->second;
+    const auto [begin, end] = windowRows(frame, from, to);
+    const double scale = static_cast<double>(columns) / static_cast<double>(to - from);
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    for (size_t row = begin; row < end; ++row) {
+        const double value = values[row];
+        if (std::isnan(value)) continue;
+        const size_t x = std::min(static_cast<size_t>((frame.time[row] - from) * scale), series.low.size() - 1);
+        const float v = static_cast<float>(value);
+        // Porównanie z NaN jest fałszywe, więc pierwszy pomiar kolumny zastępuje NaN
+        if (!(v >= series.low[x])) series.low[x] = v;
+        if (!(v <= series.high[x])) series.high[x] = v;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        series.last = value;
+        series.lastTime = frame.time[row];
+        ++series.samples;
+    }
+    if (series.samples) {
+        series.min = min;
+        series.max = max;
+    }
+    return series;
+}
+
+std::uint64_t sparklineHash(const AirQualityFrame &frame, const std::string &param,
+                            std::int64_t from, std::int64_t to, std::uint64_t seed) {
+    std::uint64_t hash = fnv(FnvOffset, &seed, sizeof(seed));
+    hash = fnv(hash, &from, sizeof(from));
+    hash = fnv(hash, &to, sizeof(to));
+    hash = fnv(hash, param.data(), param.size());
+    auto column = frame.columns.find(param);
+    if (column == frame.columns.end()) return hash;
+
+    const auto [begin, end] = windowRows(frame, from, to);
+    const size_t rows = end - begin;
+    hash = fnv(hash, &rows, sizeof(rows));
+    hash = fnv(hash, frame.time.data() + begin, rows * sizeof(std::int64_t));
+    return fnv(hash, column->second.data() + begin, rows * sizeof(double));
+}
@@ -0,0 +1,37 @@
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+
+/*!
+ * \brief Seria zredukowana do szerokości miniatury: minimum i maksimum w każdej kolumnie pikseli
+ * \details Kolumny bez pomiarów mają NaN w low i high. Redukcja min/max zachowuje szczyty, które
+ * zwykłe próbkowanie co n-ty punkt by pominęło, a rysowanie kosztuje O(szerokość), nie O(liczba pomiarów).
+ */
+struct SparklineSeries {
+    std::vector<float> low;
+    std::vector<float> high;
+    double min = 0.0;           // zakres wartości wszystkich kolumn (0, 0 bez pomiarów)
+    double max = 0.0;
+    double last = 0.0;          // ostatni pomiar w oknie (NaN bez pomiarów)
+    std::int64_t lastTime = 0;
+    size_t samples = 0;
+
+    bool empty() const { return samples == 0; }
+};
+
+// Redukcja kolumny param serii do columns kolumn dla okna czasu [from, to]
+SparklineSeries decimateSparkline(const AirQualityFrame &frame, const std::string &param,
+                                  std::int64_t from, std::int64_t to, int columns);
+
+// Skrót (FNV-1a) pomiarów kolumny param w oknie [from, to] razem z parametrami okna i seed (np. rozmiar
+// miniatury); ta sama wartość oznacza identyczny obraz, więc miniatura może zostać wzięta z pamięci podręcznej
+std::uint64_t sparklineHash(const AirQualityFrame &frame, const std::string &param,
+                            std::int64_t from, std::int64_t to, std::uint64_t seed);
+
+#endif // SPARKLINE_H
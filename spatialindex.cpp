@@ -0,0 +1,144 @@
+#include "spatialindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+namespace {
+
+const double EarthRadiusKm = 6371.0088;
+const double DegToRad = 3.14159265358979323846 / 180.0;
+
+void toUnitVector(const GeoPoint &point, double *xyz) {
+    const double lat = point.latitude * DegToRad;
+    const double lon = point.longitude * DegToRad;
+    xyz[0] = std::cos(lat) * std::cos(lon);
+    xyz[1] = std::cos(lat) * std::sin(lon);
+    xyz[2] = std::sin(lat);
+}
+
+double squaredChord(const double *a, const double *b) {
+    const double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Cięciwa na sferze jednostkowej -> odległość po kole wielkim w km
+double chordToKm(double squared) {
+    const double chord = std::min(2.0, std::sqrt(squared));
+    return 2.0 * EarthRadiusKm * std::asin(chord / 2.0);
+}
+
+double kmToSquaredChord(double km) {
+    const double angle = std::min(km / EarthRadiusKm, 3.14159265358979323846);
+    const double chord = 2.0 * std::sin(angle / 2.0);
+    return chord * chord;
+}
+
+} // namespace
+
+double distanceKm(const GeoPoint &a, const GeoPoint &b) {
+    double pa[3], pb[3];
+    toUnitVector(a, pa);
+    toUnitVector(b, pb);
+    return chordToKm(squaredChord(pa, pb));
+}
+
+void KdTree::build(const std::vector<GeoPoint> &points) {
+    nodes.resize(points.size());
+    axes.assign(points.size(), 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        toUnitVector(points[i], nodes[i].xyz);
+        nodes[i].index = i;
+    }
+    buildRange(0, nodes.size(), 0);
+}
+
+void KdTree::buildRange(size_t begin, size_t end, int depth) {
+    if (end - begin <= 1) {
+        if (begin < end) axes[begin] = depth % 3;
+        return;
+    }
+
+    // Oś podziału: największy rozrzut współrzędnych w przedziale
+    double low[3] = {2, 2, 2}, high[3] = {-2, -2, -2};
+    for (size_t i = begin; i < end; ++i)
+        for (int a = 0; a < 3; ++a) {
+            low[a] = std::min(low[a], nodes[i].xyz[a]);
+            high[a] = std::max(high[a], nodes[i].xyz[a]);
+        }
+    int axis = 0;
+    for (int a = 1; a < 3; ++a)
+        if (high[a] - low[a] > high[axis] - low[axis]) axis = a;
+
+    const size_t middle = begin + (end - begin) / 2;
+    std::nth_element(nodes.begin() + begin, nodes.begin() + middle, nodes.begin() + end,
+                     [axis](const Node &a, const Node &b) { return a.xyz[axis] < b.xyz[axis]; });
+    axes[middle] = axis;
+    buildRange(begin, middle, depth + 1);
+    buildRange(middle + 1, end, depth + 1);
+}
+
+std::vector<std::pair<size_t, double>> KdTree::nearest(const GeoPoint &query, size_t count) const {
+    std::vector<std::pair<size_t, double>> result;
+    if (nodes.empty() || count == 0) return result;
+
+    double q[3];
+    toUnitVector(query, q);
+
+    // Kopiec maksymalny k najlepszych kandydatów (kwadrat cięciwy, pozycja węzła)
+    std::priority_queue<std::pair<double, size_t>> best;
+    auto search = [&](auto &&self, size_t begin, size_t end) -> void {
+        if (begin >= end) return;
+        const size_t middle = begin + (end - begin) / 2;
+        const Node &node = nodes[middle];
+        const double d = squaredChord(q, node.xyz);
+        if (best.size() < count) best.emplace(d, middle);
+        else if (d < best.top().first) {
+            best.pop();
+            best.emplace(d, middle);
+        }
+
+        const double diff = q[axes[middle]] - node.xyz[axes[middle]];
+        const bool leftFirst = diff < 0;
+        if (leftFirst) self(self, begin, middle);
+        else self(self, middle + 1, end);
+        if (best.size() < count || diff * diff < best.top().first) {
+            if (leftFirst) self(self, middle + 1, end);
+            else self(self, begin, middle);
+        }
+    };
+    search(search, 0, nodes.size());
+
+    result.reserve(best.size());
+    while (!best.empty()) {
+        result.emplace_back(nodes[best.top().second].index, chordToKm(best.top().first));
+        best.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+std::vector<std::pair<size_t, double>> KdTree::withinRadius(const GeoPoint &query, double radiusKm) const {
+    std::vector<std::pair<size_t, double>> result;
+    if (nodes.empty() || radiusKm < 0) return result;
+
+    double q[3];
+    toUnitVector(query, q);
+    const double limit = kmToSquaredChord(radiusKm);
+
+    auto search = [&](auto &&self, size_t begin, size_t end) -> void {
+        if (begin >= end) return;
+        const size_t middle = begin + (end - begin) / 2;
+        const Node &node = nodes[middle];
+        const double d = squaredChord(q, node.xyz);
+        if (d <= limit) result.emplace_back(node.index, chordToKm(d));
+
+        const double diff = q[axes[middle]] - node.xyz[axes[middle]];
+        if (diff < 0 || diff * diff <= limit) self(self, begin, middle);
+        if (diff >= 0 || diff * diff <= limit) self(self, middle + 1, end);
+    };
+    search(search, 0, nodes.size());
+
+    std::sort(result.begin(), result.end(), [](const auto &a, const auto &b) { return a.second < b.second; });
+    return result;
+}
@@ -0,0 +1,48 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+struct GeoPoint {
+    double latitude;
+    double longitude;
+};
+
+// Odległość po kole wielkim w kilometrach
+double distanceKm(const GeoPoint &a, const GeoPoint &b);
+
+/*!
+ * \brief Drzewo k-d lokalizacji do wyszukiwania najbliższych punktów bez dostępu do sieci
+ * \details Punkty przechowywane są jako wektory jednostkowe na sferze (x, y, z), więc odległość
+ * euklidesowa w drzewie jest monotoniczna względem odległości po kole wielkim i nie ma problemów
+ * z południkiem 180° ani z biegunami. Drzewo budowane jest w miejscu (nth_element) w O(n log n),
+ * zapytania o k najbliższych oraz o punkty w promieniu działają w czasie logarytmicznym
+ * względem liczby punktów (plus rozmiar wyniku).
+ */
+class KdTree {
+public:
+    // Indeksy w wynikach odpowiadają kolejności punktów przekazanych do build()
+    void build(const std::vector<GeoPoint> &points);
+
+    std::vector<std::pair<size_t, double>> nearest(const GeoPoint &query, size_t count) const;
+    std::vector<std::pair<size_t, double>> withinRadius(const GeoPoint &query, double radiusKm) const;
+
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+
+private:
+    struct Node {
+        double xyz[3];
+        size_t index;
+    };
+
+    void buildRange(size_t begin, size_t end, int depth);
+
+    // Węzły w układzie niejawnym: korzeń poddrzewa [begin, end) leży w środku przedziału
+    std::vector<Node> nodes;
+    std::vector<int> axes;
+};
+
+#endif // SPATIALINDEX_H
@@ -0,0 +1,87 @@
+#include "stationmap.h"
+
+#include <QDir>
+#include <QQmlContext>
+#include <QQuickWidget>
+#include <QUrl>
+#include <QVBoxLayout>
+
+#include <algorithm>
+
+void ClusterModel::setStations(const QList<StationMarker> &newStations) {
+    stations = newStations;
+
+    std::vector<GeoPoint> points;
+    std::vector<int> levels;
+    points.reserve(stations.size());
+    levels.reserve(stations.size());
+    for (const StationMarker &station : stations) {
+        points.push_back(station.position);
+        levels.push_back(station.level);
+    }
+    tree.build(points, levels);
+
+    if (lastView[0] >= 0.0) {
+        const double zoom = lastView[0];
+        lastView[0] = -1.0;
+        update(zoom, lastView[1], lastView[2], lastView[3], lastView[4]);
+    }
+}
+
+void ClusterModel::update(double zoom, double north, double west, double south, double east) {
+    const double view[5] = {zoom, north, west, south, east};
+    if (std::equal(view, view + 5, lastView)) return;
+    std::copy(view, view + 5, lastView);
+
+    beginResetModel();
+    visible = tree.clusters(zoom, north, west, south, east);
+    endResetModel();
+}
+
+int ClusterModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(visible.size());
+}
+
+QVariant ClusterModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(visible.size())) return QVariant();
+
+    const MarkerCluster &cluster = visible[index.row()];
+    switch (role) {
+    case LatitudeRole: return cluster.latitude;
+    case LongitudeRole: return cluster.longitude;
+    case CountRole: return static_cast<int>(cluster.count);
+    case LevelRole: return cluster.level;
+    case LabelRole:
+        return cluster.count == 1 ? stations[static_cast<int>(cluster.index)].label
+                                  : QString("%1 lokalizacji").arg(cluster.count);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> ClusterModel::roleNames() const {
+    return {{LatitudeRole, "latitude"}, {LongitudeRole, "longitude"}, {CountRole, "count"},
+            {LevelRole, "level"}, {LabelRole, "label"}};
+}
+
+StationMapWindow::StationMapWindow(const QString &tileServer, const QString &tileDirectory, QWidget *parent)
+    : QWidget(parent, Qt::Window),
+    model(new ClusterModel(this)),
+    view(new QQuickWidget(this)) {
+
+    view->setResizeMode(QQuickWidget::SizeRootObjectToView);
+    view->rootContext()->setContextProperty("clusterModel", model);
+    view->rootContext()->setContextProperty("tileServer", tileServer);
+    view->rootContext()->setContextProperty("tileDirectory", QDir::toNativeSeparators(tileDirectory));
+    view->setSource(QUrl("qrc:/stationmap.qml"));
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addWidget(view);
+
+    setWindowTitle("Mapa lokalizacji");
+    resize(900, 700);
+}
+
+void StationMapWindow::setStations(const QList<StationMarker> &stations) {
+    model->setStations(stations);
+}
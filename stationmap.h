@@ -0,0 +1,65 @@
+#ifndef STATIONMAP_H
+#define STATIONMAP_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QWidget>
+
+#include <vector>
+
+#include "markercluster.h"
+
+class QQuickWidget;
+
+struct StationMarker {
+    QString label;
+    GeoPoint position;
+    int level = -1;
+};
+
+/*!
+ * \brief Model klastrów znaczników widocznych na mapie
+ * \details Przy każdej zmianie przybliżenia lub widoku mapa wywołuje update(), a model zastępuje
+ * swoją zawartość klastrami z drzewa czwórkowego. Liczba elementów QML jest więc ograniczona
+ * liczbą klastrów mieszczących się na ekranie, niezależnie od liczby lokalizacji.
+ */
+class ClusterModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Roles { LatitudeRole = Qt::UserRole + 1, LongitudeRole, CountRole, LevelRole, LabelRole };
+
+    explicit ClusterModel(QObject *parent = nullptr) : QAbstractListModel(parent) {}
+
+    void setStations(const QList<StationMarker> &stations);
+    Q_INVOKABLE void update(double zoom, double north, double west, double south, double east);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+private:
+    QList<StationMarker> stations;
+    MarkerQuadtree tree;
+    std::vector<MarkerCluster> visible;
+    double lastView[5] = {-1.0, 0.0, 0.0, 0.0, 0.0};
+};
+
+/*!
+ * \brief Okno mapy monitorowanych lokalizacji (Qt Location) z grupowaniem znaczników
+ * \details Kafelki pobierane są wyłącznie z lokalnego źródła: katalogu z kafelkami zapisanymi
+ * w formacie pamięci podręcznej wtyczki "osm" (osm_100-l-8-<z>-<x>-<y>.png) lub lokalnego serwera
+ * kafelków, więc mapa działa bez dostępu do Internetu.
+ */
+class StationMapWindow : public QWidget {
+public:
+    StationMapWindow(const QString &tileServer, const QString &tileDirectory, QWidget *parent = nullptr);
+
+    void setStations(const QList<StationMarker> &stations);
+
+private:
+    ClusterModel *model;
+    QQuickWidget *view;
+};
+
+#endif // STATIONMAP_H
@@ -0,0 +1,116 @@
+import QtQuick
+import QtLocation
+import QtPositioning
+
+Item {
+    // Kolory klas Europejskiego Indeksu Jakości Powietrza; szary - brak danych
+    readonly property var levelColors: ["#50f0e6", "#50ccaa", "#f0e641", "#ff5050", "#960032", "#7d2181"]
+
+    Plugin {
+        id: tilePlugin
+        name: "osm"
+        PluginParameter { name: "osm.mapping.providersrepository.disabled"; value: true }
+        PluginParameter { name: "osm.mapping.custom.host"; value: tileServer }
+        PluginParameter { name: "osm.mapping.offline.directory"; value: tileDirectory }
+    }
+
+    Map {
+        id: map
+        anchors.fill: parent
+        plugin: tilePlugin
+        center: QtPositioning.coordinate(52.0, 19.0)
+        zoomLevel: 6
+
+        Component.onCompleted: {
+            for (let i = 0; i < supportedMapTypes.length; ++i)
+                if (supportedMapTypes[i].style === MapType.CustomMap)
+                    activeMapType = supportedMapTypes[i]
+            refresh.restart()
+        }
+        onZoomLevelChanged: refresh.restart()
+        onCenterChanged: refresh.restart()
+        onWidthChanged: refresh.restart()
+        onHeightChanged: refresh.restart()
+
+        WheelHandler {
+            acceptedDevices: PointerDevice.Mouse | PointerDevice.TouchPad
+            rotationScale: 1 / 120
+            property: "zoomLevel"
+        }
+        DragHandler {
+            target: null
+            onTranslationChanged: (delta) => map.pan(-delta.x, -delta.y)
+        }
+        PinchHandler {
+            target: null
+            onScaleChanged: (delta) => map.zoomLevel += Math.log2(delta)
+        }
+
+        MapItemView {
+            model: clusterModel
+            delegate: MapQuickItem {
+                required property double latitude
+                required property double longitude
+                required property int count
+                required property int level
+                required property string label
+
+                coordinate: QtPositioning.coordinate(latitude, longitude)
+                anchorPoint.x: marker.width / 2
+                anchorPoint.y: marker.height / 2
+                sourceItem: Rectangle {
+                    id: marker
+                    width: count > 1 ? 20 + 4 * Math.log(count) : 12
+                    height: width
+                    radius: width / 2
+                    color: level >= 0 ? levelColors[level] : "#a0a0a0"
+                    border.color: "white"
+                    border.width: 1.5
+
+                    Text {
+                        anchors.centerIn: parent
+                        visible: count > 1
+                        text: count
+                        font.pixelSize: 11
+                        font.bold: true
+                    }
+                    TapHandler {
+                        onTapped: {
+                            if (count > 1)
+                                map.zoomLevel = Math.min(map.zoomLevel + 2, map.maximumZoomLevel)
+                            map.center = QtPositioning.coordinate(latitude, longitude)
+                            selection.text = label
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Przeliczenie klastrów po zakończeniu przesuwania lub przybliżania
+    Timer {
+        id: refresh
+        interval: 50
+        onTriggered: {
+            const region = map.visibleRegion.boundingGeoRectangle()
+            clusterModel.update(map.zoomLevel, region.topLeft.latitude, region.topLeft.longitude,
+                                region.bottomRight.latitude, region.bottomRight.longitude)
+        }
+    }
+
+    Rectangle {
+        anchors.left: parent.left
+        anchors.top: parent.top
+        anchors.margins: 8
+        width: selection.implicitWidth + 16
+        height: selection.implicitHeight + 8
+        visible: selection.text.length > 0
+        color: "#e0ffffff"
+        radius: 4
+
+        Text {
+            id: selection
+            anchors.centerIn: parent
+        }
+    }
+}
@@ -0,0 +1,182 @@
+#include "statstable.h"
+
+#include <QBrush>
+
+#include <algorithm>
+#include <cmath>
+
+bool computeStatsRow(const AirQualityFrame &frame, const DenseFrame &dense, const std::string &param, StatsRow &row,
+                     Histogram *histogram, ExceedanceTracker *tracker) {
+    auto column = frame.columns.find(param);
+    auto denseColumn = dense.columns.find(param);
+    if (column == frame.columns.end() || column->second.empty() || denseColumn == dense.columns.end()) return false;
+    const std::vector<double> &values = column->second;
+
+    // Kwantyle z histogramu logarytmicznego (stała dokładność względna), wypełnianego razem z histogramem wykresu
+    Histogram quantiles = parameterHistogram(param, HistogramScale::Log);
+    std::vector<Histogram *> histograms;
+    if (quantiles.bins()) histograms.push_back(&quantiles);
+    if (histogram && histogram->bins()) histograms.push_back(histogram);
+    const MaskedSummary summary = maskedSummary(denseColumn->second, histograms);
+    if (summary.count == 0) return false;
+
+    row.samples = summary.count;
+    row.min = summary.min;
+    row.max = summary.max;
+    row.mean = summary.mean;
+    row.median = quantiles.quantile(0.5);
+    row.p90 = quantiles.quantile(0.9);
+    row.overLimit = std::isnan(row.limit) ? 0 : maskedCountAbove(denseColumn->second, row.limit);
+    row.gaps = analyzeGaps(denseColumn->second);
+    row.step = denseColumn->second.step;
+
+    if (!std::isnan(row.guideline)) {
+        ExceedanceTracker local(row.guideline, std::max<std::int64_t>(3600, smallestStep(frame)), row.guidelineWindow);
+        ExceedanceTracker &used = tracker ? *tracker : local;
+        used.update(frame, param);
+        row.episodes = used.episodes();
+        row.exceedingSamples = used.exceedingSamples();
+    }
+    row.trend = estimateTrend(frame.time, values);
+    return true;
+}
+
+StatsTableModel::StatsTableModel(QObject *parent) : QAbstractTableModel(parent) {}
+
+int StatsTableModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+int StatsTableModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant StatsTableModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= static_cast<int>(rows.size())) return QVariant();
+    const StatsRow &row = rows[static_cast<size_t>(index.row())];
+    const int column = index.column();
+
+    if (role == Qt::DisplayRole || role == Qt::UserRole) {
+        const bool sortValue = role == Qt::UserRole;
+        auto number = [sortValue](double value, int decimals) -> QVariant {
+            if (std::isnan(value)) return sortValue ? QVariant(-std::numeric_limits<double>::infinity()) : QVariant();
+            return sortValue ? QVariant(value) : QVariant(QString::number(value, 'f', decimals));
+        };
+        switch (column) {
+        case Location: return row.location;
+        case Parameter: return row.title;
+        case Samples: return static_cast<qulonglong>(row.samples);
+        case Min: return number(row.min, 1);
+        case Max: return number(row.max, 1);
+        case Mean: return number(row.mean, 1);
+        case Median: return number(row.median, 1);
+        case P90: return number(row.p90, 1);
+        case OverLimit:
+            if (std::isnan(row.limit)) return sortValue ? QVariant(-1) : QVariant();
+            return static_cast<qulonglong>(row.overLimit);
+        case Coverage: return number(100.0 * row.gaps.coverage(), 1);
+        case Episodes:
+            if (std::isnan(row.guideline)) return sortValue ? QVariant(-1) : QVariant();
+            return static_cast<qulonglong>(row.episodes.size());
+        case Trend: return number(row.trend.slopePerYear, 2);
+        }
+        return QVariant();
+    }
+    if (role == Qt::TextAlignmentRole && column >= Samples)
+        return QVariant::fromValue(Qt::AlignRight | Qt::AlignVCenter);
+    if (role == Qt::ForegroundRole) {
+        if (column == OverLimit && row.overLimit > 0) return QBrush(Qt::red);
+        if (column == Episodes && !row.episodes.empty()) return QBrush(Qt::red);
+        if (column == Trend && row.trend.valid() && row.trend.significant())
+            return QBrush(row.trend.slopePerYear > 0 ? Qt::red : Qt::darkGreen);
+    }
+    if (role == Qt::ToolTipRole) return details(row);
+    return QVariant();
+}
+
+QVariant StatsTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QAbstractTableModel::headerData(section, orientation, role);
+    static const char *const headers[ColumnCount] = {"Lokalizacja", "Parametr", "Pomiary", "Min", "Max", "Średnia",
+                                                      "Mediana", "P90", "Powyżej normy", "Pokrycie [%]",
+                                                      "Epizody WHO", "Trend / rok"};
+    return section >= 0 && section < ColumnCount ? QString::fromUtf8(headers[section]) : QVariant();
+}
+
+QString StatsTableModel::details(const StatsRow &row) const {
+    QStringList lines{row.title + " - " + row.location};
+    if (!std::isnan(row.limit)) lines << QString("Pomiary powyżej normy (%1): %2").arg(row.limit).arg(row.overLimit);
+    if (row.gaps.gaps > 0)
+        lines << QString("Braki: %1 z %2 pomiarów w %3 lukach, najdłuższa %4 h")
+                     .arg(row.gaps.missing())
+                     .arg(row.gaps.rows)
+                     .arg(row.gaps.gaps)
+                     .arg(row.gaps.longestGap * row.step / 3600.0, 0, 'f', 1);
+    if (!row.episodes.empty())
+        lines << QString("Średnia %1 h powyżej wytycznej WHO (%2): %3 pomiarów w %4 epizodach")
+                     .arg(row.guidelineWindow / 3600).arg(row.guideline).arg(row.exceedingSamples).arg(row.episodes.size());
+    if (row.trend.valid())
+        lines << QString("Trend (Theil-Sen, %1 dni): %2 / rok [%3; %4], p = %5%6")
+                     .arg(row.trend.days)
+                     .arg(row.trend.slopePerYear, 0, 'f', 2)
+                     .arg(row.trend.lowerPerYear, 0, 'f', 2)
+                     .arg(row.trend.upperPerYear, 0, 'f', 2)
+                     .arg(row.trend.pValue, 0, 'g', 2)
+                     .arg(row.trend.significant() ? " (istotny)" : "");
+    return lines.join('\n');
+}
+
+const StatsRow *StatsTableModel::find(const QString &location, const QString &parameter) const {
+    auto it = index.constFind(location + '\n' + parameter);
+    return it == index.constEnd() ? nullptr : &rows[static_cast<size_t>(*it)];
+}
+
+void StatsTableModel::upsert(std::vector<StatsRow> updates) {
+    std::vector<int> changed;
+    std::vector<StatsRow> added;
+    QHash<QString, size_t> addedIndex;
+    for (StatsRow &row : updates) {
+        const QString key = keyOf(row);
+        auto existing = index.constFind(key);
+        if (existing != index.constEnd()) {
+            rows[static_cast<size_t>(*existing)] = std::move(row);
+            changed.push_back(*existing);
+        } else if (auto repeated = addedIndex.constFind(key); repeated != addedIndex.constEnd()) {
+            added[*repeated] = std::move(row);
+        } else {
+            addedIndex.insert(key, added.size());
+            added.push_back(std::move(row));
+        }
+    }
+
+    // Jeden sygnał na ciągły zakres zmienionych wierszy
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    for (size_t i = 0; i < changed.size();) {
+        size_t j = i;
+        while (j + 1 < changed.size() && changed[j + 1] == changed[j] + 1) ++j;
+        emit dataChanged(createIndex(changed[i], 0), createIndex(changed[j], ColumnCount - 1));
+        i = j + 1;
+    }
+
+    if (added.empty()) return;
+    const int first = static_cast<int>(rows.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(added.size()) - 1);
+    for (StatsRow &row : added) {
+        index.insert(keyOf(row), static_cast<int>(rows.size()));
+        rows.push_back(std::move(row));
+    }
+    endInsertRows();
+}
+
+void StatsFilterModel::setLocation(const QString &newLocation) {
+    if (location == newLocation) return;
+    location = newLocation;
+    invalidateFilter();
+}
+
+bool StatsFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    if (!location.isEmpty()
+        && sourceModel()->index(sourceRow, StatsTableModel::Location, sourceParent).data().toString() != location)
+        return false;
+    return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+}
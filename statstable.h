@@ -0,0 +1,102 @@
+#ifndef STATSTABLE_H
+#define STATSTABLE_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSortFilterProxyModel>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "airqualityframe.h"
+#include "exceedance.h"
+#include "gaps.h"
+#include "histogram.h"
+#include "pollutants.h"
+#include "trend.h"
+
+// Statystyki jednego parametru jednej lokalizacji (wiersz tabeli statystyk)
+struct StatsRow {
+    // Opis wiersza - wypełniany przez wywołującego
+    QString location;
+    QString parameter;      // nazwa kolumny serii (klucz wiersza razem z lokalizacją)
+    QString title;          // nazwa wyświetlana z jednostką
+    double limit = NoLimit;
+    double guideline = NoLimit;
+    std::int64_t guidelineWindow = 0;   // okres uśredniania wytycznej [s], 0 - pojedyncze pomiary
+
+    // Wyniki
+    size_t samples = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double median = std::numeric_limits<double>::quiet_NaN();
+    double p90 = std::numeric_limits<double>::quiet_NaN();
+    size_t overLimit = 0;
+    GapStats gaps;
+    std::int64_t step = 0;
+    std::vector<ExceedanceEpisode> episodes;
+    size_t exceedingSamples = 0;
+    TrendResult trend;
+};
+
+// Obliczenie statystyk kolumny param z pełnej serii frame (dense - ta sama seria na siatce z mapą
+// pomiarów): podsumowanie, kwantyle i opcjonalny histogram wykresu w jednym przebiegu, luki, epizody
+// powyżej wytycznej liczone ze średniej kroczącej z okresu wytycznej (tracker - śledzenie przyrostowe;
+// bez niego pełny skan) i trend. false, gdy brak pomiarów.
+bool computeStatsRow(const AirQualityFrame &frame, const DenseFrame &dense, const std::string &param, StatsRow &row,
+                     Histogram *histogram = nullptr, ExceedanceTracker *tracker = nullptr);
+
+/*!
+ * \brief Model tabeli statystyk wszystkich lokalizacji i parametrów
+ * \details Wiersze identyfikowane są parą (lokalizacja, parametr). upsert() zastępuje istniejące
+ * wiersze i dopisuje nowe naraz: zmiany zgłaszane są jednym sygnałem dataChanged na każdy ciągły
+ * zakres zmienionych wierszy, a nowe wiersze jednym beginInsertRows. Rola Qt::UserRole zwraca
+ * wartość liczbową kolumny do sortowania.
+ */
+class StatsTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column { Location, Parameter, Samples, Min, Max, Mean, Median, P90, OverLimit, Coverage, Episodes, Trend, ColumnCount };
+
+    explicit StatsTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void upsert(std::vector<StatsRow> updates);
+    // Wiersz pary (lokalizacja, parametr) albo nullptr; wskaźnik ważny do następnego upsert()
+    const StatsRow *find(const QString &location, const QString &parameter) const;
+
+private:
+    static QString keyOf(const StatsRow &row) { return row.location + '\n' + row.parameter; }
+    QString details(const StatsRow &row) const;
+
+    std::vector<StatsRow> rows;
+    QHash<QString, int> index;
+};
+
+/*!
+ * \brief Filtr tabeli statystyk: tekst w dowolnej kolumnie i opcjonalnie jedna lokalizacja
+ */
+class StatsFilterModel : public QSortFilterProxyModel {
+    Q_OBJECT
+
+public:
+    using QSortFilterProxyModel::QSortFilterProxyModel;
+
+    // Pusta nazwa - wszystkie lokalizacje
+    void setLocation(const QString &location);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString location;
+};
+
+#endif // STATSTABLE_H
@@ -0,0 +1,58 @@
+// Test reguł powiadomień: pierwsze odpytanie nie odtwarza zdarzeń zakończonych epizodów z historii
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+
+#include "alertengine.h"
+
+namespace {
+
+// Seria godzinowa pm10 z wartościami kolejnych godzin od `start`
+void append(AirQualityFrame &frame, std::int64_t start, std::initializer_list<double> values) {
+    std::int64_t time = start;
+    for (double value : values) {
+        frame.time.push_back(time);
+        frame.columns["pm10"].push_back(value);
+        time += 3600;
+    }
+}
+
+int expectEvents(const char *name, const std::vector<AlertEvent> &events, size_t count, bool raised) {
+    if (events.size() == count && (count == 0 || events.back().raised == raised)) return 0;
+    std::fprintf(stderr, "%s: %zu zdarzeń, oczekiwano %zu\n", name, events.size(), count);
+    return 1;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+    AirQualityFrame frame;
+    frame.location = "Kraków";
+    // Historia z zakończonym epizodem przekroczenia (godziny 2-5)
+    append(frame, 0, {20, 30, 60, 70, 80, 65, 30, 20, 25, 30});
+
+    AlertEngine engine;
+    engine.addRule(AlertRule::parse("pm10 > 50 for 2h clear 40"));
+    failures += expectEvents("pierwsze odpytanie", engine.process(frame, frame.time.back()), 0, false);
+    if (engine.activeCount() != 0) {
+        std::fprintf(stderr, "pierwsze odpytanie: aktywny alarm po zakończonym epizodzie\n");
+        ++failures;
+    }
+
+    // Nowy epizod po pierwszym odpytaniu jest zgłaszany, a kolejne odpytanie bez zmian nic nie zgłasza
+    append(frame, 10 * 3600, {55, 60});
+    failures += expectEvents("nowy epizod", engine.process(frame, frame.time.back()), 1, true);
+    failures += expectEvents("bez nowych wierszy", engine.process(frame, frame.time.back()), 0, false);
+    append(frame, 12 * 3600, {30});
+    failures += expectEvents("koniec epizodu", engine.process(frame, frame.time.back()), 1, false);
+
+    // Epizod trwający na końcu historii zgłaszany jest przy pierwszym odpytaniu jednym zdarzeniem
+    AirQualityFrame ongoing;
+    ongoing.location = "Gdańsk";
+    append(ongoing, 0, {60, 70, 20, 20, 70, 80, 90});
+    AlertEngine fresh;
+    fresh.addRule(AlertRule::parse("pm10 > 50 for 2h"));
+    failures += expectEvents("trwający epizod", fresh.process(ongoing, ongoing.time.back()), 1, true);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+// Test kalkulatora serii pochodnych: wykonanie blokowe porównywane z obliczeniem skalarnym
+#include <algorithm>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "expression.h"
+
+namespace {
+
+struct Case {
+    const char *text;
+    std::function<double(double, double, double, double)> reference;
+};
+
+// Wyrażenia łączące operacje jedno- i dwuargumentowe (kontrola przydziału rejestrów) oraz stałe ułamkowe
+const Case cases[] = {
+    {"abs(a - b) + (c + d)", [](double a, double b, double c, double d) { return std::fabs(a - b) + (c + d); }},
+    {"-(a + b) * (c + d)", [](double a, double b, double c, double d) { return -(a + b) * (c + d); }},
+    {"sqrt(abs(a - c)) * -(b - d) + max(a, b) / (c + 1)",
+     [](double a, double b, double c, double d) { return std::sqrt(std::fabs(a - c)) * -(b - d) + std::max(a, b) / (c + 1); }},
+    {"min(-a, -(b + c)) - abs(d - a) * (a + b)",
+     [](double a, double b, double c, double d) { return std::min(-a, -(b + c)) - std::fabs(d - a) * (a + b); }},
+    {"-(-(a * b) + c) / (d + 2)", [](double a, double b, double c, double d) { return -(-(a * b) + c) / (d + 2); }},
+    {"(a + b) * (c + d) - (a - b) * (c - d)",
+     [](double a, double b, double c, double d) { return (a + b) * (c + d) - (a - b) * (c - d); }},
+    {"a * 0.5 + .25 * b - 1.5e-1 * c", [](double a, double b, double c, double) { return a * 0.5 + .25 * b - 1.5e-1 * c; }},
+};
+
+// Liczba niezgodnych wyrażeń; pierwsza niezgodność każdego wypisywana na stderr
+int checkCases(const AirQualityFrame &frame) {
+    const std::vector<double> &a = frame.columns.at("a"), &b = frame.columns.at("b");
+    const std::vector<double> &c = frame.columns.at("c"), &d = frame.columns.at("d");
+    int failures = 0;
+    for (const Case &test : cases) {
+        const std::vector<double> values = ExpressionPlan::compile(test.text).evaluate(frame);
+        for (size_t i = 0; i < frame.time.size(); ++i) {
+            const double expected = test.reference(a[i], b[i], c[i], d[i]);
+            const bool same = std::isnan(expected) ? std::isnan(values[i])
+                                                   : std::fabs(values[i] - expected) <= 1e-12 * std::max(1.0, std::fabs(expected));
+            if (!same) {
+                std::fprintf(stderr, "%s: wiersz %zu, wynik %g, oczekiwano %g\n", test.text, i, values[i], expected);
+                ++failures;
+                break;
+            }
+        }
+    }
+    return failures;
+}
+
+} // namespace
+
+int main() {
+    // Kilka bloków wierszy, z lukami w kolumnie a
+    AirQualityFrame frame;
+    const size_t rows = 3 * 1024 + 17;
+    std::vector<double> &a = frame.columns["a"], &b = frame.columns["b"], &c = frame.columns["c"], &d = frame.columns["d"];
+    for (size_t i = 0; i < rows; ++i) {
+        frame.time.push_back(static_cast<std::int64_t>(i) * 3600);
+        a.push_back(i % 97 == 0 ? std::numeric_limits<double>::quiet_NaN() : 10.0 + i % 7);
+        b.push_back(3.0 + (i % 5) * 0.5);
+        c.push_back(1.0 + i % 3);
+        d.push_back(2.0 + (i % 11) * 0.25);
+    }
+
+    int failures = checkCases(frame);
+
+    // Aplikacja Qt ustawia locale systemu (np. pl_PL z przecinkiem dziesiętnym) - wynik nie może od niego zależeć
+    for (const char *name : {"pl_PL.UTF-8", "de_DE.UTF-8"}) {
+        if (!std::setlocale(LC_ALL, name)) continue;
+        failures += checkCases(frame);
+    }
+    std::setlocale(LC_ALL, "C");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+// Test progu agregacji wykresu: świeżo pobrana seria 15-minutowa ma być wykreślana bez agregacji
+#include <cstdint>
+#include <cstdio>
+
+#include "airqualityframe.h"
+#include "framejoin.h"
+
+namespace {
+
+// Zakres jednego zapytania: HistoryDays + ForecastDays z openmeteo.h (7 + 3 dni)
+constexpr std::int64_t FetchDays = 7 + 3;
+
+AirQualityFrame series(std::int64_t days, std::int64_t step, const char *column) {
+    AirQualityFrame frame;
+    frame.location = "test";
+    for (std::int64_t t = 0; t < days * 86400; t += step) {
+        frame.time.push_back(t);
+        frame.columns[column].push_back(static_cast<double>(t % 7200) / 60.0);
+    }
+    return frame;
+}
+
+} // namespace
+
+int main() {
+    int failures = 0;
+
+    // Godzinowa jakość powietrza złączona z pogodą 15-minutową, jak po odpowiedzi obu API
+    const AirQualityFrame airQuality = series(FetchDays, 3600, "pm10");
+    const AirQualityFrame weather = series(FetchDays, 900, "temperature_2m");
+    const AirQualityFrame fetched = joinFrames({{&airQuality, ""}, {&weather, "weather_"}});
+    if (smallestStep(fetched) != 900 || needsHourlyRollup(fetched)) {
+        std::fprintf(stderr, "świeże pobranie (%zu wierszy) agregowane do godzin\n", fetched.size());
+        ++failures;
+    }
+
+    // Seria 15-minutowa dłuższa od limitu (zapisana historia wielu pobrań) ma być agregowana
+    const AirQualityFrame stored = series(30, 900, "temperature_2m");
+    if (!needsHourlyRollup(stored)) {
+        std::fprintf(stderr, "seria %zu wierszy 15-minutowych bez agregacji\n", stored.size());
+        ++failures;
+    }
+
+    // Seria godzinowa nigdy nie jest agregowana, niezależnie od długości
+    if (needsHourlyRollup(series(365, 3600, "pm10"))) {
+        std::fprintf(stderr, "seria godzinowa agregowana\n");
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "trend.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double DaysPerYear = 365.25;
+const double Z95 = 1.959963984540054;
+const double SlopeTolerance = 1e-7;
+
+// Liczba par i < j z a[i] > a[j] (withTies = false) lub a[i] >= a[j] (withTies = true);
+// sortuje a przy użyciu bufora scratch
+std::int64_t countInversions(std::vector<double> &a, std::vector<double> &scratch, bool withTies) {
+    const size_t n = a.size();
+    scratch.resize(n);
+    std::int64_t inversions = 0;
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t left = 0; left < n; left += 2 * width) {
+            const size_t mid = std::min(left + width, n), right = std::min(left + 2 * width, n);
+            size_t i = left, j = mid, out = left;
+            while (i < mid && j < right) {
+                // Element z prawej połowy wyprzedza wszystkie pozostałe elementy lewej, które są od niego większe
+                const bool takeRight = withTies ? a[j] <= a[i] : a[j] < a[i];
+                if (takeRight) {
+                    inversions += static_cast<std::int64_t>(mid - i);
+                    scratch[out++] = a[j++];
+                } else {
+                    scratch[out++] = a[i++];
+                }
+            }
+            while (i < mid) scratch[out++] = a[i++];
+            while (j < right) scratch[out++] = a[j++];
+        }
+        a.swap(scratch);
+    }
+    return inversions;
+}
+
+// Liczba par punktów (x rosnąco) o nachyleniu nie większym niż slope
+std::int64_t slopesAtMost(const std::vector<double> &x, const std::vector<double> &y, double slope,
+                          std::vector<double> &work, std::vector<double> &scratch) {
+    work.resize(x.size());
+    for (size_t i = 0; i < x.size(); ++i) work[i] = y[i] - slope * x[i];
+    return countInversions(work, scratch, true);
+}
+
+// Nachylenia o podanych rangach (od 1, rosnąco) spośród wszystkich par. Bisekcja jest wspólna dla
+// rang, dopóki leżą w tym samym przedziale; kończy się przy szerokości przedziału poniżej
+// SlopeTolerance zakresu nachyleń (wynik to środek przedziału)
+void kthSlopes(const std::vector<double> &x, const std::vector<double> &y, double lo, double hi,
+               const std::int64_t *ranks, double *out, size_t count, double tolerance,
+               std::vector<double> &work, std::vector<double> &scratch) {
+    if (count == 0) return;
+    const double mid = lo + (hi - lo) / 2.0;
+    if (hi - lo <= tolerance || mid <= lo || mid >= hi) {
+        std::fill(out, out + count, mid);
+        return;
+    }
+    const std::int64_t atMost = slopesAtMost(x, y, mid, work, scratch);
+    const size_t left = std::upper_bound(ranks, ranks + count, atMost) - ranks;
+    kthSlopes(x, y, lo, mid, ranks, out, left, tolerance, work, scratch);
+    kthSlopes(x, y, mid, hi, ranks + left, out + left, count - left, tolerance, work, scratch);
+}
+
+} // namespace
+
+TrendResult estimateTrend(const std::vector<std::int64_t> &time, const std::vector<double> &values) {
+    TrendResult result;
+
+    // Średnie dobowe; oś czasu jest posortowana, więc wiersze jednej doby leżą obok siebie
+    std::vector<double> x, y;
+    const size_t rows = std::min(time.size(), values.size());
+    for (size_t i = 0; i < rows;) {
+        const std::int64_t day = (time[i] >= 0 ? time[i] : time[i] - 86399) / 86400;
+        double sum = 0.0;
+        size_t count = 0;
+        for (; i < rows && (time[i] >= 0 ? time[i] : time[i] - 86399) / 86400 == day; ++i) {
+            if (std::isnan(values[i])) continue;
+            sum += values[i];
+            ++count;
+        }
+        if (count == 0) continue;
+        x.push_back(static_cast<double>(day));
+        y.push_back(sum / count);
+    }
+
+    const size_t n = x.size();
+    result.days = n;
+    if (n < MinTrendDays) return result;
+
+    // Mann-Kendall: S = P - Q, gdzie Q to inwersje, a P = N - Q - pary równych wartości
+    const std::int64_t pairs = static_cast<std::int64_t>(n) * (n - 1) / 2;
+    std::vector<double> sorted = y, scratch;
+    const std::int64_t discordant = countInversions(sorted, scratch, false);
+    std::int64_t tiedPairs = 0;
+    double tieCorrection = 0.0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && sorted[j] == sorted[i]) ++j;
+        const double t = static_cast<double>(j - i);
+        tiedPairs += static_cast<std::int64_t>((j - i) * (j - i - 1) / 2);
+        tieCorrection += t * (t - 1) * (2 * t + 5);
+        i = j;
+    }
+    const double s = static_cast<double>(pairs - tiedPairs - 2 * discordant);
+    const double nd = static_cast<double>(n);
+    const double variance = (nd * (nd - 1) * (2 * nd + 5) - tieCorrection) / 18.0;
+    result.kendallZ = variance > 0 ? (s - (s > 0) + (s < 0)) / std::sqrt(variance) : 0.0;
+    result.pValue = std::erfc(std::abs(result.kendallZ) / std::sqrt(2.0));
+
+    // Theil-Sen: mediana nachyleń par, przedział ufności z rang (N -/+ C) / 2. Najmniejsze i największe
+    // nachylenie par występuje zawsze między sąsiednimi punktami, więc wyznacza przedział poszukiwań
+    double lo = std::numeric_limits<double>::infinity(), hi = -lo;
+    for (size_t i = 1; i < n; ++i) {
+        const double slope = (y[i] - y[i - 1]) / (x[i] - x[i - 1]);
+        lo = std::min(lo, slope);
+        hi = std::max(hi, slope);
+    }
+    const double c = Z95 * std::sqrt(variance);
+    const std::int64_t ranks[4] = {
+        std::clamp<std::int64_t>(static_cast<std::int64_t>(std::floor((pairs - c) / 2.0)), 1, pairs),
+        (pairs + 1) / 2,
+        pairs / 2 + 1,
+        std::clamp<std::int64_t>(static_cast<std::int64_t>(std::ceil((pairs + c) / 2.0)) + 1, 1, pairs)
+    };
+    double slopes[4];
+    std::vector<double> work;
+    // Przedział (lo - margines, hi]: nachylenie lo też musi się w nim znaleźć
+    const double tolerance = SlopeTolerance * std::max(hi - lo, 1e-12);
+    kthSlopes(x, y, lo - tolerance, hi, ranks, slopes, 4, tolerance, work, scratch);
+    result.lowerPerYear = slopes[0] * DaysPerYear;
+    result.slopePerYear = (slopes[1] + slopes[2]) / 2.0 * DaysPerYear;
+    result.upperPerYear = slopes[3] * DaysPerYear;
+    return result;
+}
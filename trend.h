@@ -0,0 +1,37 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Wynik oszacowania trendu; przy zbyt krótkiej serii (mniej niż MinTrendDays dni) wartości to NaN
+struct TrendResult {
+    double slopePerYear = std::numeric_limits<double>::quiet_NaN();
+    double lowerPerYear = std::numeric_limits<double>::quiet_NaN();   // 95% przedział ufności
+    double upperPerYear = std::numeric_limits<double>::quiet_NaN();
+    double kendallZ = std::numeric_limits<double>::quiet_NaN();
+    double pValue = std::numeric_limits<double>::quiet_NaN();
+    size_t days = 0;
+
+    bool valid() const { return slopePerYear == slopePerYear; }
+    bool significant() const { return pValue < 0.05; }
+};
+
+inline constexpr size_t MinTrendDays = 10;
+
+/*!
+ * \brief Trend serii: nachylenie Theila-Sena z przedziałem ufności i test Manna-Kendalla
+ * \details Seria agregowana jest najpierw do średnich dobowych (UTC). Statystyka S Manna-Kendalla
+ * liczona jest przez zliczanie inwersji sortowaniem przez scalanie (O(n log n)), z poprawką
+ * wariancji na wartości powtórzone. Mediana nachyleń wszystkich par wyznaczana jest bez ich
+ * wyliczania: liczba par o nachyleniu nie większym niż s to liczba inwersji ciągu y - s*x, więc
+ * k-te nachylenie znajdowane jest bisekcją (do 1e-7 szerokości zakresu) w przedziale nachyleń sąsiednich punktów (zawsze
+ * zawierającym wszystkie nachylenia par). Przedział ufności to nachylenia o rangach (N -/+ C)/2
+ * (Gilbert 1987). Test zakłada niezależność średnich dobowych - przy silnej autokorelacji lub
+ * sezonowości wartość p jest zaniżona.
+ */
+TrendResult estimateTrend(const std::vector<std::int64_t> &time, const std::vector<double> &values);
+
+#endif // TREND_H